@@ -0,0 +1,90 @@
+/*!
+ * @file CAlgebraicMultigrid.hpp
+ * @brief Headers of the main subroutines for the algebraic multigrid method.
+ *        The implementation is in the <i>CAlgebraicMultigrid.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CALGEBRAICMULTIGRID_HPP
+#define __CALGEBRAICMULTIGRID_HPP
+
+#include <string>
+#include <vector>
+
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+#include "CMultigrid.hpp"
+
+/*!
+ * @class CAlgebraicMultigrid
+ * @brief Smoothed aggregation algebraic multigrid. The hierarchy is built from
+ *        the matrix alone: strongly coupled DOF are grouped in aggregates, the
+ *        piecewise constant prolongation is smoothed with damped Jacobi and the
+ *        coarse matrices are the Galerkin products P'*A*P. The setup is done
+ *        once in the constructor and reused by every apply or solve of the
+ *        object, but it is not kept by CFactorCache, so every CHeatConduction
+ *        builds its own hierarchy.
+ */
+class CAlgebraicMultigrid : public CMultigrid {
+    private:
+        double strength;            /*!< @brief Threshold of strong coupling, relative to the diagonal.*/
+        unsigned maxCoarseSize;     /*!< @brief Size of the coarsest level solved directly.*/
+
+        /*!
+         * @brief Group the DOF in aggregates of strongly coupled neighbours.
+         * @param[in] A - Matrix of the level.
+         * @param[out] nAggregates - Number of aggregates.
+         * @return Aggregate of every DOF.
+         */
+        std::vector<unsigned> aggregate(const CMatrixSparse& A,
+                                        unsigned& nAggregates);
+
+        /*!
+         * @brief Smoothed prolongation, P = (I - w*inv(D)*A)*T, where T is the
+         *        piecewise constant prolongation of the aggregates.
+         * @param[in] A - Matrix of the level.
+         * @param[in] agg - Aggregate of every DOF.
+         * @param[in] nAggregates - Number of aggregates.
+         * @return Prolongation matrix.
+         */
+        CMatrixSparse smoothedProlongation(const CMatrixSparse& A,
+                                           const std::vector<unsigned>& agg,
+                                           const unsigned nAggregates);
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] A - LHS matrix of the system.
+         * @param[in] cycleType - Cycle of the method, V or W.
+         */
+        CAlgebraicMultigrid(const CMatrixSparseSymmetric& A,
+                            const std::string cycleType = "V");
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CAlgebraicMultigrid();
+};
+
+#endif
@@ -30,10 +30,13 @@
 #define __CBOUNDARYCONDITIONS_HPP
 
 #include <string>
+#include <vector>
 
 #include "CMatrix.hpp"
+#include "CMatrixIndex.hpp"
 #include "CMesh.hpp"
 #include "CGeometry.hpp"
+#include "CShapeFunctions.hpp"
 
 /*!
  * @class CBoundaryConditions
@@ -44,17 +47,18 @@ class CBoundaryConditions {
         unsigned gaussOrder;        /*!< @brief Number of Gauss points.*/
         CMatrix gaussPoints;        /*!< @brief Location of Gauss points.*/
         CMatrix gaussWeights;       /*!< @brief Gauss point weights.*/
+        const CShapeFunctions* shape;   /*!< @brief Shape functions tabulated at the Gauss points.*/
         std::string fluxBCLoc;      /*!< @brief Location of flux boundary conditions.*/
         std::string tempBCLoc;      /*!< @brief Location of temperature boundary conditions.*/
         double fluxValue;           /*!< @brief Value of flux boundary conditions.*/
         double tempValue;           /*!< @brief Value of temperature boundary conditions.*/
-        CMatrix fluxNodes;          /*!< @brief Nodes where flux BC are specified.*/
-        CMatrix tempNodes;          /*!< @brief Nodes where temperature BC are specified.*/
+        CMatrixIndex fluxNodes;     /*!< @brief Nodes where flux BC are specified.*/
+        CMatrixIndex tempNodes;     /*!< @brief Nodes where temperature BC are specified.*/
         unsigned nFluxNodes;        /*!< @brief Number of nodes where flux BC are specified.*/
         unsigned nTempNodes;        /*!< @brief Number of nodes where temperature BC are specified.*/
         CMatrix fluxBCVector;       /*!< @brief Flux vector with flux BC set.*/
         CMatrix tempBCVector;       /*!< @brief Temperature vector with temperature BC set.*/
-        CMatrix reducedDofVector;   /*!< @brief DOF where flux BC are specified.*/
+        CMatrixIndex reducedDofVector;  /*!< @brief DOF where flux BC are specified.*/
         unsigned nReducedDof;       /*!< @brief Number reduced DOF.*/
 
         /*!
@@ -65,6 +69,16 @@ class CBoundaryConditions {
          */
         CMatrix computeBCFlux(const CMesh& msh, const CGeometry& geo);
 
+        /*!
+         * @brief Integrate the flux along the edges of the elements at the
+         *        flux nodes and add it to the flux vector.
+         * @param[in] msh - Mesh.
+         * @param[in] geo - Geometry.
+         * @param[in,out] f - Flux BC vector.
+         */
+        template <unsigned M>
+        void edgeFlux(const CMesh& msh, const CGeometry& geo, CMatrix& f) const;
+
         /*!
          * @brief Calculate temperature BC vector.
          * @param[in] msh - Mesh.
@@ -86,10 +100,13 @@ class CBoundaryConditions {
          * @param[in] tpVal - Temperature BC value.
          * @param[in] msh - Mesh.
          * @param[in] geo - Geometry.
+         * @param[in] order - Gauss order, 0 to use the default one of the
+         *                    elements of the mesh.
          */
         CBoundaryConditions(const std::string flLoc, const double flVal,
                             const std::string tpLoc, const double tpVal,
-                            const CMesh& msh, const CGeometry& geo);
+                            const CMesh& msh, const CGeometry& geo,
+                            const unsigned order = 0);
 
         /*!
          * @brief Destructor of the class.
@@ -106,13 +123,13 @@ class CBoundaryConditions {
          * @brief Get Gauss points.
          * @return Gauss points.
          */
-        CMatrix getGaussPoints() const;
+        const CMatrix& getGaussPoints() const;
 
         /*!
          * @brief Get Gauss weights.
          * @return Gauss weights.
          */
-        CMatrix getGaussWeights() const;
+        const CMatrix& getGaussWeights() const;
 
         /*!
          * @brief Get flux BC location.
@@ -142,13 +159,13 @@ class CBoundaryConditions {
          * @brief Get flux BC nodes.
          * @return Flux BC nodes.
          */
-        CMatrix getFluxNodes() const;
+        const CMatrixIndex& getFluxNodes() const;
 
         /*!
          * @brief Get temperature BC nodes.
          * @return Temperature BC nodes.
          */
-        CMatrix getTempNodes() const;
+        const CMatrixIndex& getTempNodes() const;
 
         /*!
          * @brief Get number of flux BC nodes.
@@ -166,25 +183,31 @@ class CBoundaryConditions {
          * @brief Get flux BC vector.
          * @return Flux BC vector.
          */
-        CMatrix getFluxBCVector() const;
+        const CMatrix& getFluxBCVector() const;
 
         /*!
          * @brief Get temperature BC vector.
          * @return Temperature BC vector.
          */
-        CMatrix getTempBCVector() const;
+        const CMatrix& getTempBCVector() const;
 
         /*!
          * @brief Get reduced DOF vector.
          * @return Reduced DOF vector.
          */
-        CMatrix getReducedDofVector() const;
+        const CMatrixIndex& getReducedDofVector() const;
 
         /*!
          * @brief Get number of reduced DOF.
          * @return Number of reduced DOF.
          */
         unsigned getNReducedDof() const;
+
+        /*!
+         * @brief Get the mask of the DOF with known temperature.
+         * @return Boolean for every DOF, true where the temperature is known.
+         */
+        std::vector<bool> getDirichletMask() const;
 };
 
 #endif
@@ -51,6 +51,16 @@ class CCommandLine {
         double fluxValue;           /*!< @brief Flux BC value.*/
         std::string tempLocation;   /*!< @brief Temperature BC location.*/
         double tempValue;           /*!< @brief Temperature BC value.*/
+        std::string preconditioner; /*!< @brief Preconditioner of the CG method.*/
+        std::string solver;         /*!< @brief Solver of the linear system.*/
+        std::string mgCycle;        /*!< @brief Cycle of the multigrid method.*/
+        std::string cgMethod;       /*!< @brief Variant of the CG method.*/
+        unsigned sStep;             /*!< @brief Number of steps per block of the s-step CG method.*/
+        std::string sBasis;         /*!< @brief Basis of the s-step CG method.*/
+        std::string element;        /*!< @brief Type of element, q4, q8 or q9.*/
+        unsigned gaussOrder;        /*!< @brief Gauss order, 0 for the default of the element.*/
+        std::string cacheDir;       /*!< @brief Directory of the cache on disk, none if empty.*/
+        unsigned cacheSize;         /*!< @brief Maximum size of the cache in MiB.*/
         bool ableToRun;             /*!< @brief Boolean to control if program is able to run.*/
 
     public:
@@ -150,6 +160,72 @@ class CCommandLine {
          */
         double getTempValue() const;
 
+        /*!
+         * @brief Get preconditioner of the CG method.
+         * @return Preconditioner of the CG method.
+         */
+        std::string getPreconditioner() const;
+
+        /*!
+         * @brief Get solver of the linear system.
+         * @return Solver of the linear system.
+         */
+        std::string getSolver() const;
+
+        /*!
+         * @brief Get cycle of the multigrid method.
+         * @return Cycle of the multigrid method.
+         */
+        std::string getMgCycle() const;
+
+        /*!
+         * @brief Get variant of the CG method.
+         * @return Variant of the CG method, classic, pipelined or s-step.
+         */
+        std::string getCgMethod() const;
+
+        /*!
+         * @brief Get number of steps per block of the s-step CG method.
+         * @return Number of steps per block.
+         */
+        unsigned getSStep() const;
+
+        /*!
+         * @brief Get basis of the s-step CG method.
+         * @return Basis of the s-step CG method, monomial or newton.
+         */
+        std::string getSBasis() const;
+
+        /*!
+         * @brief Get type of element.
+         * @return Type of element, q4, q8 or q9.
+         */
+        std::string getElement() const;
+
+        /*!
+         * @brief Get number of nodes per element of the type of element.
+         * @return Number of nodes per element.
+         */
+        unsigned getNNodePerElem() const;
+
+        /*!
+         * @brief Get Gauss order.
+         * @return Gauss order, 0 for the default of the element.
+         */
+        unsigned getGaussOrder() const;
+
+        /*!
+         * @brief Get directory of the cache on disk.
+         * @return Directory of the cache, none if empty.
+         */
+        std::string getCacheDir() const;
+
+        /*!
+         * @brief Get maximum size of the cache.
+         * @return Maximum size of the cache in MiB.
+         */
+        unsigned getCacheSize() const;
+
         /*!
          * @brief Get boolean that controlls if program can run.
          * @return Boolean that controlls if program can run.
@@ -29,11 +29,18 @@
 #ifndef __CCONDUCTANCE_HPP
 #define __CCONDUCTANCE_HPP
 
+#include <vector>
+
 #include "CMatrix.hpp"
 #include "CMatrixSymmetric.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+#include "CMatrixFixed.hpp"
 #include "CMaterial.hpp"
 #include "CMesh.hpp"
 #include "CGeometry.hpp"
+#include "CBoundaryConditions.hpp"
+#include "CShapeFunctions.hpp"
 
 /*!
  * @class CConductance
@@ -41,10 +48,86 @@
  */
 class CConductance {
     private:
-        unsigned gaussOrder;    /*!< @brief Number of Gauss points.*/
-        CMatrix gaussPoints;    /*!< @brief Locations of Gauss points.*/
-        CMatrix gaussWeights;   /*!< @brief Weights of Gauss points.*/
-        CMatrix conducMtx;      /*!< @brief Conductance matrix.*/
+        unsigned gaussOrder;        /*!< @brief Number of Gauss points.*/
+        CMatrix gaussPoints;        /*!< @brief Locations of Gauss points.*/
+        CMatrix gaussWeights;       /*!< @brief Weights of Gauss points.*/
+        const CShapeFunctions* shape;   /*!< @brief Shape functions tabulated at the Gauss points.*/
+        CMatrixSparse conducMtx;    /*!< @brief Conductance matrix.*/
+        bool reduced;               /*!< @brief Boolean to know if the submatrices of the reduced system are assembled instead of the whole matrix.*/
+        CMatrixSparseSymmetric conducFF;    /*!< @brief Conductance submatrix at known fluxes, lower triangle.*/
+        CMatrixSparse conducFFRows; /*!< @brief Lower triangle of the rows of Kff owned by the rank in a distributed assembly, with global columns.*/
+        CMatrixSparse conducEF;     /*!< @brief Coupling of the known temperatures with the known fluxes.*/
+        CMatrix conducEE;           /*!< @brief Conductance submatrix at known temperatures.*/
+        bool distributed;           /*!< @brief Boolean to know if every rank only has its owned rows of Kff.*/
+        std::vector<unsigned> ffRowOffsets; /*!< @brief First row of Kff owned by every rank, with nRanks+1 entries.*/
+        CGeometry geometry;         /*!< @brief Geometry of the assembled plate.*/
+        CMaterial material;         /*!< @brief Material of the assembled plate.*/
+        unsigned nElemClasses;      /*!< @brief Number of elements with different geometry in the last assembly.*/
+
+        /*!
+         * @brief Build the sparsity pattern of the global conductance matrix
+         *        from the connectivity of the mesh.
+         * @param[in] msh - Mesh.
+         * @return Conductance matrix with the pattern set and zero entries.
+         */
+        CMatrixSparse sparsityPattern(const CMesh& msh);
+
+        /*!
+         * @brief Group the elements with the same geometry up to a translation
+         *        and compute the conductance matrix once per group.
+         * @param[in] msh - Mesh.
+         * @param[in] D - Conductivity matrix.
+         * @param[in] thick - Thickness of the plate.
+         * @param[in] initEl - First element.
+         * @param[in] finaEl - Element after the last one.
+         * @param[out] elClass - Group of every element from initEl.
+         * @param[out] classKe - Conductance matrix of every group, stored
+         *                       column by column.
+         * @return Number of groups.
+         */
+        unsigned elementClasses(const CMesh& msh, const CMatrixFixed<2, 2>& D,
+                                const double thick, const unsigned initEl,
+                                const unsigned finaEl,
+                                std::vector<unsigned>& elClass,
+                                std::vector<double>& classKe) const;
+
+        /*!
+         * @brief Sum the matrices assembled by every rank. Each row is owned
+         *        by one rank, only the interface rows are sent to their owners
+         *        and then the owned rows are gathered.
+         * @param[in] nRows - Number of rows.
+         * @param[in] range - First row and row after the last one touched by
+         *                    the elements of this rank.
+         * @param[in] first - First row stored in rowPtr and val, 0 if they
+         *                    store all the rows.
+         * @param[in] rowPtr - Row pointers of the stored rows.
+         * @param[in,out] val - Entries of the matrix of this rank, and of all
+         *                      the ranks at the end.
+         * @param[in] gather - Boolean to gather the owned rows. Otherwise only
+         *                     the owned rows of val are complete at the end.
+         * @return First row owned by every rank, with nRanks+1 entries.
+         */
+        std::vector<unsigned> reduceRanks(const unsigned nRows,
+                                          const unsigned* range,
+                                          const unsigned first,
+                                          const unsigned* rowPtr, double* val,
+                                          const bool gather = true) const;
+
+        /*!
+         * @brief Scatter the elemental matrices of this rank, in parallel by
+         *        colors of elements.
+         * @param[in] msh - Mesh.
+         * @param[in] initEl - First element of this rank.
+         * @param[in] finaEl - Element after the last one of this rank.
+         * @param[in] elClass - Group of every element of this rank.
+         * @param[in] classKe - Conductance matrix of every group.
+         * @param[in] add - Function called with the global row, column and
+         *                  value of every entry.
+         */
+        template <typename F>
+        void scatter(const CMesh& msh, const unsigned initEl,
+                     const unsigned finaEl, const std::vector<unsigned>& elClass,
+                     const std::vector<double>& classKe, F add) const;
 
         /*!
          * @brief Assemble global conductance matrix.
@@ -53,9 +136,20 @@ class CConductance {
          * @param[in] msh - Mesh.
          * @return Conductance matrix.
          */
-        CMatrix conductanceMtx(const CGeometry& geo,
-                               const CMaterial& mat,
-                               const CMesh& msh);
+        CMatrixSparse conductanceMtx(const CGeometry& geo,
+                                     const CMaterial& mat,
+                                     const CMesh& msh);
+
+        /*!
+         * @brief Assemble the conductance submatrices of the reduced system
+         *        directly, without the whole matrix.
+         * @param[in] geo - Geometry.
+         * @param[in] mat - Material.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         */
+        void reducedMtx(const CGeometry& geo, const CMaterial& mat,
+                        const CMesh& msh, const CBoundaryConditions& bnd);
 
     public:
         /*!
@@ -72,6 +166,38 @@ class CConductance {
         CConductance(const CGeometry& geo, const CMaterial& mat,
                      const CMesh& msh);
 
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] geo - Geometry.
+         * @param[in] mat - Material.
+         * @param[in] msh - Mesh.
+         * @param[in] assemble - Boolean to assemble the conductance matrix,
+         *                       false for the matrix-free solver.
+         * @param[in] order - Gauss order, 0 to use the default one of the
+         *                    elements of the mesh.
+         */
+        CConductance(const CGeometry& geo, const CMaterial& mat,
+                     const CMesh& msh, const bool assemble,
+                     const unsigned order = 0);
+
+        /*!
+         * @brief Constructor of the class. Only the submatrices of the reduced
+         *        system are assembled, from the DOF with known temperature.
+         * @param[in] geo - Geometry.
+         * @param[in] mat - Material.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         * @param[in] order - Gauss order, 0 to use the default one of the
+         *                    elements of the mesh.
+         * @param[in] distribute - Boolean to assemble in every rank only the
+         *                         rows of Kff touched by its elements and keep
+         *                         its owned rows, for the distributed solver,
+         *                         instead of gathering all of them.
+         */
+        CConductance(const CGeometry& geo, const CMaterial& mat,
+                     const CMesh& msh, const CBoundaryConditions& bnd,
+                     const unsigned order = 0, const bool distribute = false);
+
         /*!
          * @brief Destructor of the class.
          */
@@ -87,19 +213,119 @@ class CConductance {
          * @brief Get location of Gauss points.
          * @return Location of Gauss points.
          */
-        CMatrix getGaussPoints() const;
+        const CMatrix& getGaussPoints() const;
 
         /*!
          * @brief Get weights of Gauss points.
          * @return Weights of Gauss points.
          */
-        CMatrix getGaussWeights() const;
+        const CMatrix& getGaussWeights() const;
+
+        /*!
+         * @brief Compute the conductance matrix of an element with Gaussian
+         *        quadrature. The matrices have fixed size, so no memory is
+         *        allocated. It is instantiated for 4, 8 and 9 nodes, which
+         *        must be the nodes of the elements of the mesh.
+         * @param[in] eCoord - Coordinates of the N nodes of the element.
+         * @param[in] D - Conductivity matrix.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrix, of size NxN.
+         */
+        template <unsigned N>
+        void elementConductance(const CMatrixFixed<N, 2>& eCoord,
+                                const CMatrixFixed<2, 2>& D, const double thick,
+                                CMatrixFixed<N, N>& Ke) const;
+
+        /*!
+         * @brief Split the elements among the ranks and compute the elemental
+         *        conductance matrices of this rank.
+         * @param[in] geo - Geometry.
+         * @param[in] mat - Material.
+         * @param[in] msh - Mesh.
+         * @param[out] initEl - First element of this rank.
+         * @param[out] finaEl - Element after the last one of this rank.
+         * @param[out] elClass - Group of every element of this rank.
+         * @param[out] classKe - Conductance matrix of every group, stored
+         *                       column by column.
+         * @return Number of groups.
+         */
+        unsigned elementMatrices(const CGeometry& geo, const CMaterial& mat,
+                                 const CMesh& msh, unsigned& initEl,
+                                 unsigned& finaEl,
+                                 std::vector<unsigned>& elClass,
+                                 std::vector<double>& classKe) const;
 
         /*!
          * @brief Get the conductance matrix.
          * @return Conductance matrix.
          */
-        CMatrix getConducMtx() const;
+        const CMatrixSparse& getConducMtx() const;
+
+        /*!
+         * @brief Check if only the submatrices of the reduced system are
+         *        assembled.
+         * @return Boolean to know if the submatrices are assembled.
+         */
+        bool isReduced() const;
+
+        /*!
+         * @brief Get the conductance submatrix at known fluxes, empty if it is
+         *        distributed.
+         * @return Lower triangle of Kff.
+         */
+        const CMatrixSparseSymmetric& getConducFF() const;
+
+        /*!
+         * @brief Check if every rank only has its owned rows of Kff.
+         * @return Boolean to know if Kff is distributed.
+         */
+        bool isDistributed() const;
+
+        /*!
+         * @brief Get the rows of Kff owned by the rank in a distributed
+         *        assembly.
+         * @return Lower triangle of the owned rows, with global columns.
+         */
+        const CMatrixSparse& getConducFFRows() const;
+
+        /*!
+         * @brief Get the first row of Kff owned by every rank in the
+         *        assembly.
+         * @return Row offsets, with nRanks+1 entries.
+         */
+        const std::vector<unsigned>& getConducFFOffsets() const;
+
+        /*!
+         * @brief Get the coupling of the known temperatures with the known
+         *        fluxes.
+         * @return Kef submatrix.
+         */
+        const CMatrixSparse& getConducEF() const;
+
+        /*!
+         * @brief Get the conductance submatrix at known temperatures.
+         * @return Kee submatrix.
+         */
+        const CMatrix& getConducEE() const;
+
+        /*!
+         * @brief Get the number of elemental conductance matrices that were
+         *        computed in the assembly, one per element geometry.
+         * @return Number of element geometries.
+         */
+        unsigned getNElemClasses() const;
+
+        /*!
+         * @brief Get the geometry used to assemble the conductance matrix.
+         * @return Geometry.
+         */
+        CGeometry getGeometry() const;
+
+        /*!
+         * @brief Get the material used to assemble the conductance matrix.
+         * @return Material.
+         */
+        CMaterial getMaterial() const;
 };
 
 #endif
@@ -0,0 +1,168 @@
+/*!
+ * @file CConductanceKernel.hpp
+ * @brief Headers of the main subroutines for computing the conductance
+ *        matrices of a batch of bilinear elements with SIMD instructions.
+ *        The implementation is in the <i>CConductanceKernel.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CCONDUCTANCEKERNEL_HPP
+#define __CCONDUCTANCEKERNEL_HPP
+
+#include <string>
+
+#include "CMatrixFixed.hpp"
+#include "CShapeFunctions.hpp"
+
+/*!
+ * @class CConductanceKernel
+ * @brief Conductance matrices of a batch of quadrilateral elements. The elements of
+ *        a batch are the lanes of the SIMD registers, so the data is stored as
+ *        structure of arrays: entry k of element l is at position
+ *        k*batchSize+l. The instruction set (AVX-512, AVX2 or scalar) is
+ *        selected at runtime from the features of the CPU.
+ */
+class CConductanceKernel {
+    private:
+        /*!
+         * @brief Type of the functions that compute a batch.
+         */
+        typedef void (*TKernel)(const CShapeFunctions&, const double*,
+                                const double*, const double, double*);
+
+        static TKernel kernel;          /*!< @brief Function used to compute the batches.*/
+        static std::string isaName;     /*!< @brief Name of the instruction set of the kernel.*/
+
+        /*!
+         * @brief Select the widest instruction set supported by the CPU.
+         * @return Name of the instruction set.
+         */
+        static std::string detectInstructionSet();
+
+        /*!
+         * @brief Compute the lanes of a batch that fit in a vector type.
+         * @param[in] shape - Shape functions of the Gauss order.
+         * @param[in] eCoord - Coordinates of the nodes, starting at the first lane.
+         * @param[in] D - Conductivity matrix, stored column by column.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices, starting at the
+         *                  first lane.
+         */
+        template <typename V, unsigned N>
+        static void computeLanes(const CShapeFunctions& shape,
+                                 const double* eCoord, const double* D,
+                                 const double thick, double* Ke);
+
+        /*!
+         * @brief Compute the lanes of a batch that fit in a vector type, for
+         *        the number of nodes of the shape functions.
+         * @param[in] shape - Shape functions of the Gauss order.
+         * @param[in] eCoord - Coordinates of the nodes, starting at the first lane.
+         * @param[in] D - Conductivity matrix, stored column by column.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices, starting at the
+         *                  first lane.
+         */
+        template <typename V>
+        static void computeElements(const CShapeFunctions& shape,
+                                    const double* eCoord, const double* D,
+                                    const double thick, double* Ke);
+
+        /*!
+         * @brief Compute a batch one element at a time.
+         * @param[in] shape - Shape functions of the Gauss order.
+         * @param[in] eCoord - Coordinates of the nodes of the batch.
+         * @param[in] D - Conductivity matrix, stored column by column.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices of the batch.
+         */
+        static void computeScalar(const CShapeFunctions& shape,
+                                  const double* eCoord, const double* D,
+                                  const double thick, double* Ke);
+
+        /*!
+         * @brief Compute a batch with AVX2, 4 elements at a time.
+         * @param[in] shape - Shape functions of the Gauss order.
+         * @param[in] eCoord - Coordinates of the nodes of the batch.
+         * @param[in] D - Conductivity matrix, stored column by column.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices of the batch.
+         */
+        static void computeAVX2(const CShapeFunctions& shape,
+                                const double* eCoord, const double* D,
+                                const double thick, double* Ke);
+
+        /*!
+         * @brief Compute a batch with AVX-512, 8 elements at a time.
+         * @param[in] shape - Shape functions of the Gauss order.
+         * @param[in] eCoord - Coordinates of the nodes of the batch.
+         * @param[in] D - Conductivity matrix, stored column by column.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices of the batch.
+         */
+        static void computeAVX512(const CShapeFunctions& shape,
+                                  const double* eCoord, const double* D,
+                                  const double thick, double* Ke);
+
+    public:
+        static const unsigned batchSize = 8;    /*!< @brief Number of elements of a batch.*/
+        static const unsigned maxNodes = 9;     /*!< @brief Largest number of nodes of the elements.*/
+
+        /*!
+         * @brief Get the instruction set used by the kernel.
+         * @return Name of the instruction set, avx512, avx2 or scalar.
+         */
+        static std::string getInstructionSet();
+
+        /*!
+         * @brief Force the instruction set used by the kernel.
+         * @param[in] isa - Name of the instruction set, avx512, avx2 or scalar.
+         */
+        static void setInstructionSet(const std::string& isa);
+
+        /*!
+         * @brief Check if the CPU supports an instruction set.
+         * @param[in] isa - Name of the instruction set, avx512, avx2 or scalar.
+         * @return Boolean to know if the instruction set can be used.
+         */
+        static bool isSupported(const std::string& isa);
+
+        /*!
+         * @brief Compute the conductance matrices of a batch of elements.
+         *        Unused lanes must hold the coordinates of a valid element.
+         * @param[in] shape - Shape functions of the Gauss order and element.
+         * @param[in] eCoord - Coordinates of the nodes, x of the N nodes
+         *                     followed by y of the N nodes, batchSize entries
+         *                     each.
+         * @param[in] D - Conductivity matrix.
+         * @param[in] thick - Thickness of the plate.
+         * @param[out] Ke - Elemental conductance matrices stored column by
+         *                  column, N*N entries of batchSize values.
+         */
+        static void compute(const CShapeFunctions& shape, const double* eCoord,
+                            const CMatrixFixed<2, 2>& D, const double thick,
+                            double* Ke);
+};
+
+#endif
@@ -0,0 +1,306 @@
+/*!
+ * @file CFactorCache.hpp
+ * @brief Headers of the main subroutines for caching the submatrices and the
+ *        factorization of the reduced system between solutions.
+ *        The implementation is in the <i>CFactorCache.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CFACTORCACHE_HPP
+#define __CFACTORCACHE_HPP
+
+#include <string>
+#include <list>
+#include <map>
+#include <iostream>
+
+#include "CGeometry.hpp"
+#include "CMaterial.hpp"
+#include "CMesh.hpp"
+#include "CBoundaryConditions.hpp"
+#include "CMatrix.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+#include "CSparseCholesky.hpp"
+
+/*!
+ * @class CFactorCache
+ * @brief Class to keep the submatrices Kee, Kef and Kff and the sparse
+ *        Cholesky factor of Kff between solutions. They only depend on the
+ *        geometry, the material, the mesh and the location of the temperature
+ *        BC, so problems that only change the BC values reuse them without
+ *        assembly or factorization. The entries are kept in memory, evicting
+ *        the least recently used ones above a maximum size, and optionally in
+ *        a directory, where they outlive the process. The files of the
+ *        directory are bounded by the same size, evicting the entries with
+ *        the oldest modification time. Every MPI rank keeps its own entries
+ *        in memory, and rank 0 writes them to disk.
+ */
+class CFactorCache {
+    private:
+        /*!
+         * @brief Submatrices and factor of a reduced system.
+         */
+        struct Entry {
+            CMatrix Kee;                        /*!< @brief Conductance submatrix at known temperatures.*/
+            CMatrixSparse Kef;                  /*!< @brief Conductance submatrix at known temperatures and fluxes.*/
+            CMatrixSparseSymmetric Kff;         /*!< @brief Conductance submatrix at known fluxes.*/
+            CSparseCholesky<double> factor;     /*!< @brief Sparse Cholesky factor of Kff.*/
+            bool isFactored;                    /*!< @brief Boolean to know if the factor is computed.*/
+            size_t bytes;                       /*!< @brief Memory taken by the entry.*/
+            std::list<std::string>::iterator use;   /*!< @brief Position of the key in the recency list.*/
+        };
+
+        size_t maxBytes;                        /*!< @brief Maximum memory of the entries.*/
+        size_t usedBytes;                       /*!< @brief Memory taken by the entries.*/
+        int rank;                               /*!< @brief MPI rank, only rank 0 writes to disk.*/
+        std::string directory;                  /*!< @brief Directory of the entries on disk, none if empty.*/
+        unsigned nHits;                         /*!< @brief Number of lookups that found the entry.*/
+        unsigned nMisses;                       /*!< @brief Number of lookups that did not find the entry.*/
+        unsigned nEvictions;                    /*!< @brief Number of entries evicted from memory.*/
+        unsigned nDiskEvictions;                /*!< @brief Number of entries evicted from disk.*/
+        std::map<std::string, Entry> entries;   /*!< @brief Entries in memory by key.*/
+        std::list<std::string> recency;         /*!< @brief Keys in memory, the most recently used first.*/
+
+        /*!
+         * @brief Get an entry in memory.
+         * @param[in] key - Key of the entry.
+         * @return Entry.
+         */
+        const Entry& getEntry(const std::string& key) const;
+
+        /*!
+         * @brief Memory taken by the matrices and the factor of an entry.
+         * @param[in] entry - Entry.
+         * @return Memory in bytes.
+         */
+        static size_t entryBytes(const Entry& entry);
+
+        /*!
+         * @brief Mark an entry as the most recently used and evict the least
+         *        recently used ones while the maximum size is exceeded. The
+         *        marked entry is always kept.
+         * @param[in] key - Key of the entry.
+         */
+        void touch(const std::string& key);
+
+        /*!
+         * @brief Remove an entry from memory, if it is there.
+         * @param[in] key - Key of the entry.
+         */
+        void erase(const std::string& key);
+
+        /*!
+         * @brief Path of a file of an entry on disk.
+         * @param[in] key - Key of the entry.
+         * @param[in] ext - Extension, mtx for the submatrices and chol for the
+         *                  factor.
+         * @return Path of the file.
+         */
+        std::string getPath(const std::string& key, const std::string ext) const;
+
+        /*!
+         * @brief Evict the files of the entries on disk with the oldest
+         *        modification time while the maximum size is exceeded. The
+         *        files of the given entry are always kept.
+         * @param[in] key - Key of the entry just written or used.
+         */
+        void evictDisk(const std::string& key);
+
+        /*!
+         * @brief Write a file atomically, through a temporary file renamed at
+         *        the end, so that concurrent writers never leave a partial file.
+         * @param[in] path - Path of the file.
+         * @param[in] data - Content of the file.
+         */
+        static void writeFile(const std::string& path, const std::string& data);
+
+        /*!
+         * @brief Load an entry from disk into memory.
+         * @param[in] key - Key of the entry.
+         * @return Boolean to know if the entry is on disk.
+         */
+        bool readEntry(const std::string& key);
+
+        /*!
+         * @brief Write a sparse matrix in binary format.
+         * @param[in,out] out - Output stream.
+         * @param[in] A - Sparse matrix, in general or symmetric storage.
+         */
+        template <typename M>
+        static void writeSparse(std::ostream& out, const M& A);
+
+        /*!
+         * @brief Read a sparse matrix written by writeSparse.
+         * @param[in,out] in - Input stream.
+         * @return Sparse matrix, in general or symmetric storage.
+         */
+        template <typename M>
+        static M readSparse(std::istream& in);
+
+    public:
+        /*!
+         * @brief Constructor of the class, with the entries only in memory
+         *        and no maximum size.
+         */
+        CFactorCache();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] maxSize - Maximum size of the entries in bytes, both in
+         *                      memory and on disk.
+         * @param[in] dir - Existing directory to keep the entries on disk, none
+         *                  if empty.
+         */
+        CFactorCache(const size_t maxSize, const std::string dir = "");
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CFactorCache();
+
+        /*!
+         * @brief Key of the submatrices of a problem, hash of the geometry,
+         *        the material, the mesh sizes, the Gauss order and the nodes
+         *        with temperature BC. The BC values are left out.
+         * @param[in] geo - Geometry.
+         * @param[in] mat - Material.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         * @return Key, 16 hexadecimal digits.
+         */
+        static std::string computeKey(const CGeometry& geo, const CMaterial& mat,
+                                      const CMesh& msh,
+                                      const CBoundaryConditions& bnd);
+
+        /*!
+         * @brief Check if an entry is in memory, without counting the lookup.
+         * @param[in] key - Key of the entry.
+         * @return Boolean to know if the entry is in memory.
+         */
+        bool contains(const std::string& key) const;
+
+        /*!
+         * @brief Look up an entry, loading it from disk if it is not in memory,
+         *        and count the hit or the miss. An entry that cannot be read
+         *        is removed from disk and counts as a miss. Collective: the
+         *        lookup is a hit only if every rank finds the entry.
+         * @param[in] key - Key of the entry.
+         * @return Boolean to know if the entry is found, the same in every rank.
+         */
+        bool find(const std::string& key);
+
+        /*!
+         * @brief Add the submatrices of a problem, also on disk if there is a
+         *        directory.
+         * @param[in] key - Key of the entry.
+         * @param[in] Kee - Conductance submatrix at known temperatures.
+         * @param[in] Kef - Conductance submatrix at known temperatures and fluxes.
+         * @param[in] Kff - Conductance submatrix at known fluxes.
+         */
+        void insert(const std::string& key, const CMatrix& Kee,
+                    const CMatrixSparse& Kef, const CMatrixSparseSymmetric& Kff);
+
+        /*!
+         * @brief Add the sparse Cholesky factor of Kff to an entry in memory,
+         *        also on disk if there is a directory.
+         * @param[in] key - Key of the entry.
+         * @param[in] factor - Sparse Cholesky factor of Kff.
+         */
+        void insertFactor(const std::string& key,
+                          const CSparseCholesky<double>& factor);
+
+        /*!
+         * @brief Get Kee submatrix of an entry in memory.
+         * @param[in] key - Key of the entry.
+         * @return Kee submatrix.
+         */
+        const CMatrix& getKee(const std::string& key) const;
+
+        /*!
+         * @brief Get Kef submatrix of an entry in memory.
+         * @param[in] key - Key of the entry.
+         * @return Kef submatrix.
+         */
+        const CMatrixSparse& getKef(const std::string& key) const;
+
+        /*!
+         * @brief Get Kff submatrix of an entry in memory.
+         * @param[in] key - Key of the entry.
+         * @return Kff submatrix.
+         */
+        const CMatrixSparseSymmetric& getKff(const std::string& key) const;
+
+        /*!
+         * @brief Check if an entry in memory has the factor of Kff.
+         * @param[in] key - Key of the entry.
+         * @return Boolean to know if the factor is cached.
+         */
+        bool isFactored(const std::string& key) const;
+
+        /*!
+         * @brief Get sparse Cholesky factor of Kff of an entry in memory.
+         * @param[in] key - Key of the entry.
+         * @return Sparse Cholesky factor of Kff.
+         */
+        const CSparseCholesky<double>& getFactor(const std::string& key) const;
+
+        /*!
+         * @brief Get number of lookups that found the entry.
+         * @return Number of hits.
+         */
+        unsigned getNHits() const;
+
+        /*!
+         * @brief Get number of lookups that did not find the entry.
+         * @return Number of misses.
+         */
+        unsigned getNMisses() const;
+
+        /*!
+         * @brief Get number of entries evicted from memory.
+         * @return Number of evictions.
+         */
+        unsigned getNEvictions() const;
+
+        /*!
+         * @brief Get number of entries evicted from disk.
+         * @return Number of evictions.
+         */
+        unsigned getNDiskEvictions() const;
+
+        /*!
+         * @brief Get number of entries in memory.
+         * @return Number of entries.
+         */
+        unsigned getNEntries() const;
+
+        /*!
+         * @brief Get memory taken by the entries.
+         * @return Memory in bytes.
+         */
+        size_t getUsedBytes() const;
+};
+
+#endif
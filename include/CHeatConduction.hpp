@@ -29,11 +29,18 @@
 #ifndef __CHEATCONDUCTION_HPP
 #define __CHEATCONDUCTION_HPP
 
+#include <string>
+#include <vector>
+
 #include "CConductance.hpp"
 #include "CBoundaryConditions.hpp"
 #include "CMatrix.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
 #include "CMesh.hpp"
 #include "CMaterial.hpp"
+#include "CLinearSystem.hpp"
+#include "CFactorCache.hpp"
 
 /*!
  * @class CHeatConduction
@@ -41,18 +48,30 @@
  */
 class CHeatConduction {
     private:
-        CMatrix Kee;    /*!< @brief Conductance submatrix at known temperatures.*/
-        CMatrix Kff;    /*!< @brief Conductance submatrix at known fluxes.*/
-        CMatrix Kef;    /*!< @brief Conductance submatrix at known temperatures and fluxes.*/
-        CMatrix Te;     /*!< @brief Temperature subvector at known temperatures.*/
-        CMatrix Tf;     /*!< @brief Temperature subvector at known fluxes.*/
-        CMatrix Fe;     /*!< @brief Flux subvector at known temperatures.*/
-        CMatrix Ff;     /*!< @brief Flux subvector at known fluxes.*/
-        CMatrix temp;   /*!< @brief Temperature vector.*/
-        CMatrix flux;   /*!< @brief Flux vector.*/
+        CMatrix Kee;                   /*!< @brief Conductance submatrix at known temperatures.*/
+        CMatrixSparseSymmetric Kff;    /*!< @brief Conductance submatrix at known fluxes.*/
+        CMatrixSparse Kef;             /*!< @brief Conductance submatrix at known temperatures and fluxes, in sparse storage.*/
+        CMatrix Te;                    /*!< @brief Temperature subvector at known temperatures.*/
+        CMatrix Tf;                    /*!< @brief Temperature subvector at known fluxes.*/
+        CMatrix Fe;                    /*!< @brief Flux subvector at known temperatures.*/
+        CMatrix Ff;                    /*!< @brief Flux subvector at known fluxes.*/
+        CMatrix temp;                  /*!< @brief Temperature vector.*/
+        CMatrix flux;                  /*!< @brief Flux vector.*/
+        std::string precondType;       /*!< @brief Preconditioner of the CG method.*/
+        std::string solverType;        /*!< @brief Solver, cg, distributed, matrix-free, multigrid, direct, cholesky or mixed.*/
+        std::string cycleType;         /*!< @brief Cycle of the multigrid method, V or W.*/
+        std::string cgMethod;          /*!< @brief Variant of the CG method, classic, pipelined or s-step.*/
+        unsigned sStep;                /*!< @brief Number of steps per block of the s-step CG method.*/
+        std::string sBasis;            /*!< @brief Basis of the s-step CG method, monomial or newton.*/
+        unsigned nIterations;          /*!< @brief Number of iterations of the iterative solver.*/
+        unsigned halfBandwidth;        /*!< @brief Half-bandwidth of Kff in the direct solver.*/
+        std::vector<double> iterationTimes; /*!< @brief Time per iteration of the products, the preconditioner, the reductions and the vector updates of the CG method.*/
+        CFactorCache* cache;           /*!< @brief Cache of the submatrices and the sparse Cholesky factor, none if null.*/
+        std::string cacheKey;          /*!< @brief Key of the problem in the cache.*/
 
         /*!
          * @brief Subroutine to subdivide matrices and vecors, Kee, Kff, Kef, Te, Tf.
+         *        The matrix-free solver only needs the vectors.
          * @param[in] bnd - Boundary conditions.
          * @param[in] cnd - Conductance.
          */
@@ -63,18 +82,52 @@ class CHeatConduction {
          * @brief Solve the heat problem returning the temperature vector.
          * @param[in] msh - Mesh.
          * @param[in] bnd - Boundary conditions.
+         * @param[in] cnd - Conductance.
          * @return Temperature vector.
          */
         CMatrix solveTemperature(const CMesh& msh,
-                                 const CBoundaryConditions& bnd);
+                                 const CBoundaryConditions& bnd,
+                                 const CConductance& cnd);
+
+        /*!
+         * @brief Solve a system with the selected variant of the CG method,
+         *        keeping the number of iterations and the time breakdown.
+         * @param[in,out] sys - Linear system with its preconditioner set.
+         * @return Solution of the system.
+         */
+        template <typename T> CMatrix solveCG(CLinearSystem<T>& sys);
+
+        /*!
+         * @brief Solve the system at known fluxes with the banded Cholesky
+         *        factorization. The DOF are numbered along the direction of
+         *        the mesh that gives the smaller band.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         * @param[in] RHS - RHS vector of the system.
+         * @return Temperature subvector at known fluxes.
+         */
+        CMatrix solveBanded(const CMesh& msh, const CBoundaryConditions& bnd,
+                            const CMatrix& RHS);
+
+        /*!
+         * @brief Elimination order of the DOF at known fluxes for the sparse
+         *        Cholesky factorization, from the nested dissection of the mesh.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         * @return Position in Kff of every row of the permuted matrix.
+         */
+        std::vector<unsigned> choleskyOrder(const CMesh& msh,
+                                            const CBoundaryConditions& bnd);
 
         /*!
          * @brief Solve the heat problem returning the flux vector.
          * @param[in] msh - Mesh.
          * @param[in] bnd - Boundary conditions.
+         * @param[in] cnd - Conductance.
          * @return Flux vector.
          */
-        CMatrix solveFlux(const CMesh& msh, const CBoundaryConditions& bnd);
+        CMatrix solveFlux(const CMesh& msh, const CBoundaryConditions& bnd,
+                          const CConductance& cnd);
 
     public:
         /*!
@@ -91,6 +144,40 @@ class CHeatConduction {
         CHeatConduction(const CBoundaryConditions& bnd, const CConductance& cnd,
                         const CMesh& msh);
 
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] bnd - Boundary conditions.
+         * @param[in] cnd - Conductance.
+         * @param[in] msh - Mesh.
+         * @param[in] precond - Preconditioner of the CG method: none, jacobi,
+         *                      ssor, ic0, multigrid or amg. The hierarchy
+         *                      of amg is built for every solve, the cache
+         *                      does not keep it.
+         * @param[in] solver - Solver: cg, distributed, matrix-free, multigrid,
+         *                     direct, cholesky or mixed.
+         * @param[in] cycle - Cycle of the multigrid method: V or W.
+         * @param[in] method - Variant of the CG method: classic, pipelined or
+         *                     s-step.
+         * @param[in] s - Number of steps per block of the s-step CG method.
+         * @param[in] basis - Basis of the s-step CG method: monomial or newton.
+         * @param[in] factorCache - Cache of the submatrices and the sparse
+         *                          Cholesky factor, none if null. If the key
+         *                          was found with CFactorCache::find they are
+         *                          not assembled, and cnd is only needed by
+         *                          the multigrid and matrix-free solvers and
+         *                          the multigrid preconditioner.
+         * @param[in] key - Key of the problem in the cache.
+         */
+        CHeatConduction(const CBoundaryConditions& bnd, const CConductance& cnd,
+                        const CMesh& msh, const std::string precond,
+                        const std::string solver = "cg",
+                        const std::string cycle = "V",
+                        const std::string method = "classic",
+                        const unsigned s = 4,
+                        const std::string basis = "newton",
+                        CFactorCache* factorCache = nullptr,
+                        const std::string key = "");
+
         /*!
          * @brief Destructor of the class.
          */
@@ -100,55 +187,75 @@ class CHeatConduction {
          * @brief Get Kee submatrix.
          * @return Kee submatrix.
          */
-        CMatrix getKee() const;
+        const CMatrix& getKee() const;
 
         /*!
-         * @brief Get Kff submatrix.
+         * @brief Get Kff submatrix, empty if the conductance is distributed.
          * @return Kff submatrix.
          */
-        CMatrix getKff() const;
+        const CMatrixSparseSymmetric& getKff() const;
 
         /*!
          * @brief Get Kef submatrix.
          * @return Kef submatrix.
          */
-        CMatrix getKef() const;
+        const CMatrixSparse& getKef() const;
 
         /*!
          * @brief Get Te subvector.
          * @return Te subvector.
          */
-        CMatrix getTe() const;
+        const CMatrix& getTe() const;
 
         /*!
          * @brief Get Tf subvector.
          * @return Tf subvector.
          */
-        CMatrix getTf() const;
+        const CMatrix& getTf() const;
 
         /*!
          * @brief Get Fe subvector.
          * @return Fe subvector.
          */
-        CMatrix getFe() const;
+        const CMatrix& getFe() const;
 
         /*!
          * @brief Get Ff subvector.
          * @return Ff subvector.
          */
-        CMatrix getFf() const;
+        const CMatrix& getFf() const;
 
         /*!
          * @brief Get temperature vector.
          * @return Temperature vector.
          */
-        CMatrix getTemp() const;
+        const CMatrix& getTemp() const;
 
         /*!
          * @brief Get flux vector.
          * @return Flux vector.
          */
-        CMatrix getFlux() const;
+        const CMatrix& getFlux() const;
+
+        /*!
+         * @brief Get number of iterations of the iterative solver.
+         * @return Number of iterations of the iterative solver.
+         */
+        unsigned getNIterations() const;
+
+        /*!
+         * @brief Get time per iteration of the CG method, split in the
+         *        matrix-vector products, the preconditioner, the reductions
+         *        and the vector updates. Empty for the other solvers.
+         * @return Times per iteration in seconds.
+         */
+        const std::vector<double>& getIterationTimes() const;
+
+        /*!
+         * @brief Get half-bandwidth of Kff used by the direct solver.
+         * @return Half-bandwidth of Kff.
+         */
+        unsigned getHalfBandwidth() const;
 };
 
 #endif
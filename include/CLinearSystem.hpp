@@ -29,14 +29,44 @@
 #ifndef __CLINEARSYSTEM_HPP
 #define __CLINEARSYSTEM_HPP
 
+#include <string>
+
 #include "CMatrix.hpp"
 #include "CMatrixSymmetric.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+#include "CMatrixBanded.hpp"
+#include "CMatrixFree.hpp"
+#include "CMatrixDistributed.hpp"
+#include "CPreconditioner.hpp"
 
 #define F77NAME(x) x##_
 extern "C" {
     void F77NAME(dgesv)(const int& n, const int& nrhs, const double* A,
                         const int& lda, int* ipiv, double* B,
                         const int& ldb, int& info);
+    void F77NAME(dpotrf)(const char& uplo, const int& n, double* A,
+                         const int& lda, int& info);
+    void F77NAME(dpotrs)(const char& uplo, const int& n, const int& nrhs,
+                         const double* A, const int& lda, double* B,
+                         const int& ldb, int& info);
+    void F77NAME(dpptrf)(const char& uplo, const int& n, double* AP,
+                         int& info);
+    void F77NAME(dpptrs)(const char& uplo, const int& n, const int& nrhs,
+                         const double* AP, double* B, const int& ldb,
+                         int& info);
+    void F77NAME(dpbtrf)(const char& uplo, const int& n, const int& kd,
+                         double* AB, const int& ldab, int& info);
+    void F77NAME(dpbtrs)(const char& uplo, const int& n, const int& kd,
+                         const int& nrhs, const double* AB, const int& ldab,
+                         double* B, const int& ldb, int& info);
+    void F77NAME(dstev)(const char& jobz, const int& n, double* D, double* E,
+                        double* Z, const int& ldz, double* work, int& info);
+    void F77NAME(dgemm) (const char& transa, const char& transb,
+                         const int& m, const int& n, const int& k,
+                         const double& alpha, const double* A, const int& lda,
+                         const double* B, const int& ldb,
+                         const double& beta, double* C, const int& ldc);
     double F77NAME(ddot) (const int& n,
                           const double *x, const int& incx,
                           const double *y, const int& incy);
@@ -71,6 +101,8 @@ extern "C" {
     void F77NAME(dcopy)	(const int& n,
                          const double* x, const int& incx,
                          double* y, const int& incy);
+    void F77NAME(dscal) (const int& n, const double& alpha,
+                         double* x, const int& incx);
 }
 
 /*!
@@ -79,8 +111,19 @@ extern "C" {
  */
 template <typename T> class CLinearSystem {
     private:
-        T lhsMatrix;              /*!< @brief A matrix of the system.*/
-        CMatrix rhsVector;              /*!< @brief b vector of the system.*/
+        T lhsMatrix;                        /*!< @brief A matrix of the system.*/
+        CMatrix rhsVector;                  /*!< @brief b vector of the system, with one column per RHS.*/
+        const CPreconditioner* precond;     /*!< @brief Preconditioner of the CG method, none if null.*/
+        unsigned nIterations;               /*!< @brief Number of iterations of the last CG solution.*/
+        unsigned ownFirst;                  /*!< @brief First entry of the vectors reduced by this rank.*/
+        unsigned ownSize;                   /*!< @brief Number of entries of the vectors reduced by this rank.*/
+        std::string method;                 /*!< @brief Variant of the CG method, classic, pipelined or s-step.*/
+        unsigned sStep;                     /*!< @brief Number of steps per block of the s-step CG method.*/
+        std::string sBasis;                 /*!< @brief Basis of the s-step CG method, monomial or newton.*/
+        double timeProduct;                 /*!< @brief Time of the matrix-vector products of the last CG solution.*/
+        double timePrecond;                 /*!< @brief Time of the preconditioner of the last CG solution.*/
+        double timeReduction;               /*!< @brief Time of the dot products and their reductions of the last CG solution.*/
+        double timeVector;                  /*!< @brief Time of the vector updates of the last CG solution.*/
 
         /*!
          * @brief Subroutine to know if the system is valid to solve.
@@ -89,24 +132,224 @@ template <typename T> class CLinearSystem {
         bool isSystemValid();
 
         /*!
-         * @brief Parallel dot product of two vectors.
+         * @brief Solve a dense system with the LU factorization.
+         * @param[in] A - Dense matrix.
+         * @param[in] b - RHS vectors.
+         * @return Solution vectors.
+         */
+        CMatrix factorSolve(const CMatrix& A, const CMatrix& b);
+
+        /*!
+         * @brief Solve a symmetric positive definite system with the Cholesky
+         *        factorization of the packed lower triangle.
+         * @param[in] A - Symmetric matrix.
+         * @param[in] b - RHS vectors.
+         * @return Solution vectors.
+         */
+        CMatrix factorSolve(const CMatrixSymmetric& A, const CMatrix& b);
+
+        /*!
+         * @brief Solve a symmetric positive definite band system with the
+         *        banded Cholesky factorization.
+         * @param[in] A - Band matrix.
+         * @param[in] b - RHS vectors.
+         * @return Solution vectors.
+         */
+        CMatrix factorSolve(const CMatrixBanded& A, const CMatrix& b);
+
+        /*!
+         * @brief Classic preconditioned CG method, with three reductions per
+         *        iteration.
+         * @return Vector of unknowns.
+         */
+        CMatrix classicSolve();
+
+        /*!
+         * @brief Pipelined preconditioned CG method (Ghysels and Vanroose).
+         *        The dot products of an iteration are combined in a single
+         *        non-blocking reduction, which is overlapped with the
+         *        preconditioner and the matrix-vector product.
+         * @return Vector of unknowns.
+         */
+        CMatrix pipelinedSolve();
+
+        /*!
+         * @brief Classic preconditioned CG method for several RHS vectors at
+         *        once. The iterations of the columns are independent, but
+         *        their products share one sweep over the matrix and their dot
+         *        products one reduction.
+         * @return Vectors of unknowns.
+         */
+        CMatrix blockSolve();
+
+        /*!
+         * @brief Communication-avoiding s-step CG method. Every block builds
+         *        a basis of the Krylov spaces of the search direction and the
+         *        preconditioned residual with 2s-1 products, and performs s
+         *        iterations with the coordinates in that basis after a single
+         *        reduction of the Gram matrix. The first s iterations are
+         *        blocks of one step whose coefficients give the Ritz values
+         *        that scale and shift the basis.
+         * @return Vector of unknowns.
+         */
+        CMatrix sStepSolve();
+
+        /*!
+         * @brief Dot product of the entries of two vectors reduced by this rank.
+         * @param[in] x - First vector.
+         * @param[in] y - Second vector.
+         * @return Dot product of the entries of this rank.
+         */
+        double localDot(const double* x, const double* y);
+
+        /*!
+         * @brief Set the entries of the vectors reduced by this rank. The
+         *        vectors are replicated in every rank and split in blocks of
+         *        nearly the same size.
+         * @param[in] A - LHS matrix of the system.
+         */
+        template <typename M> void setOwnedRange(const M& A);
+
+        /*!
+         * @brief Set the entries of the vectors reduced by this rank. The
+         *        vectors of a distributed matrix only hold the owned rows.
+         * @param[in] A - Distributed LHS matrix of the system.
+         */
+        void setOwnedRange(const CMatrixDistributed& A);
+
+        /*!
+         * @brief Parallel dot product of two vectors. Every rank reduces its
+         *        own entries and the results are summed over all the ranks.
          * @param[in] x - First vector.
          * @param[in] y - Second vector.
          * @param[in] n - Size of the vectors.
          */
         double parallelDot(double* x, double* y, unsigned n);
 
+        /*!
+         * @brief Residual norm that stops the iterative methods, a fraction
+         *        1e-10 of the norm of the RHS vector. A relative test keeps
+         *        the stop above the round-off of the true residual, which the
+         *        methods that recompute it cannot go below.
+         * @param[in] b - RHS vector.
+         * @param[in] n - Size of the vector.
+         * @return Residual norm that stops the iterations.
+         */
+        double stopNorm(double* b, unsigned n);
+
+        /*!
+         * @brief Apply the preconditioner, or copy the vector if there is no
+         *        preconditioner.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         * @param[in] n - Size of the vectors.
+         */
+        void precondition(double* r, double* z, unsigned n);
+
         void parallelMul(const CMatrix& A, double* x, double* y,
                          unsigned n, double alpha, double beta);
 
         void parallelMul(const CMatrixSymmetric& A, double* x,
                          double* y, unsigned n, double alpha, double beta);
 
+        /*!
+         * @brief Sparse matrix-vector product y = alpha*A*x + beta*y.
+         * @param[in] A - Sparse matrix.
+         * @param[in] x - Vector to multiply.
+         * @param[in,out] y - Vector with the result.
+         * @param[in] n - Size of the vectors.
+         * @param[in] alpha - Scalar multiplying A*x.
+         * @param[in] beta - Scalar multiplying y.
+         */
+        void parallelMul(const CMatrixSparse& A, double* x, double* y,
+                         unsigned n, double alpha, double beta);
+
+        /*!
+         * @brief Symmetric sparse matrix-vector product y = alpha*A*x + beta*y.
+         *        Every stored entry of the lower triangle is used for the
+         *        entries at both sides of the diagonal.
+         * @param[in] A - Symmetric sparse matrix.
+         * @param[in] x - Vector to multiply.
+         * @param[in,out] y - Vector with the result.
+         * @param[in] n - Size of the vectors.
+         * @param[in] alpha - Scalar multiplying A*x.
+         * @param[in] beta - Scalar multiplying y.
+         */
+        void parallelMul(const CMatrixSparseSymmetric& A, double* x,
+                         double* y, unsigned n, double alpha, double beta);
+
+        /*!
+         * @brief Matrix-free product y = alpha*A*x + beta*y, applying the
+         *        elemental matrices without the assembled matrix.
+         * @param[in] A - Matrix-free operator.
+         * @param[in] x - Vector to multiply.
+         * @param[in,out] y - Vector with the result.
+         * @param[in] n - Size of the vectors.
+         * @param[in] alpha - Scalar multiplying A*x.
+         * @param[in] beta - Scalar multiplying y.
+         */
+        void parallelMul(const CMatrixFree& A, double* x, double* y,
+                         unsigned n, double alpha, double beta);
+
+        /*!
+         * @brief Distributed product y = alpha*A*x + beta*y of the owned rows,
+         *        exchanging the ghost entries with the neighbour ranks.
+         * @param[in] A - Distributed matrix.
+         * @param[in] x - Owned block of the vector to multiply.
+         * @param[in,out] y - Owned block of the vector with the result.
+         * @param[in] n - Number of owned rows.
+         * @param[in] alpha - Scalar multiplying A*x.
+         * @param[in] beta - Scalar multiplying y.
+         */
+        void parallelMul(const CMatrixDistributed& A, double* x, double* y,
+                         unsigned n, double alpha, double beta);
+
+        /*!
+         * @brief Product Y = alpha*A*X + beta*Y of several interleaved vectors,
+         *        entry i of vector c at i*nRhs+c, with one product per vector.
+         * @param[in] A - Matrix.
+         * @param[in] X - Vectors to multiply.
+         * @param[in,out] Y - Vectors with the result.
+         * @param[in] n - Size of the vectors.
+         * @param[in] nRhs - Number of vectors.
+         * @param[in] alpha - Scalar multiplying A*X.
+         * @param[in] beta - Scalar multiplying Y.
+         */
+        template <typename M>
+        void parallelMul(const M& A, double* X, double* Y, unsigned n,
+                         unsigned nRhs, double alpha, double beta);
+
+        /*!
+         * @brief Symmetric sparse product Y = alpha*A*X + beta*Y of several
+         *        interleaved vectors in a single sweep over the stored entries.
+         * @param[in] A - Symmetric sparse matrix.
+         * @param[in] X - Interleaved vectors to multiply.
+         * @param[in,out] Y - Interleaved vectors with the result.
+         * @param[in] n - Size of the vectors.
+         * @param[in] nRhs - Number of vectors.
+         * @param[in] alpha - Scalar multiplying A*X.
+         * @param[in] beta - Scalar multiplying Y.
+         */
+        void parallelMul(const CMatrixSparseSymmetric& A, double* X, double* Y,
+                         unsigned n, unsigned nRhs, double alpha, double beta);
+
+        /*!
+         * @brief Dot products of two blocks of interleaved vectors, with a
+         *        single reduction.
+         * @param[in] X - First interleaved vectors.
+         * @param[in] Y - Second interleaved vectors.
+         * @param[in] n - Size of the vectors.
+         * @param[in] nRhs - Number of vectors.
+         * @param[out] dots - Dot product of every pair of vectors.
+         */
+        void blockDot(const double* X, const double* Y, unsigned n,
+                      unsigned nRhs, double* dots);
+
     public:
         /*!
          * @brief Constructor of the class.
          * @param[in] A - LHS matrix of coefficients.
-         * @param[in] b - RHS vector.
+         * @param[in] b - RHS vector, or one column per RHS vector.
          */
         CLinearSystem(const T& A, const CMatrix& b);
 
@@ -127,6 +370,62 @@ template <typename T> class CLinearSystem {
          */
         CMatrix getRhsVector();
 
+        /*!
+         * @brief Set the preconditioner of the CG method. The preconditioner is
+         *        not owned by the system and has to outlive the solution.
+         * @param[in] M - Preconditioner, or null for the classic CG method.
+         */
+        void setPreconditioner(const CPreconditioner* M);
+
+        /*!
+         * @brief Set the variant of the CG method.
+         * @param[in] m - Variant of the CG method, classic, pipelined or
+         *                s-step.
+         */
+        void setMethod(const std::string m);
+
+        /*!
+         * @brief Set the parameters of the s-step CG method.
+         * @param[in] s - Number of steps per block.
+         * @param[in] basis - Basis of the Krylov spaces, monomial or newton
+         *                    (shifted by the Ritz values of the first block).
+         */
+        void setSStep(const unsigned s, const std::string basis);
+
+        /*!
+         * @brief Get the number of iterations of the last iterative solution.
+         * @return Number of iterations.
+         */
+        unsigned getNIterations() const;
+
+        /*!
+         * @brief Get the time of the matrix-vector products of the last
+         *        iterative solution.
+         * @return Time in seconds.
+         */
+        double getTimeProduct() const;
+
+        /*!
+         * @brief Get the time of the preconditioner of the last iterative
+         *        solution.
+         * @return Time in seconds.
+         */
+        double getTimePrecond() const;
+
+        /*!
+         * @brief Get the time of the dot products of the last iterative
+         *        solution, including the wait for their reductions.
+         * @return Time in seconds.
+         */
+        double getTimeReduction() const;
+
+        /*!
+         * @brief Get the time of the vector updates of the last iterative
+         *        solution.
+         * @return Time in seconds.
+         */
+        double getTimeVector() const;
+
         /*!
          * @brief Direct solution of the system with LU decomposition.
          * @return Vector of unknowns.
@@ -134,10 +433,23 @@ template <typename T> class CLinearSystem {
         CMatrix directSolve();
 
         /*!
-         * @brief Iterative solution of the system with CG method.
-         * @return Vector of unknowns.
+         * @brief Iterative solution of the system with the selected variant of
+         *        the preconditioned CG method. Several RHS vectors are solved
+         *        together with the classic variant.
+         * @return Vector of unknowns, with one column per RHS vector.
          */
         CMatrix iterativeSolve();
+
+        /*!
+         * @brief Solution of the system by iterative refinement. Every
+         *        correction solves the residual with a factorization of lower
+         *        precision, and the residual is computed with the matrix of
+         *        the system in double precision.
+         * @param[in] factor - Factorization of the LHS matrix with a solve
+         *                     method, such as CSparseCholesky<float>.
+         * @return Vector of unknowns.
+         */
+        template <typename F> CMatrix refinementSolve(const F& factor);
 };
 
 #include "../src/CLinearSystem.cpp"
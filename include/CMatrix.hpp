@@ -50,6 +50,16 @@ class CMatrix {
         unsigned nCols;     /*!< @brief Number of columns.*/
         double* mtx;        /*!< @brief Pointer at the beginning of matrix entries.*/
 
+        static const unsigned nSmall = 8;   /*!< @brief Largest size factorized with buffers on the stack.*/
+
+        /*!
+         * @brief Change the dimensions of the matrix, allocating memory only
+         *        if the number of entries changes. Entries are not initialized.
+         * @param[in] rows - Number of rows.
+         * @param[in] cols - Number of columns.
+         */
+        void resize(const unsigned rows, const unsigned cols);
+
     public:
         /*!
          * @brief Constructor of the class.
@@ -70,6 +80,13 @@ class CMatrix {
          */
         CMatrix(const CMatrix& rhs);
 
+        /*!
+         * @brief Move constructor of the class. The entries of rhs are taken
+         *        without copying and rhs is left empty.
+         * @param[in] rhs - Matrix to move.
+         */
+        CMatrix(CMatrix&& rhs);
+
         /*!
          * @brief Destructor of the class.
          */
@@ -96,13 +113,13 @@ class CMatrix {
          * @brief Covert to symmetric storage.
          * @return Matrix with symmetric storage.
          */
-        CMatrixSymmetric toSymmetricStorage();
+        CMatrixSymmetric toSymmetricStorage() const;
 
         /*!
          * @brief Compute the transpose.
          * @return Transpose of the matrix.
          */
-        CMatrix transpose();
+        CMatrix transpose() const;
 
         /*!
          * @brief Get the pointer at the beginning of the entries.
@@ -124,13 +141,43 @@ class CMatrix {
          * @brief Compute the determinant of the matrix.
          * @return Determinant.
          */
-        double determinant();
+        double determinant() const;
 
         /*!
          * @brief Compute the inverse of the matrix.
          * @return Inverse matrix.
          */
-        CMatrix inverse();
+        CMatrix inverse() const;
+
+        /*!
+         * @brief Compute the inverse of the matrix into an existing matrix,
+         *        reusing its memory if it has the right size.
+         * @param[out] res - Inverse matrix.
+         */
+        void inverse(CMatrix& res) const;
+
+        /*!
+         * @brief Compute the product of two matrices into the current matrix,
+         *        this = alpha*lhs*rhs, reusing its memory if it has the right
+         *        size.
+         * @param[in] lhs - LHS matrix of the product.
+         * @param[in] rhs - RHS matrix of the product.
+         * @param[in] alpha - Constant multiplying the product.
+         * @return Matrix with the product.
+         */
+        CMatrix& setProduct(const CMatrix& lhs, const CMatrix& rhs,
+                            const double alpha = 1.0);
+
+        /*!
+         * @brief Accumulate the product of the transpose of a matrix with
+         *        another one, this += alpha*lhs'*rhs, without temporaries.
+         * @param[in] lhs - LHS matrix of the product, used transposed.
+         * @param[in] rhs - RHS matrix of the product.
+         * @param[in] alpha - Constant multiplying the product.
+         * @return Matrix with the accumulated product.
+         */
+        CMatrix& addTransposeProduct(const CMatrix& lhs, const CMatrix& rhs,
+                                     const double alpha = 1.0);
 
         /*!
          * @brief Operator overloading of parenthesis to access entries.
@@ -155,12 +202,20 @@ class CMatrix {
          */
         CMatrix& operator=(const CMatrix& rhs);
 
+        /*!
+         * @brief Operator overloading of equal sign to move a matrix. The
+         *        entries of rhs are taken without copying and rhs is left empty.
+         * @param[in] rhs - RHS matrix to move.
+         * @return Matrix with the entries of rhs.
+         */
+        CMatrix& operator=(CMatrix&& rhs);
+
         /*!
          * @brief Operator overloading of plus sign to sum matrices.
          * @param[in] rhs - RHS matrix to sum.
          * @return Matrix with summed entries.
          */
-        CMatrix operator+(const CMatrix& rhs);
+        CMatrix operator+(const CMatrix& rhs) const;
 
         /*!
          * @brief Operator overloading of plus-equal sign to sum matrices.
@@ -174,7 +229,7 @@ class CMatrix {
          * @param[in] rhs - RHS matrix to substract.
          * @return Matrix with substracted entries.
          */
-        CMatrix operator-(const CMatrix& rhs);
+        CMatrix operator-(const CMatrix& rhs) const;
 
         /*!
          * @brief Operator overloading of minus-equal sign to substract matrices.
@@ -188,7 +243,7 @@ class CMatrix {
          * @param[in] rhs - RHS matrix to multiply.
          * @return Product of the two matrices.
          */
-        CMatrix operator*(const CMatrix& rhs);
+        CMatrix operator*(const CMatrix& rhs) const;
 
         /*!
          * @brief Operator overloading of asterisk-equal sign to multiply matrices.
@@ -197,12 +252,20 @@ class CMatrix {
          */
         CMatrix& operator*=(const CMatrix& rhs);
 
+        /*!
+         * @brief Operator overloading of asterisk-equal sign to multiply a
+         *        matrix with a constant in place.
+         * @param[in] rhs - RHS constant to multiply.
+         * @return Matrix with the constant multiplied.
+         */
+        CMatrix& operator*=(const double& rhs);
+
         /*!
          * @brief Operator overloading of plus sign to sum a constant to a matrix.
          * @param[in] rhs - RHS constant to sum.
          * @return Matrix with the constant summed.
          */
-        CMatrix operator+(const double& rhs);
+        CMatrix operator+(const double& rhs) const;
 
         /*!
          * @brief Operator overloading of minus sign to substract a constant from
@@ -210,7 +273,7 @@ class CMatrix {
          * @param[in] rhs - RHS constant to substract.
          * @return Matrix with the constant substracted.
          */
-        CMatrix operator-(const double& rhs);
+        CMatrix operator-(const double& rhs) const;
 
         /*!
          * @brief Operator overloading of asterisk sign to multiply a constant
@@ -218,7 +281,7 @@ class CMatrix {
          * @param[in] rhs - RHS constant to multiply.
          * @return Matrix with the constant multiplied.
          */
-        CMatrix operator*(const double& rhs);
+        CMatrix operator*(const double& rhs) const;
 
         /*!
          * @brief Operator overloading of slash sign to divide a constant with
@@ -226,7 +289,7 @@ class CMatrix {
          * @param[in] rhs - RHS constant to divide.
          * @return Matrix with the constant divided.
          */
-        CMatrix operator/(const double& rhs);
+        CMatrix operator/(const double& rhs) const;
 
         /*!
          * @brief Operator overloading of power sign to take the power of each
@@ -234,7 +297,7 @@ class CMatrix {
          * @param[in] rhs - RHS constant to take the power.
          * @return Matrix with each entry to the power of the constant.
          */
-        CMatrix operator^(const double& rhs);
+        CMatrix operator^(const double& rhs) const;
 };
 
 #endif
@@ -0,0 +1,127 @@
+/*!
+ * @file CMatrixBanded.hpp
+ * @brief Headers of the main subroutines for defining symmetric band matrices
+ *        and their operations.
+ *        The implementation is in the <i>CMatrixBanded.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXBANDED_HPP
+#define __CMATRIXBANDED_HPP
+
+/*!
+ * @class CMatrixBanded
+ * @brief Class to define symmetric band matrices. Only the diagonal and the
+ *        nBands subdiagonals are stored, column by column, with the LAPACK
+ *        lower band storage: entry (i, j) with j <= i <= j+nBands is at
+ *        mtx[j*(nBands+1)+i-j].
+ */
+class CMatrixBanded {
+    private:
+        unsigned nRows;     /*!< @brief Number of rows.*/
+        unsigned nCols;     /*!< @brief Number of columns.*/
+        unsigned nBands;    /*!< @brief Number of subdiagonals, or half-bandwidth.*/
+        double* mtx;        /*!< @brief Pointer at the beginning of matrix entries.*/
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixBanded();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] size - Number of rows and columns.
+         * @param[in] bands - Number of subdiagonals.
+         * @param[in] initValue - Initial value to populate the band.
+         */
+        CMatrixBanded(unsigned size, unsigned bands, const double initValue);
+
+        /*!
+         * @brief Copy constructor of the class.
+         * @param[in] rhs - Matrix to copy.
+         */
+        CMatrixBanded(const CMatrixBanded& rhs);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixBanded();
+
+        /*!
+         * @brief Get number of rows.
+         * @return Number of rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns.
+         * @return Number of columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Get number of subdiagonals.
+         * @return Number of subdiagonals.
+         */
+        unsigned getNBands() const;
+
+        /*!
+         * @brief Print matrix to the console.
+         */
+        void printMtx();
+
+        /*!
+         * @brief Get the pointer at the beginning of the entries.
+         * @return Pointer at the beginning of the entries.
+         */
+        double* getMtxAddress() const;
+
+        /*!
+         * @brief Operator overloading of parenthesis to access entries inside
+         *        the band.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        double& operator()(const unsigned i, const unsigned j);
+
+        /*!
+         * @brief Operator overloading of parenthesis to read entries. Entries
+         *        outside the band are zero.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        double operator()(const unsigned i, const unsigned j) const;
+
+        /*!
+         * @brief Operator overloading of equal sign.
+         * @param[in] rhs - RHS matrix to copy.
+         * @return Matrix with copied entries from rhs.
+         */
+        CMatrixBanded& operator=(const CMatrixBanded& rhs);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*!
+ * @file CMatrixCompressedRow.hpp
+ * @brief Headers of the storage in compressed sparse row (CSR) format shared
+ *        by the general and the symmetric sparse matrices.
+ *        The implementation is in the <i>CMatrixCompressedRow.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXCOMPRESSEDROW_HPP
+#define __CMATRIXCOMPRESSEDROW_HPP
+
+/*!
+ * @class CMatrixCompressedRow
+ * @brief Class to define the storage of sparse matrices in compressed sparse
+ *        row format. The sparsity pattern is fixed at construction and only
+ *        the values of the stored entries can be modified afterwards. The
+ *        derived classes define which entries of the matrix are stored.
+ */
+class CMatrixCompressedRow {
+    protected:
+        unsigned nRows;     /*!< @brief Number of rows.*/
+        unsigned nCols;     /*!< @brief Number of columns.*/
+        unsigned nNonZero;  /*!< @brief Number of stored entries.*/
+        unsigned* rowPtr;   /*!< @brief Position of the first entry of every row, with nRows+1 entries.*/
+        unsigned* colIdx;   /*!< @brief Column of every stored entry, sorted within each row.*/
+        double* mtx;        /*!< @brief Pointer at the beginning of matrix entries.*/
+
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixCompressedRow();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] rows - Number of rows.
+         * @param[in] cols - Number of columns.
+         * @param[in] rowPtrs - Position of the first entry of every row, with
+         *                      rows+1 entries.
+         * @param[in] colIdxs - Column of every entry, sorted within each row.
+         * @param[in] initValue - Initial value to populate the stored entries.
+         */
+        CMatrixCompressedRow(unsigned rows, unsigned cols,
+                             const unsigned* rowPtrs, const unsigned* colIdxs,
+                             const double initValue);
+
+        /*!
+         * @brief Copy constructor of the class.
+         * @param[in] rhs - Matrix to copy.
+         */
+        CMatrixCompressedRow(const CMatrixCompressedRow& rhs);
+
+        /*!
+         * @brief Copy the pattern and the entries of another matrix, used by
+         *        the assignment of the derived classes.
+         * @param[in] rhs - Matrix to copy.
+         */
+        void copy(const CMatrixCompressedRow& rhs);
+
+        /*!
+         * @brief Find the position of a stored entry of a row.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Position of the entry, or -1 if it is not stored.
+         */
+        int findInRow(const unsigned i, const unsigned j) const;
+
+    public:
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixCompressedRow();
+
+        /*!
+         * @brief Get number of rows.
+         * @return Number of rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns.
+         * @return Number of columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Get number of stored entries.
+         * @return Number of stored entries.
+         */
+        unsigned getNNonZero() const;
+
+        /*!
+         * @brief Print matrix to the console.
+         */
+        void printMtx();
+
+        /*!
+         * @brief Get the pointer at the beginning of the row pointers.
+         * @return Pointer at the beginning of the row pointers.
+         */
+        unsigned* getRowPtrAddress() const;
+
+        /*!
+         * @brief Get the pointer at the beginning of the column indices.
+         * @return Pointer at the beginning of the column indices.
+         */
+        unsigned* getColIdxAddress() const;
+
+        /*!
+         * @brief Get the pointer at the beginning of the entries.
+         * @return Pointer at the beginning of the entries.
+         */
+        double* getMtxAddress() const;
+
+        /*!
+         * @brief Find the position of an entry in the stored entries.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Position of the entry, or -1 if it is not stored.
+         */
+        virtual int findEntry(const unsigned i, const unsigned j) const;
+
+        /*!
+         * @brief Add a value to a stored entry.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @param[in] val - Value to add.
+         */
+        void addEntry(const unsigned i, const unsigned j, const double val);
+
+        /*!
+         * @brief Operator overloading of parenthesis to read entries. Entries
+         *        outside the sparsity pattern are zero.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        double operator()(const unsigned i, const unsigned j) const;
+};
+
+#endif
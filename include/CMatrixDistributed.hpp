@@ -0,0 +1,193 @@
+/*!
+ * @file CMatrixDistributed.hpp
+ * @brief Headers of the main subroutines for defining sparse matrices whose
+ *        rows are distributed among the MPI ranks.
+ *        The implementation is in the <i>CMatrixDistributed.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXDISTRIBUTED_HPP
+#define __CMATRIXDISTRIBUTED_HPP
+
+#include <vector>
+
+#include "CMatrix.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+
+/*!
+ * @class CMatrixDistributed
+ * @brief Class to define a symmetric sparse matrix distributed by blocks of
+ *        consecutive rows among the MPI ranks. Every rank stores its rows in
+ *        compressed sparse row format, with the owned columns first and the
+ *        columns owned by other ranks (ghosts) after them. The vectors only
+ *        hold the owned rows, and the product exchanges the ghost entries
+ *        with the neighbour ranks.
+ */
+class CMatrixDistributed {
+    private:
+        unsigned nGlobal;                    /*!< @brief Number of rows of the global matrix.*/
+        unsigned nLocal;                     /*!< @brief Number of rows owned by the rank.*/
+        unsigned firstRow;                   /*!< @brief First global row owned by the rank.*/
+        std::vector<unsigned> rowOffsets;    /*!< @brief First global row of every rank, with nRanks+1 entries.*/
+        std::vector<unsigned> rowPtr;        /*!< @brief Position of the first entry of every owned row.*/
+        std::vector<unsigned> colIdx;        /*!< @brief Local column of every stored entry.*/
+        std::vector<double> mtx;             /*!< @brief Stored entries.*/
+        std::vector<unsigned> ghostRows;     /*!< @brief Global row of every ghost column.*/
+        std::vector<unsigned> interiorRows;  /*!< @brief Owned rows without ghost columns.*/
+        std::vector<unsigned> boundaryRows;  /*!< @brief Owned rows with ghost columns.*/
+        std::vector<int> neighbours;         /*!< @brief Ranks that share ghost entries with the rank.*/
+        std::vector<unsigned> recvPtr;       /*!< @brief First ghost received from every neighbour.*/
+        std::vector<unsigned> sendPtr;       /*!< @brief First entry of sendIdx for every neighbour.*/
+        std::vector<unsigned> sendIdx;       /*!< @brief Owned rows sent to the neighbours.*/
+        mutable std::vector<double> xExt;    /*!< @brief Owned and ghost entries of the vector to multiply.*/
+        mutable std::vector<double> sendBuf; /*!< @brief Entries sent to the neighbours.*/
+
+        /*!
+         * @brief Blocks of consecutive rows of nearly the same size.
+         * @param[in] n - Number of rows.
+         * @return First row of every rank, with nRanks+1 entries.
+         */
+        static std::vector<unsigned> balancedOffsets(const unsigned n);
+
+        /*!
+         * @brief Lower triangle of the rows of a rank.
+         * @param[in] A - Symmetric sparse matrix.
+         * @param[in] offsets - First row of every rank, with nRanks+1 entries.
+         * @return Lower triangle of the rows of the rank, with global columns.
+         */
+        static CMatrixSparse ownedRows(const CMatrixSparseSymmetric& A,
+                                       const std::vector<unsigned>& offsets);
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixDistributed();
+
+        /*!
+         * @brief Constructor of the class. Every rank keeps the rows of its
+         *        block of the matrix, which is replicated in all the ranks.
+         * @param[in] A - Symmetric sparse matrix.
+         */
+        CMatrixDistributed(const CMatrixSparseSymmetric& A);
+
+        /*!
+         * @brief Constructor of the class. Every rank keeps the rows given by
+         *        the offsets, and only they have to be complete in its copy
+         *        of the matrix.
+         * @param[in] A - Symmetric sparse matrix.
+         * @param[in] offsets - First row of every rank, with nRanks+1 entries.
+         */
+        CMatrixDistributed(const CMatrixSparseSymmetric& A,
+                           const std::vector<unsigned>& offsets);
+
+        /*!
+         * @brief Constructor of the class from the rows of every rank, as left
+         *        by the distributed assembly, without the whole matrix in any
+         *        rank. The entries of the upper triangle of the owned rows are
+         *        received from the owners of the next rows.
+         * @param[in] lower - Lower triangle of the rows of the rank, with
+         *                    global columns.
+         * @param[in] offsets - First row of every rank, with nRanks+1 entries.
+         */
+        CMatrixDistributed(const CMatrixSparse& lower,
+                           const std::vector<unsigned>& offsets);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixDistributed();
+
+        /*!
+         * @brief Get number of rows owned by the rank.
+         * @return Number of owned rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns owned by the rank, which are the same
+         *        as the owned rows.
+         * @return Number of owned columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Get number of rows of the global matrix.
+         * @return Number of global rows.
+         */
+        unsigned getGlobalRows() const;
+
+        /*!
+         * @brief Get the first global row owned by the rank.
+         * @return First owned row.
+         */
+        unsigned getFirstRow() const;
+
+        /*!
+         * @brief Get number of ghost entries received in every product.
+         * @return Number of ghost entries.
+         */
+        unsigned getNGhosts() const;
+
+        /*!
+         * @brief Get number of neighbour ranks.
+         * @return Number of neighbour ranks.
+         */
+        unsigned getNNeighbours() const;
+
+        /*!
+         * @brief Get the block of the owned rows and columns, to build the
+         *        preconditioners of the rank.
+         * @return Diagonal block in symmetric sparse storage.
+         */
+        CMatrixSparseSymmetric getDiagonalBlock() const;
+
+        /*!
+         * @brief Get the owned rows of a vector replicated in every rank.
+         * @param[in] v - Global vector.
+         * @return Owned block of the vector.
+         */
+        CMatrix getLocalVector(const CMatrix& v) const;
+
+        /*!
+         * @brief Gather the owned blocks of all the ranks in a global vector.
+         * @param[in] v - Owned block of the vector.
+         * @return Global vector, replicated in every rank.
+         */
+        CMatrix gatherVector(const CMatrix& v) const;
+
+        /*!
+         * @brief Product y = alpha*A*x + beta*y of the owned rows. The rows
+         *        without ghosts are computed while the ghosts are exchanged.
+         * @param[in] x - Owned block of the vector to multiply.
+         * @param[in,out] y - Owned block of the vector with the result.
+         * @param[in] alpha - Scalar multiplying A*x.
+         * @param[in] beta - Scalar multiplying y.
+         */
+        void multiply(const double* x, double* y, double alpha,
+                      double beta) const;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*!
+ * @file CMatrixFixed.hpp
+ * @brief Headers of the main subroutines for defining small matrices with
+ *        the size fixed at compile time and their operations.
+ *        The implementation is in the <i>CMatrixFixed.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXFIXED_HPP
+#define __CMATRIXFIXED_HPP
+
+/*!
+ * @class CMatrixFixed
+ * @brief Class to define small matrices with the number of rows and columns
+ *        fixed at compile time. The entries are stored column by column inside
+ *        the object, so no memory is allocated and the loops of the operations
+ *        have constant bounds. Used for the elemental matrices.
+ */
+template <unsigned R, unsigned C> class CMatrixFixed {
+    private:
+        double mtx[R*C];    /*!< @brief Matrix entries.*/
+
+    public:
+        /*!
+         * @brief Constructor of the class, with zero entries.
+         */
+        CMatrixFixed();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] initValue - Initial value to populate matrix.
+         */
+        explicit CMatrixFixed(const double initValue);
+
+        /*!
+         * @brief Get number of rows.
+         * @return Number of rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns.
+         * @return Number of columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Get the pointer at the beginning of the entries.
+         * @return Pointer at the beginning of the entries.
+         */
+        double* getMtxAddress();
+
+        /*!
+         * @brief Compute the transpose.
+         * @return Transpose of the matrix.
+         */
+        CMatrixFixed<C, R> transpose() const;
+
+        /*!
+         * @brief Compute the determinant in closed form, for matrices up to
+         *        3x3.
+         * @return Determinant.
+         */
+        double determinant() const;
+
+        /*!
+         * @brief Compute the inverse in closed form, for matrices up to 3x3.
+         * @return Inverse matrix.
+         */
+        CMatrixFixed<R, C> inverse() const;
+
+        /*!
+         * @brief Operator overloading of parenthesis to access entries.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        double& operator()(const unsigned i, const unsigned j);
+
+        /*!
+         * @brief Operator overloading of parenthesis to access entries.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        const double& operator()(const unsigned i, const unsigned j) const;
+
+        /*!
+         * @brief Operator overloading of plus sign to sum matrices.
+         * @param[in] rhs - RHS matrix to sum.
+         * @return Matrix with summed entries.
+         */
+        CMatrixFixed<R, C> operator+(const CMatrixFixed<R, C>& rhs) const;
+
+        /*!
+         * @brief Operator overloading of plus-equal sign to sum matrices.
+         * @param[in] rhs - RHS matrix to sum.
+         * @return Matrix with summed entries.
+         */
+        CMatrixFixed<R, C>& operator+=(const CMatrixFixed<R, C>& rhs);
+
+        /*!
+         * @brief Operator overloading of minus sign to substract matrices.
+         * @param[in] rhs - RHS matrix to substract.
+         * @return Matrix with substracted entries.
+         */
+        CMatrixFixed<R, C> operator-(const CMatrixFixed<R, C>& rhs) const;
+
+        /*!
+         * @brief Operator overloading of asterisk sign to multiply matrices.
+         * @param[in] rhs - RHS matrix to multiply.
+         * @return Product of the two matrices.
+         */
+        template <unsigned K>
+        CMatrixFixed<R, K> operator*(const CMatrixFixed<C, K>& rhs) const;
+
+        /*!
+         * @brief Operator overloading of asterisk sign to multiply a constant
+         *        with a matrix.
+         * @param[in] rhs - RHS constant to multiply.
+         * @return Matrix with the constant multiplied.
+         */
+        CMatrixFixed<R, C> operator*(const double& rhs) const;
+
+        /*!
+         * @brief Operator overloading of asterisk-equal sign to multiply a
+         *        matrix with a constant.
+         * @param[in] rhs - RHS constant to multiply.
+         * @return Matrix with the constant multiplied.
+         */
+        CMatrixFixed<R, C>& operator*=(const double& rhs);
+};
+
+#include "../src/CMatrixFixed.cpp"
+
+#endif
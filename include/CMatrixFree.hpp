@@ -0,0 +1,126 @@
+/*!
+ * @file CMatrixFree.hpp
+ * @brief Headers of the main subroutines for applying the conductance matrix
+ *        element by element, without assembling it.
+ *        The implementation is in the <i>CMatrixFree.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXFREE_HPP
+#define __CMATRIXFREE_HPP
+
+#include <vector>
+
+#include "CMatrix.hpp"
+#include "CConductance.hpp"
+#include "CMesh.hpp"
+#include "CBoundaryConditions.hpp"
+
+/*!
+ * @class CMatrixFree
+ * @brief Conductance matrix of the DOF at known fluxes, Kff, applied element by
+ *        element from the connectivity of the mesh. The elemental matrices are
+ *        computed once per group of elements with the same geometry, and
+ *        every rank applies the elements of its strip of the plate.
+ */
+class CMatrixFree {
+    private:
+        unsigned nRows;                     /*!< @brief Number of rows, DOF at known fluxes.*/
+        unsigned nDof;                      /*!< @brief Total number of DOF.*/
+        unsigned nNodPerEl;                 /*!< @brief Number of nodes per element.*/
+        unsigned initEl;                    /*!< @brief First element of this rank.*/
+        unsigned finaEl;                    /*!< @brief Element after the last one of this rank.*/
+        std::vector<unsigned> elemDof;      /*!< @brief Global DOF of the nodes of every element of this rank.*/
+        std::vector<unsigned> elClass;      /*!< @brief Group of every element of this rank.*/
+        std::vector<double> classKe;        /*!< @brief Conductance matrix of every group, stored column by column.*/
+        std::vector<int> dofPos;            /*!< @brief Row of every global DOF, -1 at known temperatures.*/
+
+        /*!
+         * @brief Global product, y = K*x, summed over the ranks.
+         * @param[in] x - Vector to multiply, indexed by global DOF.
+         * @param[out] y - Product, indexed by global DOF.
+         */
+        void globalMul(const double* x, double* y) const;
+
+        /*!
+         * @brief Add the products of the elements of this rank with N nodes,
+         *        y += K*x.
+         * @param[in] x - Vector to multiply, indexed by global DOF.
+         * @param[in,out] y - Product, indexed by global DOF.
+         */
+        template <unsigned N>
+        void elementMul(const double* x, double* y) const;
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixFree();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] cnd - Conductance with geometry, material and quadrature.
+         * @param[in] msh - Mesh.
+         * @param[in] bnd - Boundary conditions.
+         */
+        CMatrixFree(const CConductance& cnd, const CMesh& msh,
+                    const CBoundaryConditions& bnd);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixFree();
+
+        /*!
+         * @brief Get number of rows.
+         * @return Number of rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns.
+         * @return Number of columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Product with the conductance matrix of the DOF at known
+         *        fluxes, y = alpha*Kff*x + beta*y.
+         * @param[in] x - Vector to multiply.
+         * @param[in,out] y - Result vector.
+         * @param[in] alpha - Constant multiplying the product.
+         * @param[in] beta - Constant multiplying y.
+         */
+        void multiply(const double* x, double* y, const double alpha,
+                      const double beta) const;
+
+        /*!
+         * @brief Product with the global conductance matrix, K*T.
+         * @param[in] T - Global temperature vector.
+         * @return Global flux vector.
+         */
+        CMatrix globalProduct(const CMatrix& T) const;
+};
+
+#endif
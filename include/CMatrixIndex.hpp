@@ -0,0 +1,103 @@
+/*!
+ * @file CMatrixIndex.hpp
+ * @brief Headers of the main subroutines for defining matrices of indices,
+ *        used for the topology of the mesh and the lists of nodes and DOF.
+ *        The implementation is in the <i>CMatrixIndex.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXINDEX_HPP
+#define __CMATRIXINDEX_HPP
+
+#include <vector>
+
+/*!
+ * @class CMatrixIndex
+ * @brief Class to define matrices of unsigned integer indices. The entries are
+ *        stored row by row, so the nodes of an element or the DOF of a node
+ *        are contiguous, and they are read without conversion from floating
+ *        point.
+ */
+class CMatrixIndex {
+    private:
+        unsigned nRows;             /*!< @brief Number of rows.*/
+        unsigned nCols;             /*!< @brief Number of columns.*/
+        std::vector<unsigned> mtx;  /*!< @brief Matrix entries, row by row.*/
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixIndex();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] rows - Number of rows.
+         * @param[in] cols - Number of columns.
+         * @param[in] initValue - Initial value to populate matrix.
+         */
+        CMatrixIndex(unsigned rows, unsigned cols, const unsigned initValue);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixIndex();
+
+        /*!
+         * @brief Get number of rows.
+         * @return Number of rows.
+         */
+        unsigned getRows() const;
+
+        /*!
+         * @brief Get number of columns.
+         * @return Number of columns.
+         */
+        unsigned getCols() const;
+
+        /*!
+         * @brief Get the pointer at the beginning of a row.
+         * @param[in] i - Row number.
+         * @return Pointer at the first entry of the row.
+         */
+        const unsigned* getRowAddress(const unsigned i) const;
+
+        /*!
+         * @brief Operator overloading of parenthesis to access entries.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        unsigned& operator()(const unsigned i, const unsigned j);
+
+        /*!
+         * @brief Operator overloading of parenthesis to read entries.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Entry of the matrix at row i and column j.
+         */
+        const unsigned& operator()(const unsigned i, const unsigned j) const;
+};
+
+#endif
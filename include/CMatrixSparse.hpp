@@ -0,0 +1,116 @@
+/*!
+ * @file CMatrixSparse.hpp
+ * @brief Headers of the main subroutines for defining sparse matrices in
+ *        compressed sparse row (CSR) format and their operations.
+ *        The implementation is in the <i>CMatrixSparse.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXSPARSE_HPP
+#define __CMATRIXSPARSE_HPP
+
+#include "CMatrix.hpp"
+#include "CMatrixCompressedRow.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+
+/*!
+ * @class CMatrixSparse
+ * @brief Class to define sparse matrices stored in compressed sparse row
+ *        format, with all the entries of the sparsity pattern stored.
+ */
+class CMatrixSparse : public CMatrixCompressedRow {
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixSparse();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] rows - Number of rows.
+         * @param[in] cols - Number of columns.
+         * @param[in] rowPtrs - Position of the first entry of every row, with
+         *                      rows+1 entries.
+         * @param[in] colIdxs - Column of every entry, sorted within each row.
+         * @param[in] initValue - Initial value to populate the stored entries.
+         */
+        CMatrixSparse(unsigned rows, unsigned cols, const unsigned* rowPtrs,
+                      const unsigned* colIdxs, const double initValue);
+
+        /*!
+         * @brief Copy constructor of the class.
+         * @param[in] rhs - Matrix to copy.
+         */
+        CMatrixSparse(const CMatrixSparse& rhs);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixSparse();
+
+        /*!
+         * @brief Covert to symmetric storage keeping the lower triangle.
+         * @return Matrix with symmetric storage.
+         */
+        CMatrixSparseSymmetric toSymmetricStorage() const;
+
+        /*!
+         * @brief Transpose matrix.
+         * @return Transposed matrix.
+         */
+        CMatrixSparse transpose() const;
+
+        /*!
+         * @brief Operator overloading of equal sign.
+         * @param[in] rhs - RHS matrix to copy.
+         * @return Matrix with copied entries from rhs.
+         */
+        CMatrixSparse& operator=(const CMatrixSparse& rhs);
+
+        /*!
+         * @brief Operator overloading of plus-equal sign to sum matrices with
+         *        the same sparsity pattern.
+         * @param[in] rhs - RHS matrix to sum.
+         * @return Matrix with summed entries.
+         */
+        CMatrixSparse& operator+=(const CMatrixSparse& rhs);
+
+        /*!
+         * @brief Operator overloading of asterisk sign to multiply with a dense
+         *        matrix.
+         * @param[in] rhs - RHS dense matrix to multiply.
+         * @return Product of the two matrices.
+         */
+        CMatrix operator*(const CMatrix& rhs) const;
+
+        /*!
+         * @brief Operator overloading of asterisk sign to multiply with a sparse
+         *        matrix. The pattern of the product is computed row by row.
+         * @param[in] rhs - RHS sparse matrix to multiply.
+         * @return Product of the two matrices.
+         */
+        CMatrixSparse operator*(const CMatrixSparse& rhs) const;
+};
+
+#endif
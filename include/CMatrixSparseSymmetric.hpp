@@ -0,0 +1,97 @@
+/*!
+ * @file CMatrixSparseSymmetric.hpp
+ * @brief Headers of the main subroutines for defining symmetric sparse matrices
+ *        in compressed sparse row (CSR) format and their operations.
+ *        The implementation is in the <i>CMatrixSparseSymmetric.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXSPARSESYMMETRIC_HPP
+#define __CMATRIXSPARSESYMMETRIC_HPP
+
+#include "CMatrixCompressedRow.hpp"
+
+class CMatrixSparse;
+
+/*!
+ * @class CMatrixSparseSymmetric
+ * @brief Class to define symmetric sparse matrices. Only the lower triangle
+ *        (column less or equal than row) is stored in compressed sparse row
+ *        format.
+ */
+class CMatrixSparseSymmetric : public CMatrixCompressedRow {
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CMatrixSparseSymmetric();
+
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] rows - Number of rows.
+         * @param[in] cols - Number of columns.
+         * @param[in] rowPtrs - Position of the first entry of every row, with
+         *                      rows+1 entries.
+         * @param[in] colIdxs - Column of every entry of the lower triangle,
+         *                      sorted within each row.
+         * @param[in] initValue - Initial value to populate the stored entries.
+         */
+        CMatrixSparseSymmetric(unsigned rows, unsigned cols, const unsigned* rowPtrs,
+                      const unsigned* colIdxs, const double initValue);
+
+        /*!
+         * @brief Copy constructor of the class.
+         * @param[in] rhs - Matrix to copy.
+         */
+        CMatrixSparseSymmetric(const CMatrixSparseSymmetric& rhs);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMatrixSparseSymmetric();
+
+        /*!
+         * @brief Covert to general storage with both triangles.
+         * @return Matrix with general storage.
+         */
+        CMatrixSparse toGeneralStorage() const;
+
+        /*!
+         * @brief Find the position of an entry in the stored entries. Entries
+         *        of the upper triangle are found in the lower one.
+         * @param[in] i - Row number.
+         * @param[in] j - Column number.
+         * @return Position of the entry, or -1 if it is not stored.
+         */
+        virtual int findEntry(const unsigned i, const unsigned j) const;
+
+        /*!
+         * @brief Operator overloading of equal sign.
+         * @param[in] rhs - RHS matrix to copy.
+         * @return Matrix with copied entries from rhs.
+         */
+        CMatrixSparseSymmetric& operator=(const CMatrixSparseSymmetric& rhs);
+};
+
+#endif
@@ -40,13 +40,15 @@ extern "C" {
 
 /*!
  * @class CMatrixSymmetric
- * @brief Class to define symmetric matrices and their operations.
+ * @brief Class to define symmetric matrices and their operations. Only the
+ *        lower triangle is stored, packed column by column as in the LAPACK
+ *        packed routines.
  */
 class CMatrixSymmetric {
     private:
         unsigned nRows;     /*!< @brief Number of rows.*/
         unsigned nCols;     /*!< @brief Number of columns.*/
-        double* mtx;        /*!< @brief Pointer at the beginning of matrix entries.*/
+        double* mtx;        /*!< @brief Pointer at the beginning of the packed lower triangle.*/
 
     public:
         /*!
@@ -68,6 +70,13 @@ class CMatrixSymmetric {
          */
         CMatrixSymmetric(const CMatrixSymmetric& rhs);
 
+        /*!
+         * @brief Move constructor of the class. The entries of rhs are taken
+         *        without copying and rhs is left empty.
+         * @param[in] rhs - Matrix to move.
+         */
+        CMatrixSymmetric(CMatrixSymmetric&& rhs);
+
         /*!
          * @brief Destructor of the class.
          */
@@ -85,6 +94,13 @@ class CMatrixSymmetric {
          */
         unsigned getCols() const;
 
+        /*!
+         * @brief Get number of stored entries, nRows*(nRows+1)/2 for a
+         *        square matrix.
+         * @return Number of stored entries.
+         */
+        unsigned getNEntries() const;
+
         /*!
          * @brief Print matrix to the console.
          */
@@ -119,12 +135,20 @@ class CMatrixSymmetric {
          */
         CMatrixSymmetric& operator=(const CMatrixSymmetric& rhs);
 
+        /*!
+         * @brief Operator overloading of equal sign to move a matrix. The
+         *        entries of rhs are taken without copying and rhs is left empty.
+         * @param[in] rhs - RHS matrix to move.
+         * @return Matrix with the entries of rhs.
+         */
+        CMatrixSymmetric& operator=(CMatrixSymmetric&& rhs);
+
         /*!
          * @brief Operator overloading of plus sign to sum matrices.
          * @param[in] rhs - RHS matrix to sum.
          * @return Matrix with summed entries.
          */
-        CMatrixSymmetric operator+(const CMatrixSymmetric& rhs);
+        CMatrixSymmetric operator+(const CMatrixSymmetric& rhs) const;
 
         /*!
          * @brief Operator overloading of plus-equal sign to sum matrices.
@@ -29,7 +29,10 @@
 #ifndef __CMESH_HPP
 #define __CMESH_HPP
 
+#include <vector>
+
 #include "CMatrix.hpp"
+#include "CMatrixIndex.hpp"
 #include "CGeometry.hpp"
 
 /*!
@@ -43,13 +46,14 @@ class CMesh {
         unsigned nElem;             /*!< @brief Number of elements.*/
         unsigned nNode;             /*!< @brief Number of nodes.*/
         unsigned nNodePerElem;      /*!< @brief Number of nodes per element.*/
+        unsigned elemOrder;         /*!< @brief Polynomial order of the elements along their edges.*/
         unsigned dofPerNode;        /*!< @brief Number of DOF per node.*/
         unsigned totalDofInElem;    /*!< @brief Number of DOF in every element.*/
         unsigned nDofTotal;         /*!< @brief Number of DOF.*/
-        CMatrix coorMtx;            /*!< @brief Matrix of coordinates.*/
-        CMatrix topolMtx;           /*!< @brief Topology matrix to describe the node distribution.*/
-        CMatrix connMtx;            /*!< @brief Connectivity matrix.*/
-        CMatrix glDofMtx;           /*!< @brief Global DOF matrix.*/
+        CMatrix coorMtx;            /*!< @brief Matrix of coordinates, stored column by column, so all the x precede all the y.*/
+        CMatrixIndex topolMtx;      /*!< @brief Topology matrix to describe the node distribution.*/
+        CMatrixIndex connMtx;       /*!< @brief Connectivity matrix.*/
+        CMatrixIndex glDofMtx;      /*!< @brief Global DOF matrix.*/
 
         /*!
          * @brief Subroutine that builds the matrix of coordinates.
@@ -62,23 +66,38 @@ class CMesh {
          * @brief Subroutine that builds the topology matrix.
          * @return Topology matrix.
          */
-        CMatrix topologyMtx();
+        CMatrixIndex topologyMtx();
 
         /*!
          * @brief Subroutine that builds the connectivity matrix.
          * @param[in] topol - Topology matrix.
          * @return Connectivity matrix.
          */
-        CMatrix connectivityMtx(CMatrix topol);
+        CMatrixIndex connectivityMtx(const CMatrixIndex& topol);
 
         /*!
          * @brief Subroutine that builds the matrix of global DOF.
          * @param[in] conn - Connectivity matrix.
          * @return Matrix of global DOF.
          */
-        CMatrix globalDofMtx(CMatrix conn);
+        CMatrixIndex globalDofMtx(const CMatrixIndex& conn);
+
+        /*!
+         * @brief Recursive bisection of a block of the node grid. The two
+         *        halves are ordered before the line of nodes that separates them.
+         * @param[in] i0 - First row of nodes of the block.
+         * @param[in] i1 - Last row of nodes of the block.
+         * @param[in] j0 - First column of nodes of the block.
+         * @param[in] j1 - Last column of nodes of the block.
+         * @param[in,out] order - Nodes in elimination order.
+         */
+        void dissect(const unsigned i0, const unsigned i1,
+                     const unsigned j0, const unsigned j1,
+                     std::vector<unsigned>& order) const;
 
     public:
+        static const unsigned noNode = 0xFFFFFFFF;  /*!< @brief Topology entry of the points of the node grid without node.*/
+
         /*!
          * @brief Constructor of the class.
          */
@@ -89,8 +108,11 @@ class CMesh {
          * @param[in] NElx - Number of elements in the x direction.
          * @param[in] NEly - Number of elements in the y direction.
          * @param[in] geo - Geometry.
+         * @param[in] nodPerEl - Number of nodes per element, 4 (bilinear),
+         *                       8 (serendipity) or 9 (Lagrange).
          */
-        CMesh(const unsigned NElx, const unsigned NEly, const CGeometry geo);
+        CMesh(const unsigned NElx, const unsigned NEly, const CGeometry geo,
+              const unsigned nodPerEl = 4);
 
         /*!
          * @brief Destructor of the class.
@@ -127,6 +149,14 @@ class CMesh {
          */
         unsigned getNNodePerElem() const;
 
+        /*!
+         * @brief Get polynomial order of the elements, 1 for the bilinear
+         *        element and 2 for the quadratic ones. The node grid has this
+         *        number of intervals per element in every direction.
+         * @return Polynomial order of the elements.
+         */
+        unsigned getElemOrder() const;
+
         /*!
          * @brief Get number of DOF per node.
          * @return Number of DOF per node.
@@ -149,25 +179,53 @@ class CMesh {
          * @brief Get matrix of coordinates.
          * @return Matrix of coordinates.
          */
-        CMatrix getCoorMtx() const;
+        const CMatrix& getCoorMtx() const;
+
+        /*!
+         * @brief Get the x coordinates of the nodes, which are contiguous.
+         * @return Pointer at the x coordinate of the first node.
+         */
+        const double* getCoorX() const;
 
         /*!
-         * @brief Get the topology matrix.
+         * @brief Get the y coordinates of the nodes, which are contiguous.
+         * @return Pointer at the y coordinate of the first node.
+         */
+        const double* getCoorY() const;
+
+        /*!
+         * @brief Get the topology matrix, with the node of every point of the
+         *        node grid, or noNode if the point has no node.
          * @return Topology matrix.
          */
-        CMatrix getTopolMtx() const;
+        const CMatrixIndex& getTopolMtx() const;
 
         /*!
          * @brief Get the connectivity matrix.
          * @return Connectivity matrix.
          */
-        CMatrix getConnMtx() const;
+        const CMatrixIndex& getConnMtx() const;
 
         /*!
          * @brief Get the matrix of global DOF.
          * @return Matrix of global DOF.
          */
-        CMatrix getGlDofMtx() const;
+        const CMatrixIndex& getGlDofMtx() const;
+
+        /*!
+         * @brief Nested dissection ordering of the nodes, which reduces the
+         *        fill-in of the Cholesky factorization.
+         * @return Nodes in elimination order.
+         */
+        std::vector<unsigned> nestedDissection() const;
+
+        /*!
+         * @brief Split the elements in 4 colors, so the elements of a color do
+         *        not share nodes. Element (i, j) of the grid has color
+         *        (i%2)+2*(j%2).
+         * @return Elements of every color.
+         */
+        std::vector< std::vector<unsigned> > elementColors() const;
 };
 
 #endif
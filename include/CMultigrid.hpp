@@ -0,0 +1,184 @@
+/*!
+ * @file CMultigrid.hpp
+ * @brief Headers of the main subroutines for the geometric multigrid method.
+ *        The implementation is in the <i>CMultigrid.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMULTIGRID_HPP
+#define __CMULTIGRID_HPP
+
+#include <string>
+#include <vector>
+
+#include "CMatrix.hpp"
+#include "CMatrixSparse.hpp"
+#include "CMesh.hpp"
+#include "CConductance.hpp"
+#include "CBoundaryConditions.hpp"
+#include "CPreconditioner.hpp"
+
+/*!
+ * @class CMultigrid
+ * @brief Geometric multigrid method on the structured grid of CMesh. Coarse
+ *        levels halve the number of elements in the directions of strongest
+ *        coupling and their matrices are the Galerkin products P'*A*P.
+ *        Corrections are transferred with bilinear prolongation and its
+ *        transpose. It can be used as a solver or as a preconditioner of the
+ *        CG method.
+ */
+class CMultigrid : public CPreconditioner {
+    protected:
+        unsigned nLevels;                   /*!< @brief Number of levels, the finest one is 0.*/
+        unsigned nSmooth;                   /*!< @brief Number of Gauss-Seidel sweeps before and after the coarse correction.*/
+        unsigned nCoarseVisits;             /*!< @brief Visits to the coarse level per cycle, 1 for V-cycle and 2 for W-cycle.*/
+        unsigned nIterations;               /*!< @brief Number of cycles of the last solve.*/
+        std::vector<CMatrixSparse> lhs;     /*!< @brief Conductance submatrix at known fluxes of every level.*/
+        std::vector<CMatrixSparse> prolong; /*!< @brief Prolongation from level l+1 to level l.*/
+        CMatrix coarseFactor;               /*!< @brief Cholesky factor of the coarsest level, empty if it is too large.*/
+        unsigned maxDenseSize;              /*!< @brief Largest coarsest level factorized in dense storage.*/
+
+        /*!
+         * @brief Constructor of the class, used by derived classes that build
+         *        the levels themselves.
+         */
+        CMultigrid();
+
+        /*!
+         * @brief Set the number of visits to the coarse level per cycle.
+         * @param[in] cycleType - Cycle of the method, V or W.
+         */
+        void setCycleType(const std::string cycleType);
+
+        /*!
+         * @brief Cholesky factorization of the coarsest level. A level larger
+         *        than maxDenseSize is not factorized, and the cycle smooths it
+         *        instead of solving it exactly.
+         */
+        void factorizeCoarsest();
+
+        /*!
+         * @brief Gauss-Seidel sweep on a level.
+         * @param[in] l - Level.
+         * @param[in] b - RHS vector.
+         * @param[in,out] x - Approximate solution.
+         * @param[in] forward - Boolean to sweep the rows forward or backward.
+         */
+        void smooth(const unsigned l, const double* b, double* x,
+                    const bool forward) const;
+
+        /*!
+         * @brief Multigrid cycle on a level, improving the approximate solution.
+         * @param[in] l - Level.
+         * @param[in] b - RHS vector.
+         * @param[in,out] x - Approximate solution.
+         */
+        void cycle(const unsigned l, const double* b, double* x) const;
+
+    private:
+        /*!
+         * @brief Position of every DOF in the subvector of known fluxes.
+         * @param[in] bnd - Boundary conditions.
+         * @param[in] nDof - Number of DOF of the mesh.
+         * @return Position of every DOF, -1 if the temperature is known.
+         */
+        std::vector<int> freePositions(const CBoundaryConditions& bnd,
+                                       const unsigned nDof);
+
+        /*!
+         * @brief Conductance submatrix at known fluxes.
+         * @param[in] K - Conductance matrix.
+         * @param[in] pos - Position of every DOF in the subvector of known fluxes.
+         * @param[in] nFree - Number of DOF with known flux.
+         * @return Conductance submatrix at known fluxes.
+         */
+        CMatrixSparse freeMatrix(const CMatrixSparse& K,
+                                 const std::vector<int>& pos,
+                                 const unsigned nFree);
+
+        /*!
+         * @brief Bilinear prolongation between two levels. The interpolation is
+         *        done in the parametric coordinates of the plate, so it is also
+         *        valid when an odd number of elements is coarsened.
+         * @param[in] fine - Fine mesh.
+         * @param[in] coarse - Coarse mesh.
+         * @param[in] finePos - Position of the fine DOF with known flux.
+         * @param[in] coarsePos - Position of the coarse DOF with known flux.
+         * @param[in] nFine - Number of fine DOF with known flux.
+         * @param[in] nCoarse - Number of coarse DOF with known flux.
+         * @return Prolongation matrix.
+         */
+        CMatrixSparse prolongationMtx(const CMesh& fine, const CMesh& coarse,
+                                      const std::vector<int>& finePos,
+                                      const std::vector<int>& coarsePos,
+                                      const unsigned nFine,
+                                      const unsigned nCoarse);
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] cnd - Conductance of the finest level.
+         * @param[in] msh - Mesh of the finest level.
+         * @param[in] bnd - Boundary conditions of the finest level.
+         * @param[in] cycleType - Cycle of the method, V or W.
+         */
+        CMultigrid(const CConductance& cnd, const CMesh& msh,
+                   const CBoundaryConditions& bnd,
+                   const std::string cycleType = "V");
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CMultigrid();
+
+        /*!
+         * @brief Get number of levels.
+         * @return Number of levels.
+         */
+        unsigned getNLevels() const;
+
+        /*!
+         * @brief Get number of cycles of the last solve.
+         * @return Number of cycles.
+         */
+        unsigned getNIterations() const;
+
+        /*!
+         * @brief Apply one cycle with zero initial guess, z = inv(M)*r.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         */
+        void apply(const double* r, double* z) const;
+
+        /*!
+         * @brief Solve the system at known fluxes of the finest level repeating
+         *        cycles until convergence. Throws if the residual is not
+         *        finite or has not converged after 5000 cycles.
+         * @param[in] b - RHS vector.
+         * @return Solution vector.
+         */
+        CMatrix solve(const CMatrix& b);
+};
+
+#endif
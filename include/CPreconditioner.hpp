@@ -0,0 +1,168 @@
+/*!
+ * @file CPreconditioner.hpp
+ * @brief Headers of the main subroutines for preconditioning the CG method.
+ *        The implementation is in the <i>CPreconditioner.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CPRECONDITIONER_HPP
+#define __CPRECONDITIONER_HPP
+
+#include "CMatrix.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+
+/*!
+ * @class CPreconditioner
+ * @brief Interface of the preconditioners of the CG method. A preconditioner
+ *        approximates the inverse of the LHS matrix.
+ */
+class CPreconditioner {
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CPreconditioner();
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CPreconditioner();
+
+        /*!
+         * @brief Apply the preconditioner, z = inv(M)*r.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         */
+        virtual void apply(const double* r, double* z) const = 0;
+};
+
+/*!
+ * @class CPreconditionerJacobi
+ * @brief Diagonal (Jacobi) preconditioner.
+ */
+class CPreconditionerJacobi : public CPreconditioner {
+    private:
+        unsigned size;      /*!< @brief Size of the system.*/
+        CMatrix invDiag;    /*!< @brief Inverse of the diagonal of the matrix.*/
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] A - LHS matrix of the system.
+         */
+        CPreconditionerJacobi(const CMatrixSparseSymmetric& A);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CPreconditionerJacobi();
+
+        /*!
+         * @brief Apply the preconditioner, z = inv(D)*r.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         */
+        void apply(const double* r, double* z) const;
+};
+
+/*!
+ * @class CPreconditionerSSOR
+ * @brief Symmetric successive over-relaxation preconditioner,
+ *        M = w/(2-w) * (D/w + L) * inv(D/w) * (D/w + L)'.
+ */
+class CPreconditionerSSOR : public CPreconditioner {
+    private:
+        unsigned size;              /*!< @brief Size of the system.*/
+        double omega;               /*!< @brief Relaxation factor, between 0 and 2.*/
+        CMatrixSparseSymmetric A;   /*!< @brief LHS matrix of the system.*/
+        CMatrix diag;               /*!< @brief Diagonal of the matrix.*/
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] lhs - LHS matrix of the system.
+         * @param[in] w - Relaxation factor, between 0 and 2.
+         */
+        CPreconditionerSSOR(const CMatrixSparseSymmetric& lhs,
+                            const double w = 1.0);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CPreconditionerSSOR();
+
+        /*!
+         * @brief Apply the preconditioner with a forward and a backward sweep.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         */
+        void apply(const double* r, double* z) const;
+};
+
+/*!
+ * @class CPreconditionerIC0
+ * @brief Incomplete Cholesky preconditioner without fill-in, M = L*L', where
+ *        L keeps the sparsity pattern of the lower triangle of the matrix.
+ */
+class CPreconditionerIC0 : public CPreconditioner {
+    private:
+        unsigned size;              /*!< @brief Size of the system.*/
+        double shift;               /*!< @brief Relative diagonal shift used to avoid breakdown.*/
+        CMatrixSparseSymmetric L;   /*!< @brief Incomplete Cholesky factor, stored as a lower triangle.*/
+
+        /*!
+         * @brief Compute the incomplete factor of the shifted matrix.
+         * @param[in] A - LHS matrix of the system.
+         * @param[in] alpha - Relative diagonal shift.
+         * @return Boolean to know if all the pivots are positive.
+         */
+        bool factorize(const CMatrixSparseSymmetric& A, const double alpha);
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         * @param[in] A - LHS matrix of the system.
+         */
+        CPreconditionerIC0(const CMatrixSparseSymmetric& A);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CPreconditionerIC0();
+
+        /*!
+         * @brief Get the diagonal shift that was needed for the factorization.
+         * @return Relative diagonal shift.
+         */
+        double getShift() const;
+
+        /*!
+         * @brief Apply the preconditioner with two triangular solves.
+         * @param[in] r - Vector to precondition.
+         * @param[out] z - Preconditioned vector.
+         */
+        void apply(const double* r, double* z) const;
+};
+
+#endif
@@ -0,0 +1,173 @@
+/*!
+ * @file CShapeFunctions.hpp
+ * @brief Headers of the main subroutines for tabulating the shape functions
+ *        of the reference elements at the Gauss points.
+ *        The implementation is in the <i>CShapeFunctions.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CSHAPEFUNCTIONS_HPP
+#define __CSHAPEFUNCTIONS_HPP
+
+#include <vector>
+
+#include "CMatrix.hpp"
+
+/*!
+ * @class CShapeFunctions
+ * @brief Shape functions of the reference elements and their derivatives,
+ *        tabulated at the Gauss points of a quadrature order. They do not
+ *        depend on the element, so a single table per order is built the
+ *        first time it is requested and shared by all the element loops.
+ *        The quadrilaterals have 4 (bilinear), 8 (serendipity) or 9 (Lagrange)
+ *        nodes, and the line of the flux BC has the nodes of their edges, 2
+ *        for the bilinear element and 3 for the quadratic ones.
+ */
+class CShapeFunctions {
+    private:
+        unsigned gaussOrder;            /*!< @brief Number of Gauss points per direction.*/
+        unsigned nNodes;                /*!< @brief Number of nodes of the quadrilateral.*/
+        unsigned nLineNodes;            /*!< @brief Number of nodes of the line.*/
+        unsigned nQuadPoints;           /*!< @brief Number of Gauss points of the quadrilateral.*/
+        CMatrix gaussPoints;            /*!< @brief Location of the Gauss points in 1D.*/
+        CMatrix gaussWeights;           /*!< @brief Weights of the Gauss points in 1D.*/
+        std::vector<double> lineN;      /*!< @brief Line shape functions, nLineNodes per Gauss point.*/
+        std::vector<double> lineDN;     /*!< @brief Derivatives of lineN.*/
+        std::vector<double> quadN;      /*!< @brief Quadrilateral shape functions, nNodes per Gauss point.*/
+        std::vector<double> quadDXi;    /*!< @brief Derivatives of quadN with respect to xi.*/
+        std::vector<double> quadDEta;   /*!< @brief Derivatives of quadN with respect to eta.*/
+        std::vector<double> quadW;      /*!< @brief Weights of the quadrilateral Gauss points.*/
+
+        /*!
+         * @brief Constructor of the class, only used to build the shared tables.
+         * @param[in] order - Number of Gauss points per direction.
+         * @param[in] nodes - Number of nodes of the quadrilateral.
+         */
+        CShapeFunctions(const unsigned order, const unsigned nodes);
+
+    public:
+        static const unsigned maxGaussOrder = 5;    /*!< @brief Largest tabulated Gauss order.*/
+
+        /*!
+         * @brief Get the shared table of a Gauss order and element.
+         * @param[in] order - Number of Gauss points per direction.
+         * @param[in] nodes - Number of nodes of the quadrilateral, 4, 8 or 9.
+         * @return Table of the shape functions.
+         */
+        static const CShapeFunctions& getTable(const unsigned order,
+                                               const unsigned nodes = 4);
+
+        /*!
+         * @brief Gauss order that integrates the conductance of an undistorted
+         *        element exactly, 2 for the bilinear element and 3 for the
+         *        quadratic ones.
+         * @param[in] nodes - Number of nodes of the quadrilateral.
+         * @return Gauss order.
+         */
+        static unsigned defaultGaussOrder(const unsigned nodes);
+
+        /*!
+         * @brief Get the Gauss quadrature order.
+         * @return Gauss quadrature order.
+         */
+        unsigned getGaussOrder() const;
+
+        /*!
+         * @brief Get number of nodes of the quadrilateral.
+         * @return Number of nodes of the quadrilateral.
+         */
+        unsigned getNNodes() const;
+
+        /*!
+         * @brief Get number of nodes of the line.
+         * @return Number of nodes of the line.
+         */
+        unsigned getNLineNodes() const;
+
+        /*!
+         * @brief Get number of Gauss points of the quadrilateral.
+         * @return Number of Gauss points, the square of the order.
+         */
+        unsigned getNQuadPoints() const;
+
+        /*!
+         * @brief Get location of Gauss points in 1D.
+         * @return Location of Gauss points.
+         */
+        const CMatrix& getGaussPoints() const;
+
+        /*!
+         * @brief Get weights of Gauss points in 1D.
+         * @return Weights of Gauss points.
+         */
+        const CMatrix& getGaussWeights() const;
+
+        /*!
+         * @brief Get the line shape functions at a Gauss point.
+         * @param[in] q - Gauss point.
+         * @return Pointer at the nLineNodes shape functions.
+         */
+        const double* getLineN(const unsigned q) const;
+
+        /*!
+         * @brief Get the derivatives of the line shape functions at a Gauss
+         *        point.
+         * @param[in] q - Gauss point.
+         * @return Pointer at the nLineNodes derivatives.
+         */
+        const double* getLineDN(const unsigned q) const;
+
+        /*!
+         * @brief Get the quadrilateral shape functions at a Gauss point. The
+         *        point q is at eta of point q/order and xi of point q%order.
+         * @param[in] q - Gauss point.
+         * @return Pointer at the nNodes shape functions.
+         */
+        const double* getQuadN(const unsigned q) const;
+
+        /*!
+         * @brief Get the derivatives of the quadrilateral shape functions with
+         *        respect to xi at a Gauss point.
+         * @param[in] q - Gauss point.
+         * @return Pointer at the nNodes derivatives.
+         */
+        const double* getQuadDXi(const unsigned q) const;
+
+        /*!
+         * @brief Get the derivatives of the quadrilateral shape functions with
+         *        respect to eta at a Gauss point.
+         * @param[in] q - Gauss point.
+         * @return Pointer at the nNodes derivatives.
+         */
+        const double* getQuadDEta(const unsigned q) const;
+
+        /*!
+         * @brief Get the weight of a Gauss point of the quadrilateral.
+         * @param[in] q - Gauss point.
+         * @return Product of the 1D weights.
+         */
+        double getQuadWeight(const unsigned q) const;
+};
+
+#endif
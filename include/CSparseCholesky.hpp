@@ -0,0 +1,186 @@
+/*!
+ * @file CSparseCholesky.hpp
+ * @brief Headers of the main subroutines for the sparse Cholesky factorization.
+ *        The implementation is in the <i>CSparseCholesky.cpp</i> file.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CSPARSECHOLESKY_HPP
+#define __CSPARSECHOLESKY_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "CMatrix.hpp"
+#include "CMatrixSparseSymmetric.hpp"
+
+/*!
+ * @class CSparseCholesky
+ * @brief Sparse Cholesky factorization, P*A*P' = L*L', split in a symbolic
+ *        phase that depends only on the sparsity pattern and the ordering, and
+ *        a numeric phase. The symbolic phase is kept and reused by every new
+ *        factorization of a matrix with the same pattern, which is the case
+ *        when only conductivities or BC values change. The entries of L are
+ *        stored with the precision P, double or float. A float factor takes
+ *        half the memory and is meant for iterative refinement with the
+ *        residual in double precision.
+ */
+template <typename P> class CSparseCholesky {
+    private:
+        unsigned size;                      /*!< @brief Size of the system.*/
+        bool isAnalyzed;                    /*!< @brief Boolean to know if the symbolic phase is done.*/
+        unsigned nAnalyses;                 /*!< @brief Number of symbolic phases computed.*/
+        std::vector<unsigned> perm;         /*!< @brief Row of A of every row of P*A*P'.*/
+        std::vector<unsigned> aRowPtr;      /*!< @brief Row pointers of the analyzed pattern.*/
+        std::vector<unsigned> aColIdx;      /*!< @brief Column indices of the analyzed pattern.*/
+        std::vector<unsigned> cRowPtr;      /*!< @brief Row pointers of the lower triangle of P*A*P'.*/
+        std::vector<unsigned> cColIdx;      /*!< @brief Column indices of the lower triangle of P*A*P'.*/
+        std::vector<unsigned> cPos;         /*!< @brief Position in P*A*P' of every stored entry of A.*/
+        std::vector<int> parent;            /*!< @brief Elimination tree, -1 at the roots.*/
+        std::vector<unsigned> lColPtr;      /*!< @brief Position of the first entry of every column of L.*/
+        std::vector<unsigned> lRowIdx;      /*!< @brief Row of every entry of L, the diagonal first.*/
+        std::vector<P> lVal;                /*!< @brief Entries of L.*/
+
+        /*!
+         * @brief Pattern of row k of L, computed from the elimination tree.
+         * @param[in] k - Row number.
+         * @param[in,out] mark - Last row that visited every column.
+         * @param[out] stack - Columns of the pattern, in topological order,
+         *                     from the returned position to the end.
+         * @return First position of the pattern in stack.
+         */
+        unsigned rowPattern(const unsigned k, std::vector<unsigned>& mark,
+                            std::vector<unsigned>& stack) const;
+
+        /*!
+         * @brief Check that the phases read from a stream describe a valid
+         *        factor: the pointers are non-decreasing and end at the size
+         *        of their index vectors, every index is below its dimension,
+         *        perm is a permutation, parent is an elimination tree of the
+         *        pattern and the columns of L have room for its rows.
+         * @return Boolean to know if the phases are consistent.
+         */
+        bool isConsistent() const;
+
+        /*!
+         * @brief Write a vector in binary format, preceded by its size.
+         * @param[in,out] out - Output stream.
+         * @param[in] vec - Vector to write.
+         */
+        template <typename V>
+        static void writeVector(std::ostream& out, const std::vector<V>& vec);
+
+        /*!
+         * @brief Read a vector written by writeVector.
+         * @param[in,out] in - Input stream.
+         * @param[out] vec - Vector read.
+         */
+        template <typename V>
+        static void readVector(std::istream& in, std::vector<V>& vec);
+
+    public:
+        /*!
+         * @brief Constructor of the class.
+         */
+        CSparseCholesky();
+
+        /*!
+         * @brief Constructor of the class, with symbolic and numeric phases.
+         * @param[in] A - LHS matrix of the system.
+         * @param[in] order - Elimination order, row of A of every row of P*A*P'.
+         */
+        CSparseCholesky(const CMatrixSparseSymmetric& A,
+                        const std::vector<unsigned>& order);
+
+        /*!
+         * @brief Destructor of the class.
+         */
+        virtual ~CSparseCholesky();
+
+        /*!
+         * @brief Symbolic phase: permuted pattern, elimination tree and
+         *        column counts of L.
+         * @param[in] A - LHS matrix of the system.
+         * @param[in] order - Elimination order, row of A of every row of P*A*P'.
+         */
+        void analyze(const CMatrixSparseSymmetric& A,
+                     const std::vector<unsigned>& order);
+
+        /*!
+         * @brief Numeric phase with the up-looking algorithm, reusing the
+         *        symbolic phase.
+         * @param[in] A - LHS matrix with the analyzed pattern.
+         */
+        void factorize(const CMatrixSparseSymmetric& A);
+
+        /*!
+         * @brief Solve the system with the factorization.
+         * @param[in] b - RHS vector, or one column per RHS vector.
+         * @return Solution vectors.
+         */
+        CMatrix solve(const CMatrix& b) const;
+
+        /*!
+         * @brief Get size of the system.
+         * @return Size of the system.
+         */
+        unsigned getSize() const;
+
+        /*!
+         * @brief Get number of entries of L.
+         * @return Number of entries of L.
+         */
+        unsigned getNNonZeroFactor() const;
+
+        /*!
+         * @brief Get number of symbolic phases computed.
+         * @return Number of symbolic phases.
+         */
+        unsigned getNAnalyses() const;
+
+        /*!
+         * @brief Get memory taken by the symbolic and numeric phases.
+         * @return Memory in bytes.
+         */
+        size_t getBytes() const;
+
+        /*!
+         * @brief Write the symbolic and numeric phases in binary format.
+         * @param[in,out] out - Output stream.
+         */
+        void write(std::ostream& out) const;
+
+        /*!
+         * @brief Read the symbolic and numeric phases written by write, which
+         *        replace the current ones. Throws if the stream is truncated
+         *        or the phases are not consistent.
+         * @param[in,out] in - Input stream.
+         */
+        void read(std::istream& in);
+};
+
+#include "../src/CSparseCholesky.cpp"
+
+#endif
@@ -46,7 +46,7 @@ void solveAnalytical(const CMesh& msh,
     /*--- Initialize variables to be used in the subroutine. ---*/
     unsigned nNod = msh.getNNode();
     CMatrix T = CMatrix(nNod, 1, 0.0);
-    CMatrix coor = msh.getCoorMtx();
+    const CMatrix& coor = msh.getCoorMtx();
     std::string flLoc = bnd.getFluxBCLoc();
     std::string tpLoc = bnd.getTempBCLoc();
     double flVal = bnd.getFluxValue();
@@ -83,7 +83,7 @@ void calculateError(const CMatrix& sol1, const CMatrix& sol2,
 
     /*--- Compute error. ---*/
     for (unsigned i = 0; i < size; i++) {
-        err += abs(sol1(i, 0) - sol2(i, 0));
+        err += fabs(sol1(i, 0) - sol2(i, 0));
     }
     if (rank == 0)
         std::cout << "The error of the solution is: " << err << std::endl;
@@ -0,0 +1,205 @@
+/*!
+ * @file CAlgebraicMultigrid.cpp
+ * @brief The main subroutines for the algebraic multigrid method.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CALGEBRAICMULTIGRID_CPP
+#define __CALGEBRAICMULTIGRID_CPP
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../include/CAlgebraicMultigrid.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CMultigrid.hpp"
+
+CAlgebraicMultigrid::CAlgebraicMultigrid(const CMatrixSparseSymmetric& A,
+                                         const std::string cycleType) {
+    /*--- Initialize properties. ---*/
+    setCycleType(cycleType);
+    strength = 0.08;
+    maxCoarseSize = 50;
+
+    /*--- Coarsen until the level is small enough for a direct solve or the
+          aggregation barely reduces the size, which would only add levels
+          that cost as much as the finer one. ---*/
+    lhs.push_back(A.toGeneralStorage());
+    while (lhs.back().getRows() > maxCoarseSize) {
+        const CMatrixSparse& Af = lhs.back();
+        unsigned nAgg = 0;
+        std::vector<unsigned> agg = aggregate(Af, nAgg);
+        if (nAgg == 0 || nAgg > 0.9 * Af.getRows()) break;
+
+        CMatrixSparse P = smoothedProlongation(Af, agg, nAgg);
+        CMatrixSparse Ac = P.transpose() * (Af * P);
+        prolong.push_back(P);
+        lhs.push_back(Ac);
+    }
+    nLevels = lhs.size();
+    factorizeCoarsest();
+}
+
+CAlgebraicMultigrid::~CAlgebraicMultigrid() {}
+
+std::vector<unsigned> CAlgebraicMultigrid::aggregate(const CMatrixSparse& A,
+                                                     unsigned& nAggregates) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const int none = -1;
+    unsigned n = A.getRows();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+    std::vector<double> diag(n, 0.0);
+    std::vector<bool> strong(A.getNNonZero(), false);
+    std::vector<int> agg(n, none);
+
+    /*--- Entry (i, j) is a strong coupling if |a_ij| >= theta*sqrt(a_ii*a_jj). ---*/
+    for (unsigned i = 0; i < n; i++) {
+        diag[i] = A(i, i);
+    }
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            strong[k] = j != i &&
+                fabs(APtr[k]) >= strength * sqrt(fabs(diag[i] * diag[j]));
+        }
+    }
+
+    /*--- First pass. A DOF whose strong neighbours are all free starts an
+          aggregate with them. ---*/
+    nAggregates = 0;
+    for (unsigned i = 0; i < n; i++) {
+        if (agg[i] != none) continue;
+        bool isFree = true;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1] && isFree; k++) {
+            if (strong[k] && agg[colIdx[k]] != none) isFree = false;
+        }
+        if (!isFree) continue;
+        agg[i] = nAggregates;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (strong[k]) agg[colIdx[k]] = nAggregates;
+        }
+        nAggregates++;
+    }
+
+    /*--- Second pass. Remaining DOF join the aggregate of a strong neighbour
+          that was aggregated in the first pass. ---*/
+    std::vector<int> firstPass = agg;
+    for (unsigned i = 0; i < n; i++) {
+        if (agg[i] != none) continue;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (strong[k] && firstPass[colIdx[k]] != none) {
+                agg[i] = firstPass[colIdx[k]];
+                break;
+            }
+        }
+    }
+
+    /*--- Third pass. DOF without aggregated strong neighbours form new
+          aggregates with their free strong neighbours. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        if (agg[i] != none) continue;
+        agg[i] = nAggregates;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (strong[k] && agg[colIdx[k]] == none) {
+                agg[colIdx[k]] = nAggregates;
+            }
+        }
+        nAggregates++;
+    }
+
+    return std::vector<unsigned>(agg.begin(), agg.end());
+}
+
+CMatrixSparse CAlgebraicMultigrid::smoothedProlongation(
+        const CMatrixSparse& A, const std::vector<unsigned>& agg,
+        const unsigned nAggregates) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned n = A.getRows();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+    std::vector<unsigned> tRowPtr(n + 1, 0);
+    std::vector<unsigned> aggSize(nAggregates, 0);
+    std::vector<double> diag(n, 0.0);
+    double rho = 0.0;
+
+    /*--- Piecewise constant prolongation, with columns of unit norm. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        tRowPtr[i + 1] = i + 1;
+        aggSize[agg[i]]++;
+    }
+    CMatrixSparse T(n, nAggregates, tRowPtr.data(), agg.data(), 0.0);
+    double* TPtr = T.getMtxAddress();
+    for (unsigned i = 0; i < n; i++) {
+        TPtr[i] = 1.0 / sqrt(double(aggSize[agg[i]]));
+    }
+
+    /*--- Spectral radius of inv(D)*A estimated with a few power iterations.
+          The damping factor of the Jacobi smoothing is w = 4/(3*rho). ---*/
+    for (unsigned i = 0; i < n; i++) {
+        diag[i] = A(i, i);
+    }
+    std::vector<double> v(n, 0.0);
+    std::vector<double> w(n, 0.0);
+    for (unsigned i = 0; i < n; i++) {
+        v[i] = (i % 7 + 1) / sqrt(double(n));
+    }
+    for (unsigned m = 0; m < 15; m++) {
+        double norm = 0.0;
+        for (unsigned i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                sum += APtr[k] * v[colIdx[k]];
+            }
+            w[i] = sum / diag[i];
+            norm += w[i] * w[i];
+        }
+        rho = sqrt(norm);
+        for (unsigned i = 0; i < n; i++) {
+            v[i] = w[i] / rho;
+        }
+    }
+    double omega = 4.0 / (3.0 * rho);
+
+    /*--- P = T - w*inv(D)*A*T. The pattern of A*T contains the one of T
+          because the diagonal of A is stored. ---*/
+    CMatrixSparse P = A * T;
+    unsigned* pRowPtr = P.getRowPtrAddress();
+    double* PPtr = P.getMtxAddress();
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = pRowPtr[i]; k < pRowPtr[i + 1]; k++) {
+            PPtr[k] *= -omega / diag[i];
+        }
+        P.addEntry(i, agg[i], TPtr[i]);
+    }
+
+    return P;
+}
+
+#endif
@@ -32,18 +32,21 @@
 #include <iostream>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "../include/CBoundaryConditions.hpp"
+#include "../include/CMatrixFixed.hpp"
+#include "../include/CMatrixIndex.hpp"
 #include "../include/CMesh.hpp"
 #include "../include/CGeometry.hpp"
+#include "../include/CShapeFunctions.hpp"
 
 CBoundaryConditions::CBoundaryConditions() {
     /*--- Initialization of default properties. ---*/
     gaussOrder = 2;
-    gaussPoints = CMatrix(1, 2, 0.0);
-    gaussPoints(0, 0) = -1.0 / sqrt(3.0);
-    gaussPoints(0, 1) = 1.0 / sqrt(3.0);
-    gaussWeights = CMatrix(1, 2, 1.0);
+    shape = &CShapeFunctions::getTable(gaussOrder);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
     fluxBCLoc = "";
     tempBCLoc = "";
     fluxValue = 0.0;
@@ -57,13 +60,16 @@ CBoundaryConditions::CBoundaryConditions(const std::string flLoc,
                                          const std::string tpLoc,
                                          const double tpVal,
                                          const CMesh& msh,
-                                         const CGeometry& geo) {
-    /*--- Initialization of default properties. ---*/
-    gaussOrder = 2;
-    gaussPoints = CMatrix(1, 2, 0.0);
-    gaussPoints(0, 0) = -1.0 / sqrt(3.0);
-    gaussPoints(0, 1) = 1.0 / sqrt(3.0);
-    gaussWeights = CMatrix(1, 2, 1.0);
+                                         const CGeometry& geo,
+                                         const unsigned order) {
+    /*--- Initialization of default properties. The edges of the boundary
+          have the nodes of the edges of the elements. ---*/
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    gaussOrder = (order == 0) ? CShapeFunctions::defaultGaussOrder(nNodPerEl)
+                              : order;
+    shape = &CShapeFunctions::getTable(gaussOrder, nNodPerEl);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
     fluxBCLoc = flLoc;
     tempBCLoc = tpLoc;
     fluxValue = flVal;
@@ -80,11 +86,11 @@ unsigned CBoundaryConditions::getGaussOrder() const {
     return gaussOrder;
 }
 
-CMatrix CBoundaryConditions::getGaussPoints() const {
+const CMatrix& CBoundaryConditions::getGaussPoints() const {
     return gaussPoints;
 }
 
-CMatrix CBoundaryConditions::getGaussWeights() const {
+const CMatrix& CBoundaryConditions::getGaussWeights() const {
     return gaussWeights;
 }
 
@@ -104,11 +110,11 @@ double CBoundaryConditions::getTempValue() const {
     return tempValue;
 }
 
-CMatrix CBoundaryConditions::getFluxNodes() const {
+const CMatrixIndex& CBoundaryConditions::getFluxNodes() const {
     return fluxNodes;
 }
 
-CMatrix CBoundaryConditions::getTempNodes() const {
+const CMatrixIndex& CBoundaryConditions::getTempNodes() const {
     return tempNodes;
 }
 
@@ -120,15 +126,15 @@ unsigned CBoundaryConditions::getNTempNodes() const {
     return nTempNodes;
 }
 
-CMatrix CBoundaryConditions::getFluxBCVector() const {
+const CMatrix& CBoundaryConditions::getFluxBCVector() const {
     return fluxBCVector;
 }
 
-CMatrix CBoundaryConditions::getTempBCVector() const {
+const CMatrix& CBoundaryConditions::getTempBCVector() const {
     return tempBCVector;
 }
 
-CMatrix CBoundaryConditions::getReducedDofVector() const {
+const CMatrixIndex& CBoundaryConditions::getReducedDofVector() const {
     return reducedDofVector;
 }
 
@@ -136,160 +142,171 @@ unsigned CBoundaryConditions::getNReducedDof() const {
     return nReducedDof;
 }
 
+std::vector<bool> CBoundaryConditions::getDirichletMask() const {
+    std::vector<bool> mask(tempBCVector.getRows(), false);
+    for (unsigned i = 0; i < nTempNodes; i++) {
+        mask[tempNodes(0, i)] = true;
+    }
+
+    return mask;
+}
+
 CMatrix CBoundaryConditions::computeBCFlux(const CMesh& msh,
                                            const CGeometry& geo) {
-    /*--- Initialization of variables to be used in the subroutine. ---*/
-    unsigned nElX = msh.getNXDirElem();
-    unsigned nElY = msh.getNYDirElem();
-    CMatrix topol = msh.getTopolMtx();
+    /*--- Initialization of variables to be used in the subroutine. The flux
+          nodes are the points of the node grid along the edge. ---*/
+    const CMatrixIndex& topol = msh.getTopolMtx();
+    unsigned nX = topol.getCols() - 1;
+    unsigned nY = topol.getRows() - 1;
     unsigned nDof = msh.getNDofTotal();
     CMatrix f = CMatrix(nDof, 1, 0.0);
-    CMatrix coor = msh.getCoorMtx();
-    double thick = geo.getThickness();
 
     /*--- Find flux nodes depending on the flux BC location specidied by the
           user. ---*/
     if (fluxBCLoc == "bottom") {
-        fluxNodes = CMatrix(1, nElX + 1, 0.0);
-        for (unsigned j = 0; j < nElX + 1; j++) {
+        fluxNodes = CMatrixIndex(1, nX + 1, 0);
+        for (unsigned j = 0; j < nX + 1; j++) {
             fluxNodes(0, j) = topol(0, j);
         }
-        nFluxNodes = nElX + 1;
+        nFluxNodes = nX + 1;
     } else if (fluxBCLoc == "top") {
-        fluxNodes = CMatrix(1, nElX + 1, 0.0);
-        for (unsigned j = 0; j < nElX + 1; j++) {
-            fluxNodes(0, j) = topol(nElY, j);
+        fluxNodes = CMatrixIndex(1, nX + 1, 0);
+        for (unsigned j = 0; j < nX + 1; j++) {
+            fluxNodes(0, j) = topol(nY, j);
         }
-        nFluxNodes = nElX + 1;
+        nFluxNodes = nX + 1;
     } else if (fluxBCLoc == "left") {
-        fluxNodes = CMatrix(1, nElY + 1, 0.0);
-        for (unsigned i = 0; i < nElY + 1; i++) {
+        fluxNodes = CMatrixIndex(1, nY + 1, 0);
+        for (unsigned i = 0; i < nY + 1; i++) {
             fluxNodes(0, i) = topol(i, 0);
         }
-        nFluxNodes = nElY + 1;
+        nFluxNodes = nY + 1;
     } else if (fluxBCLoc == "right") {
-        fluxNodes = CMatrix(1, nElY + 1, 0.0);
-        for (unsigned i = 0; i < nElY + 1; i++) {
-            fluxNodes(0, i) = topol(i, nElX);
+        fluxNodes = CMatrixIndex(1, nY + 1, 0);
+        for (unsigned i = 0; i < nY + 1; i++) {
+            fluxNodes(0, i) = topol(i, nX);
         }
-        nFluxNodes = nElY + 1;
+        nFluxNodes = nY + 1;
     } else {
         throw std::runtime_error("Unknown flux location");
     }
 
-    /*--- Here n_bc is used in the calculation of elemental flux and assembly of
-          global flux. ---*/
-    unsigned nbe = nFluxNodes - 1;
-    CMatrix n_bc = CMatrix(4, nbe, 0.0);
-    for (unsigned j = 0; j < nbe; j++) {
-        n_bc(0, j) = fluxNodes(0, j);
-        n_bc(1, j) = fluxNodes(0, j + 1);
-        n_bc(2, j) = fluxValue;
-        n_bc(3, j) = fluxValue;
+    /*--- Elemental flux and assembly with the line of the element edges. ---*/
+    if (shape->getNLineNodes() == 2) {
+        edgeFlux<2>(msh, geo, f);
+    } else {
+        edgeFlux<3>(msh, geo, f);
     }
 
-    /*--- Elemental flux and assembly of the global flux vector. ---*/
+    return f;
+}
+
+template <unsigned M>
+void CBoundaryConditions::edgeFlux(const CMesh& msh, const CGeometry& geo,
+                                   CMatrix& f) const {
+    /*--- Initialization of variables to be used in the subroutine. ---*/
+    const double* coorX = msh.getCoorX();
+    const double* coorY = msh.getCoorY();
+    double thick = geo.getThickness();
+
+    /*--- Consecutive edges share their end node. ---*/
+    unsigned nbe = (nFluxNodes - 1) / (M - 1);
+
+    /*--- Elemental flux and assembly of the global flux vector. The elemental
+          matrices have fixed size and live on the stack. ---*/
+    CMatrixFixed<M, 1> fq;
+    CMatrixFixed<M, 1> n_bce;
+    CMatrixFixed<1, M> N;
+    unsigned node[M];
     for (unsigned e = 0; e < nbe; e++) {
-        CMatrix fq = CMatrix(2, 1, 0.0);
-        unsigned node1 = n_bc(0, e);
-        unsigned node2 = n_bc(1, e);
-        CMatrix n_bce = CMatrix(1, 2, 0.0);
-        n_bce(0, 0) = n_bc(2, e);
-        n_bce(0, 1) = n_bc(3, e);
-        double x1 = coor(node1, 0);
-        double x2 = coor(node2, 0);
-        double y1 = coor(node1, 1);
-        double y2 = coor(node2, 1);
-        double detJ = sqrt((x2 - x1)*(x2 - x1) + (y2 - y1)*(y2 - y1)) / 2.0;
-
-        /*--- Gaussian quadrature. ---*/
+        fq *= 0.0;
+        for (unsigned a = 0; a < M; a++) {
+            node[a] = fluxNodes(0, (M - 1)*e + a);
+            n_bce(a, 0) = fluxValue;
+        }
+
+        /*--- Gaussian quadrature. The Jacobian is the length of the tangent to
+              the edge, which is curved for the quadratic edges of a tapered
+              plate. ---*/
         for (unsigned i = 0; i < gaussOrder; i++) {
-            double xi = gaussPoints(0, i);
-            CMatrix N = CMatrix(1, 2, 0.0);
-            N(0, 0) = 0.5 * (1 - xi);
-            N(0, 1) = 0.5 * (1 + xi);
-            CMatrix flux = N * n_bce.transpose();
-            fq = fq + (N.transpose() * detJ * thick * flux * gaussWeights(0, i));
+            const double* lineN = shape->getLineN(i);
+            const double* lineDN = shape->getLineDN(i);
+            double dx = 0.0;
+            double dy = 0.0;
+            for (unsigned a = 0; a < M; a++) {
+                N(0, a) = lineN[a];
+                dx += lineDN[a] * coorX[node[a]];
+                dy += lineDN[a] * coorY[node[a]];
+            }
+            double detJ = sqrt(dx*dx + dy*dy);
+            CMatrixFixed<1, 1> flux = N * n_bce;
+            fq += N.transpose() * flux * (detJ * thick * gaussWeights(0, i));
         }
-        fq = fq * (-1.0);
+        fq *= -1.0;
 
         /*--- Assembly of global flux vector. ---*/
-        f(node1, 0) = f(node1, 0) + fq(0, 0);
-        f(node2, 0) = f(node2, 0) + fq(1, 0);
+        for (unsigned a = 0; a < M; a++) {
+            f(node[a], 0) = f(node[a], 0) + fq(a, 0);
+        }
     }
-
-    return f;
 }
 
 CMatrix CBoundaryConditions::computeBCTemp(const CMesh& msh) {
     /*--- Initialization of variables to be used in the subroutine. ---*/
-    unsigned nElX = msh.getNXDirElem();
-    unsigned nElY = msh.getNYDirElem();
+    const CMatrixIndex& topol = msh.getTopolMtx();
+    unsigned nX = topol.getCols() - 1;
+    unsigned nY = topol.getRows() - 1;
     unsigned nDof = msh.getNDofTotal();
-    CMatrix topol = msh.getTopolMtx();
 
     /*--- Find temperature nodes depending on the temperature BC location
           specidied by the user. ---*/
     if (tempBCLoc == "bottom") {
-        tempNodes = CMatrix(1, nElX + 1, 0.0);
-        for (unsigned j = 0; j < nElX + 1; j++) {
+        tempNodes = CMatrixIndex(1, nX + 1, 0);
+        for (unsigned j = 0; j < nX + 1; j++) {
             tempNodes(0, j) = topol(0, j);
         }
-        nTempNodes = nElX + 1;
+        nTempNodes = nX + 1;
     } else if (tempBCLoc == "top") {
-        tempNodes = CMatrix(1, nElX + 1, 0.0);
-        for (unsigned j = 0; j < nElX + 1; j++) {
-            tempNodes(0, j) = topol(nElY, j);
+        tempNodes = CMatrixIndex(1, nX + 1, 0);
+        for (unsigned j = 0; j < nX + 1; j++) {
+            tempNodes(0, j) = topol(nY, j);
         }
-        nTempNodes = nElX + 1;
+        nTempNodes = nX + 1;
     } else if (tempBCLoc == "left") {
-        tempNodes = CMatrix(1, nElY + 1, 0.0);
-        for (unsigned i = 0; i < nElY + 1; i++) {
+        tempNodes = CMatrixIndex(1, nY + 1, 0);
+        for (unsigned i = 0; i < nY + 1; i++) {
             tempNodes(0, i) = topol(i, 0);
         }
-        nTempNodes = nElY + 1;
+        nTempNodes = nY + 1;
     } else if (tempBCLoc == "right") {
-        tempNodes = CMatrix(1, nElY + 1, 0.0);
-        for (unsigned i = 0; i < nElY + 1; i++) {
-            tempNodes(0, i) = topol(i, nElX);
+        tempNodes = CMatrixIndex(1, nY + 1, 0);
+        for (unsigned i = 0; i < nY + 1; i++) {
+            tempNodes(0, i) = topol(i, nX);
         }
-        nTempNodes = nElY + 1;
+        nTempNodes = nY + 1;
     } else {
         throw std::runtime_error("Unknown flux location");
     }
 
-    /*--- Here tempBC is used in creating the vector of temperatures T. ---*/
-    CMatrix tempBC = CMatrix(nTempNodes, 2, 0.0);
-    for (unsigned i = 0; i < nTempNodes; i++) {
-        tempBC(i, 0) = tempNodes(0, i);
-        tempBC(i, 1) = tempValue;
-    }
-
-    /*--- Creating vector of temperatures. ---*/
+    /*--- Creating vector of temperatures and the flags of the DOF where
+          temperature is specified. ---*/
     CMatrix T = CMatrix(nDof, 1, 0.0);
+    std::vector<bool> known(nDof, false);
     for (unsigned i = 0; i < nTempNodes; i++) {
-        T(tempBC(i, 0), 0) = tempBC(i, 1);
-    }
-
-    /*--- Set a flag of -1.0 where temperature is specified to create the vector
-          of reduced DOF. ---*/
-    CMatrix OrgDof = CMatrix(1, nDof, 0.0);
-    for (unsigned i = 0; i < nTempNodes; i++) {
-        OrgDof(0, tempBC(i, 0)) = -1.0;
+        T(tempNodes(0, i), 0) = tempValue;
+        known[tempNodes(0, i)] = true;
     }
 
     /*--- Creating the vector of reduced DOF. ---*/
     nReducedDof = nDof - nTempNodes;
-    CMatrix RedDof = CMatrix(1, nReducedDof, 0.0);
+    reducedDofVector = CMatrixIndex(1, nReducedDof, 0);
     unsigned count = 0;
     for (unsigned i = 0; i < nDof; i++) {
-        if (OrgDof(0, i) == 0.0) {
-            OrgDof(0, i) = count;
-            RedDof(0, count) = i;
+        if (!known[i]) {
+            reducedDofVector(0, count) = i;
             count++;
         }
     }
-    reducedDofVector = RedDof;
 
     return T;
 }
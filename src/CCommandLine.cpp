@@ -31,6 +31,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <stdexcept>
 #include <boost/program_options.hpp>
 #include <mpi.h>
 
@@ -79,7 +80,33 @@ CCommandLine::CCommandLine(int argc, char *argv[]) {
         ("flux-location", po::value<std::string>(), "location of flux BC")
         ("flux-value", po::value<double>(), "value of flux BC")
         ("temp-location", po::value<std::string>(), "location of temperature BC")
-        ("temp-value", po::value<double>(), "value of temperature BC");
+        ("temp-value", po::value<double>(), "value of temperature BC")
+        ("preconditioner", po::value<std::string>()->default_value("none"),
+         "preconditioner of the CG method: none, jacobi, ssor, ic0, multigrid or amg")
+        ("solver", po::value<std::string>()->default_value("cg"),
+         "solver: cg, distributed (CG with the rows split among the ranks), "
+         "matrix-free (CG without assembly), multigrid, "
+         "direct (banded Cholesky), cholesky (sparse) or mixed (sparse "
+         "Cholesky in single precision with iterative refinement)")
+        ("mg-cycle", po::value<std::string>()->default_value("V"),
+         "cycle of the multigrid method: V or W")
+        ("cg-method", po::value<std::string>()->default_value("classic"),
+         "variant of the CG method: classic, pipelined (one non-blocking "
+         "reduction per iteration) or s-step (one reduction per s iterations)")
+        ("s-step", po::value<unsigned>()->default_value(4),
+         "iterations per block of the s-step CG method")
+        ("s-basis", po::value<std::string>()->default_value("newton"),
+         "basis of the s-step CG method: monomial or newton")
+        ("element", po::value<std::string>()->default_value("q4"),
+         "type of element: q4 (bilinear), q8 (serendipity) or q9 (Lagrange)")
+        ("gauss-order", po::value<unsigned>()->default_value(0),
+         "Gauss points per direction, from 1 to 5, 0 for 2 with q4 and 3 "
+         "with q8 and q9")
+        ("cache-dir", po::value<std::string>()->default_value(""),
+         "existing directory to keep the assembled submatrices and the "
+         "sparse Cholesky factor between runs, none by default")
+        ("cache-size", po::value<unsigned>()->default_value(256),
+         "maximum size of the cache in memory and on disk in MiB");
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
     po::notify(vm);
@@ -121,8 +148,27 @@ CCommandLine::CCommandLine(int argc, char *argv[]) {
         fluxValue = vm["flux-value"].as<double>();
         tempLocation = vm["temp-location"].as<std::string>();
         tempValue = vm["temp-value"].as<double>();
+        preconditioner = vm["preconditioner"].as<std::string>();
+        solver = vm["solver"].as<std::string>();
+        mgCycle = vm["mg-cycle"].as<std::string>();
+        cgMethod = vm["cg-method"].as<std::string>();
+        sStep = vm["s-step"].as<unsigned>();
+        sBasis = vm["s-basis"].as<std::string>();
+        element = vm["element"].as<std::string>();
+        gaussOrder = vm["gauss-order"].as<unsigned>();
+        cacheDir = vm["cache-dir"].as<std::string>();
+        cacheSize = vm["cache-size"].as<unsigned>();
         ableToRun = true;
 
+        /*--- The geometric multigrid only coarsens bilinear meshes. ---*/
+        if ((solver == "multigrid" || preconditioner == "multigrid") &&
+            element != "q4") {
+            if (rank == 0) {
+                std::cout << "The geometric multigrid needs the q4 element\n";
+            }
+            ableToRun = false;
+        }
+
     /*--- If not all the required parameters are specified, show the help
           information. ---*/
     } else {
@@ -192,6 +238,53 @@ double CCommandLine::getTempValue() const {
     return tempValue;
 }
 
+std::string CCommandLine::getPreconditioner() const {
+    return preconditioner;
+}
+
+std::string CCommandLine::getSolver() const {
+    return solver;
+}
+
+std::string CCommandLine::getMgCycle() const {
+    return mgCycle;
+}
+
+std::string CCommandLine::getCgMethod() const {
+    return cgMethod;
+}
+
+unsigned CCommandLine::getSStep() const {
+    return sStep;
+}
+
+std::string CCommandLine::getSBasis() const {
+    return sBasis;
+}
+
+std::string CCommandLine::getElement() const {
+    return element;
+}
+
+unsigned CCommandLine::getNNodePerElem() const {
+    if (element == "q4") return 4;
+    if (element == "q8") return 8;
+    if (element == "q9") return 9;
+    throw std::runtime_error("Unknown element");
+}
+
+unsigned CCommandLine::getGaussOrder() const {
+    return gaussOrder;
+}
+
+std::string CCommandLine::getCacheDir() const {
+    return cacheDir;
+}
+
+unsigned CCommandLine::getCacheSize() const {
+    return cacheSize;
+}
+
 bool CCommandLine::getAbleToRun() const {
     return ableToRun;
 }
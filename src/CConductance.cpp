@@ -30,175 +30,656 @@
 
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <stdexcept>
 #include <mpi.h>
 
 #include "../include/CConductance.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CMatrixFixed.hpp"
+#include "../include/CConductanceKernel.hpp"
+#include "../include/CShapeFunctions.hpp"
 #include "../include/CMaterial.hpp"
 #include "../include/CMesh.hpp"
 #include "../include/CGeometry.hpp"
+#include "../include/CBoundaryConditions.hpp"
 
 CConductance::CConductance() {
     /*--- Initialize properties. ---*/
     gaussOrder = 2;
-    gaussPoints = CMatrix(1, 2, 0.0);
-    gaussPoints(0, 0) = -1.0 / sqrt(3.0);
-    gaussPoints(0, 1) = 1.0 / sqrt(3.0);
-    gaussWeights = CMatrix(1, 2, 1.0);
+    shape = &CShapeFunctions::getTable(gaussOrder);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
+    nElemClasses = 0;
+    reduced = false;
+    distributed = false;
 }
 
 CConductance::CConductance(const CGeometry& geo, const CMaterial& mat,
                            const CMesh& msh) {
     /*--- Initialize properties. ---*/
-    gaussOrder = 2;
-    gaussPoints = CMatrix(1, 2, 0.0);
-    gaussPoints(0, 0) = -1.0 / sqrt(3.0);
-    gaussPoints(0, 1) = 1.0 / sqrt(3.0);
-    gaussWeights = CMatrix(1, 2, 1.0);
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    gaussOrder = CShapeFunctions::defaultGaussOrder(nNodPerEl);
+    shape = &CShapeFunctions::getTable(gaussOrder, nNodPerEl);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
+    nElemClasses = 0;
+    reduced = false;
+    distributed = false;
+    geometry = geo;
+    material = mat;
 
     /*--- Calculate conductance matrix. ---*/
     conducMtx = conductanceMtx(geo, mat, msh);
 }
 
+CConductance::CConductance(const CGeometry& geo, const CMaterial& mat,
+                           const CMesh& msh, const bool assemble,
+                           const unsigned order) {
+    /*--- Initialize properties. ---*/
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    gaussOrder = (order == 0) ? CShapeFunctions::defaultGaussOrder(nNodPerEl)
+                              : order;
+    shape = &CShapeFunctions::getTable(gaussOrder, nNodPerEl);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
+    nElemClasses = 0;
+    reduced = false;
+    distributed = false;
+    geometry = geo;
+    material = mat;
+
+    /*--- Calculate conductance matrix. ---*/
+    if (assemble) conducMtx = conductanceMtx(geo, mat, msh);
+}
+
+CConductance::CConductance(const CGeometry& geo, const CMaterial& mat,
+                           const CMesh& msh, const CBoundaryConditions& bnd,
+                           const unsigned order, const bool distribute) {
+    /*--- Initialize properties. ---*/
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    gaussOrder = (order == 0) ? CShapeFunctions::defaultGaussOrder(nNodPerEl)
+                              : order;
+    shape = &CShapeFunctions::getTable(gaussOrder, nNodPerEl);
+    gaussPoints = shape->getGaussPoints();
+    gaussWeights = shape->getGaussWeights();
+    nElemClasses = 0;
+    reduced = true;
+    distributed = distribute;
+    geometry = geo;
+    material = mat;
+
+    /*--- Calculate the conductance submatrices of the reduced system. ---*/
+    reducedMtx(geo, mat, msh, bnd);
+}
+
 CConductance::~CConductance() {}
 
 unsigned CConductance::getGaussOrder() const {
     return gaussOrder;
 }
 
-CMatrix CConductance::getGaussPoints() const {
+const CMatrix& CConductance::getGaussPoints() const {
     return gaussPoints;
 }
 
-CMatrix CConductance::getGaussWeights() const {
+const CMatrix& CConductance::getGaussWeights() const {
     return gaussWeights;
 }
 
-CMatrix CConductance::getConducMtx() const {
+const CMatrixSparse& CConductance::getConducMtx() const {
     return conducMtx;
 }
 
-CMatrix CConductance::conductanceMtx(const CGeometry& geo, const CMaterial& mat,
-                                     const CMesh& msh) {
+bool CConductance::isReduced() const {
+    return reduced;
+}
+
+const CMatrixSparseSymmetric& CConductance::getConducFF() const {
+    return conducFF;
+}
+
+bool CConductance::isDistributed() const {
+    return distributed;
+}
+
+const CMatrixSparse& CConductance::getConducFFRows() const {
+    return conducFFRows;
+}
+
+const std::vector<unsigned>& CConductance::getConducFFOffsets() const {
+    return ffRowOffsets;
+}
+
+const CMatrixSparse& CConductance::getConducEF() const {
+    return conducEF;
+}
+
+const CMatrix& CConductance::getConducEE() const {
+    return conducEE;
+}
+
+unsigned CConductance::getNElemClasses() const {
+    return nElemClasses;
+}
+
+CGeometry CConductance::getGeometry() const {
+    return geometry;
+}
+
+CMaterial CConductance::getMaterial() const {
+    return material;
+}
+
+template <unsigned N>
+void CConductance::elementConductance(const CMatrixFixed<N, 2>& eCoord,
+                                      const CMatrixFixed<2, 2>& D,
+                                      const double thick,
+                                      CMatrixFixed<N, N>& Ke) const {
+    if (shape->getNNodes() != N)
+        throw std::runtime_error("Element with a different number of nodes");
+
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    CMatrixFixed<2, N> GN;
+    double detJ;
+
+    /*--- Elemental conductance with Gaussian quadrature. The derivatives of
+          the shape functions come from the table of the Gauss order. ---*/
+    Ke *= 0.0;
+    for (unsigned q = 0; q < shape->getNQuadPoints(); q++) {
+        const double* dXi = shape->getQuadDXi(q);
+        const double* dEta = shape->getQuadDEta(q);
+        for (unsigned a = 0; a < N; a++) {
+            GN(0, a) = dXi[a];
+            GN(1, a) = dEta[a];
+        }
+
+        /*--- Jacobian, J = GN*eCoord, and B = inv(J)*GN. ---*/
+        CMatrixFixed<2, 2> J = GN * eCoord;
+        detJ = J.determinant();
+        CMatrixFixed<2, N> B = J.inverse() * GN;
+
+        /*--- Ke += B'*D*B*t*detJ*w. ---*/
+        Ke += B.transpose() * (D * B) * (thick * detJ * shape->getQuadWeight(q));
+    }
+}
+
+template void CConductance::elementConductance<4>(const CMatrixFixed<4, 2>&,
+                                                  const CMatrixFixed<2, 2>&,
+                                                  const double,
+                                                  CMatrixFixed<4, 4>&) const;
+template void CConductance::elementConductance<8>(const CMatrixFixed<8, 2>&,
+                                                  const CMatrixFixed<2, 2>&,
+                                                  const double,
+                                                  CMatrixFixed<8, 8>&) const;
+template void CConductance::elementConductance<9>(const CMatrixFixed<9, 2>&,
+                                                  const CMatrixFixed<2, 2>&,
+                                                  const double,
+                                                  CMatrixFixed<9, 9>&) const;
+
+CMatrixSparse CConductance::sparsityPattern(const CMesh& msh) {
     /*--- Initialize variables to be used in the subroutine. ---*/
-    double thick = geo.getThickness();
     unsigned nDof = msh.getNDofTotal();
     unsigned nEl = msh.getNElem();
     unsigned nNodPerEl = msh.getNNodePerElem();
     unsigned dfPerNod = msh.getDofPerNode();
-    CMatrix D = mat.getConductivityMatrix();
-    CMatrix K = CMatrix(nDof, nDof, 0.0);
-    CMatrix conn = msh.getConnMtx();
-    CMatrix coor = msh.getCoorMtx();
-    CMatrix glDof = msh.getGlDofMtx();
-    CMatrix eNodes = CMatrix(1, nNodPerEl, 0.0);
-    CMatrix eCoord = CMatrix(nNodPerEl, 2, 0.0);
-    CMatrix J;
-    CMatrix InvJ;
-    double detJ;
-    double eta;
-    double xi;
-    CMatrix N = CMatrix(1, nNodPerEl, 0.0);
-    CMatrix GN = CMatrix(2, nNodPerEl, 0.0);
-    CMatrix B;
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    std::vector< std::vector<unsigned> > rowCols(nDof);
+    std::vector<unsigned> gDf(nNodPerEl);
+
+    /*--- Every DOF is coupled with all the DOF of the elements it belongs to. ---*/
+    for (unsigned e = 0; e < nEl; e++) {
+        for (unsigned i = 0; i < nNodPerEl; i++) {
+            gDf[i] = glDof(conn(e, i + 1), dfPerNod);
+        }
+        for (unsigned i = 0; i < nNodPerEl; i++) {
+            for (unsigned j = 0; j < nNodPerEl; j++) {
+                rowCols[gDf[i]].push_back(gDf[j]);
+            }
+        }
+    }
+
+    /*--- Sort the columns of every row and remove the repeated ones to build
+          the row pointers and column indices. ---*/
+    std::vector<unsigned> rowPtr(nDof + 1, 0);
+    std::vector<unsigned> colIdx;
+    for (unsigned i = 0; i < nDof; i++) {
+        std::sort(rowCols[i].begin(), rowCols[i].end());
+        rowCols[i].erase(std::unique(rowCols[i].begin(), rowCols[i].end()),
+                         rowCols[i].end());
+        colIdx.insert(colIdx.end(), rowCols[i].begin(), rowCols[i].end());
+        rowPtr[i + 1] = colIdx.size();
+    }
+
+    return CMatrixSparse(nDof, nDof, rowPtr.data(), colIdx.data(), 0.0);
+}
+
+unsigned CConductance::elementClasses(const CMesh& msh,
+                                      const CMatrixFixed<2, 2>& D,
+                                      const double thick,
+                                      const unsigned initEl,
+                                      const unsigned finaEl,
+                                      std::vector<unsigned>& elClass,
+                                      std::vector<double>& classKe) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    typedef std::array<long long, 2*(CConductanceKernel::maxNodes-1)> TKey;
+    const unsigned nNod = msh.getNNodePerElem();
+    const unsigned S = CConductanceKernel::batchSize;
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const double* coorX = msh.getCoorX();
+    const double* coorY = msh.getCoorY();
+    std::map<TKey, unsigned> classes;
+    std::vector<unsigned> firstEl;
+
+    /*--- Coordinates are compared after rounding to a fraction of the size of
+          the plate, so the rounding errors of the mesh do not split groups. ---*/
+    double scale = 0.0;
+    for (unsigned i = 0; i < msh.getNNode(); i++) {
+        scale = std::max(scale, std::max(fabs(coorX[i]), fabs(coorY[i])));
+    }
+    double tol = (scale > 0.0) ? 1e-9 * scale : 1.0;
+
+    /*--- The key of an element is the position of its nodes relative to the
+          first one, which removes the translation. ---*/
+    elClass.resize(finaEl - initEl);
+    for (unsigned e = initEl; e < finaEl; e++) {
+        TKey key = TKey();
+        unsigned node0 = conn(e, 1);
+        for (unsigned a = 1; a < nNod; a++) {
+            unsigned node = conn(e, a + 1);
+            key[2*(a-1)] = llround((coorX[node] - coorX[node0]) / tol);
+            key[2*(a-1)+1] = llround((coorY[node] - coorY[node0]) / tol);
+        }
+        std::map<TKey, unsigned>::iterator it = classes.find(key);
+        if (it == classes.end()) {
+            it = classes.insert(std::make_pair(key, firstEl.size())).first;
+            firstEl.push_back(e);
+        }
+        elClass[e - initEl] = it->second;
+    }
+
+    /*--- Conductance of the first element of every group with the batched
+          kernel, with the batches split among the threads. The instruction
+          set is detected before the threads start. The lanes after the last
+          group repeat it. ---*/
+    unsigned nClasses = firstEl.size();
+    classKe.resize(nNod*nNod*nClasses);
+    CConductanceKernel::getInstructionSet();
+    #pragma omp parallel for schedule(static)
+    for (unsigned c0 = 0; c0 < nClasses; c0 += S) {
+        std::vector<double> eCoord(2*nNod*S);
+        std::vector<double> Ke(nNod*nNod*S);
+        unsigned nLanes = std::min(S, nClasses - c0);
+        for (unsigned l = 0; l < S; l++) {
+            unsigned e = firstEl[c0 + std::min(l, nLanes - 1)];
+            for (unsigned a = 0; a < nNod; a++) {
+                unsigned node = conn(e, a + 1);
+                eCoord[a*S+l] = coorX[node];
+                eCoord[(nNod+a)*S+l] = coorY[node];
+            }
+        }
+        CConductanceKernel::compute(*shape, eCoord.data(), D, thick, Ke.data());
+        for (unsigned l = 0; l < nLanes; l++) {
+            for (unsigned k = 0; k < nNod*nNod; k++) {
+                classKe[(c0+l)*nNod*nNod+k] = Ke[k*S+l];
+            }
+        }
+    }
+
+    return nClasses;
+}
 
+std::vector<unsigned> CConductance::reduceRanks(const unsigned nRows,
+                                               const unsigned* range,
+                                               const unsigned first,
+                                               const unsigned* rowPtr,
+                                               double* val,
+                                               const bool gather) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
     int rank;
     int nRanks;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
-    // printf("Hello: rank %d, world: %d\n",rank, nRanks);
+    std::vector<unsigned> ranges(2*nRanks);
+    unsigned myRange[2] = {range[0], range[1]};
+    MPI_Allgather(myRange, 2, MPI_UNSIGNED, ranges.data(), 2, MPI_UNSIGNED,
+                  MPI_COMM_WORLD);
 
-    /*--- Divide elements to be handled by ranks 0 and 1. ---*/
-    unsigned initEl = rank * (nEl / nRanks);
-    unsigned finaEl = (rank + 1) * (nEl / nRanks);
-    if (rank == 1 && nEl % 2 != 0) finaEl++;
+    /*--- Every rank owns the rows from the first one it touches, so the rows
+          of a strip are owned by it except the ones at the interface with the
+          previous strip. A rank without rows owns none, so the owned rows
+          are always among the touched ones. ---*/
+    std::vector<unsigned> ownLo(nRanks + 1, nRows);
+    for (int r = nRanks - 1; r > 0; r--) {
+        bool empty = ranges[2*r] >= ranges[2*r+1];
+        ownLo[r] = empty ? ownLo[r+1] : ranges[2*r];
+    }
+    ownLo[0] = 0;
+    for (int r = 1; r < nRanks; r++) {
+        ownLo[r] = std::max(ownLo[r], ownLo[r-1]);
+    }
 
-    // std::cout << initEl << finaEl << nEl << std::endl;
+    /*--- Only the rows touched by a rank and owned by another one are sent,
+          which are the rows of the nodes at the interface. ---*/
+    std::vector< std::vector<double> > recvBuf(nRanks);
+    std::vector<MPI_Request> requests;
+    for (int r = 0; r < nRanks; r++) {
+        if (r == rank) continue;
+        unsigned rLo = std::max(ranges[2*r], ownLo[rank]);
+        unsigned rHi = std::min(ranges[2*r+1], ownLo[rank+1]);
+        if (rLo < rHi) {
+            recvBuf[r].resize(rowPtr[rHi - first] - rowPtr[rLo - first]);
+            requests.push_back(MPI_Request());
+            MPI_Irecv(recvBuf[r].data(), recvBuf[r].size(), MPI_DOUBLE, r, 0,
+                      MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    for (int r = 0; r < nRanks; r++) {
+        if (r == rank) continue;
+        unsigned sLo = std::max(range[0], ownLo[r]);
+        unsigned sHi = std::min(range[1], ownLo[r+1]);
+        if (sLo < sHi) {
+            requests.push_back(MPI_Request());
+            MPI_Isend(&val[rowPtr[sLo - first]],
+                      rowPtr[sHi - first] - rowPtr[sLo - first], MPI_DOUBLE,
+                      r, 0, MPI_COMM_WORLD, &requests.back());
+        }
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
 
-    /*--- Computation of elemental conductance matrix and assembly of global
-          matrix. ---*/
-    for (unsigned e = initEl; e < finaEl; e++) {
-        eNodes(0, 0) = conn(e, 1);
-        eNodes(0, 1) = conn(e, 2);
-        eNodes(0, 2) = conn(e, 3);
-        eNodes(0, 3) = conn(e, 4);
-
-        eCoord(0, 0) = coor(eNodes(0, 0), 0);
-        eCoord(0, 1) = coor(eNodes(0, 0), 1);
-        eCoord(1, 0) = coor(eNodes(0, 1), 0);
-        eCoord(1, 1) = coor(eNodes(0, 1), 1);
-        eCoord(2, 0) = coor(eNodes(0, 2), 0);
-        eCoord(2, 1) = coor(eNodes(0, 2), 1);
-        eCoord(3, 0) = coor(eNodes(0, 3), 0);
-        eCoord(3, 1) = coor(eNodes(0, 3), 1);
-
-        CMatrix gDf = CMatrix(1, nNodPerEl, 0.0);
-        for (unsigned j = 0; j < nNodPerEl; j++) {
-            gDf(0, j) = glDof(eNodes(0, j), dfPerNod);
-        }
-
-        /*--- Elemental conductance with Gaussian quadrature. ---*/
-        CMatrix Ke = CMatrix(nNodPerEl, nNodPerEl, 0.0);
-        for (unsigned i = 0; i < gaussOrder; i++) {
-            for (unsigned j = 0; j < gaussOrder; j++) {
-                eta = gaussPoints(0, i);
-                xi = gaussPoints(0, j);
-
-                N(0, 0) = (1 - xi) * (1 - eta);
-                N(0, 1) = (1 + xi) * (1 - eta);
-                N(0, 2) = (1 + xi) * (1 + eta);
-                N(0, 3) = (1 - xi) * (1 + eta);
-
-                GN(0, 0) = 0.25 * (-(1 - eta));
-                GN(0, 1) = 0.25 * (1 - eta);
-                GN(0, 2) = 0.25 * (1 + eta);
-                GN(0, 3) = 0.25 * (-(1 + eta));
-                GN(1, 0) = 0.25 * (-(1 - xi));
-                GN(1, 1) = 0.25 * (-(1 + xi));
-                GN(1, 2) = 0.25 * (1 + xi);
-                GN(1, 3) = 0.25 * (1 - xi);
-
-                J = GN * eCoord;
-                detJ = J.determinant();
-                InvJ = J.inverse();
-                B = InvJ * GN;
-
-                Ke = Ke +
-                     B.transpose() * D * B * thick * detJ *
-                     gaussWeights(0, i) * gaussWeights(0, j);
-            }
+    /*--- Add the contributions to the owned rows. ---*/
+    for (int r = 0; r < nRanks; r++) {
+        if (recvBuf[r].empty()) continue;
+        unsigned pos = rowPtr[std::max(ranges[2*r], ownLo[rank]) - first];
+        for (unsigned k = 0; k < recvBuf[r].size(); k++) {
+            val[pos + k] += recvBuf[r][k];
+        }
+    }
+
+    /*--- The replicated solvers use the whole matrix in every rank, so the
+          owned rows, which are contiguous in the CSR storage, are broadcast
+          by their owner. The counts of MPI are int, so the blocks are sent in
+          chunks to support more than 2^31 entries. The distributed solver
+          only needs the owned rows and skips this step. ---*/
+    if (!gather) return ownLo;
+    const unsigned long long chunk = 1ULL << 27;
+    for (int r = 0; r < nRanks; r++) {
+        unsigned long long lo = rowPtr[ownLo[r]];
+        unsigned long long hi = rowPtr[ownLo[r+1]];
+        for (unsigned long long k = lo; k < hi; k += chunk) {
+            int count = std::min(chunk, hi - k);
+            MPI_Bcast(&val[k], count, MPI_DOUBLE, r, MPI_COMM_WORLD);
         }
+    }
 
-        /*--- Assembly of global conductance. ---*/
-        for (unsigned i = 0; i < nNodPerEl; i++) {
+    return ownLo;
+}
+
+unsigned CConductance::elementMatrices(const CGeometry& geo,
+                                       const CMaterial& mat, const CMesh& msh,
+                                       unsigned& initEl, unsigned& finaEl,
+                                       std::vector<unsigned>& elClass,
+                                       std::vector<double>& classKe) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    double thick = geo.getThickness();
+    unsigned nEl = msh.getNElem();
+    CMatrixFixed<2, 2> D;
+    const CMatrix& matD = mat.getConductivityMatrix();
+    D(0, 0) = matD(0, 0);
+    D(0, 1) = matD(0, 1);
+    D(1, 0) = matD(1, 0);
+    D(1, 1) = matD(1, 1);
+
+    int rank;
+    int nRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+    /*--- Divide the elements in contiguous blocks of balanced size. Elements
+          are numbered column by column, so every rank handles a strip of the
+          plate. ---*/
+    initEl = (unsigned long long) rank * nEl / nRanks;
+    finaEl = (unsigned long long) (rank + 1) * nEl / nRanks;
+
+    /*--- Elemental conductance matrices, computed once for every group of
+          elements with the same geometry. In a plate with constant height all
+          the elements are equal. ---*/
+    return elementClasses(msh, D, thick, initEl, finaEl, elClass, classKe);
+}
+
+template <typename F>
+void CConductance::scatter(const CMesh& msh, const unsigned initEl,
+                           const unsigned finaEl,
+                           const std::vector<unsigned>& elClass,
+                           const std::vector<double>& classKe, F add) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+
+    /*--- The elements of a color do not share nodes, so they never add to the
+          same entry and the threads scatter without atomics. ---*/
+    std::vector< std::vector<unsigned> > colors = msh.elementColors();
+    for (unsigned c = 0; c < colors.size(); c++) {
+        const std::vector<unsigned>& elems = colors[c];
+        #pragma omp parallel for schedule(static)
+        for (unsigned k = 0; k < elems.size(); k++) {
+            unsigned e = elems[k];
+            if (e < initEl || e >= finaEl) continue;
+            const double* Ke = &classKe[elClass[e - initEl]*nNodPerEl*nNodPerEl];
+            unsigned gDf[CConductanceKernel::maxNodes];
+            for (unsigned a = 0; a < nNodPerEl; a++) {
+                gDf[a] = glDof(conn(e, a + 1), dfPerNod);
+            }
             for (unsigned j = 0; j < nNodPerEl; j++) {
-                int iDof, jDof;
-                iDof = gDf(0, i);
-                jDof = gDf(0, j);
-                K(iDof, jDof) = K(iDof, jDof) + Ke(i, j);
+                for (unsigned i = 0; i < nNodPerEl; i++) {
+                    add(gDf[i], gDf[j], Ke[j*nNodPerEl+i]);
+                }
             }
         }
     }
+}
+
+CMatrixSparse CConductance::conductanceMtx(const CGeometry& geo,
+                                           const CMaterial& mat,
+                                           const CMesh& msh) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nDof = msh.getNDofTotal();
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    CMatrixSparse K = sparsityPattern(msh);
+    unsigned initEl, finaEl;
+    std::vector<unsigned> elClass;
+    std::vector<double> classKe;
+    nElemClasses = elementMatrices(geo, mat, msh, initEl, finaEl, elClass,
+                                   classKe);
 
-    // TODO: Improve communication to be faster!
-    /*--- Combine calculations from ranks 0 and 1 to obtain the final
-          conductance matrix. ---*/
+    /*--- Assembly of global conductance into the sparsity pattern. ---*/
+    scatter(msh, initEl, finaEl, elClass, classKe,
+            [&](unsigned i, unsigned j, double v) { K.addEntry(i, j, v); });
+
+    /*--- Combine the contributions of all the ranks, using the range of rows
+          touched by the elements of this rank. ---*/
+    int nRanks;
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
     if (nRanks > 1) {
-        if (rank == 0) {
-            CMatrix Krec = CMatrix(nDof, nDof, 0.0);
-            MPI_Send(&K(0, 0), nDof * nDof, MPI_DOUBLE, 1, 0, MPI_COMM_WORLD);
-            MPI_Recv(&Krec(0, 0), nDof * nDof, MPI_DOUBLE, 1, 1, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            K += Krec;
-        } else {
-            CMatrix Krec = CMatrix(nDof, nDof, 0.0);
-            MPI_Recv(&Krec(0, 0), nDof * nDof, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-            MPI_Send(&K(0, 0), nDof * nDof, MPI_DOUBLE, 0, 1, MPI_COMM_WORLD);
-            K += Krec;
+        unsigned range[2] = {nDof, 0};
+        for (unsigned e = initEl; e < finaEl; e++) {
+            for (unsigned a = 0; a < nNodPerEl; a++) {
+                unsigned dof = glDof(conn(e, a + 1), dfPerNod);
+                range[0] = std::min(range[0], dof);
+                range[1] = std::max(range[1], dof + 1);
+            }
         }
+        reduceRanks(nDof, range, 0, K.getRowPtrAddress(), K.getMtxAddress());
     }
 
     return K;
 }
 
+void CConductance::reducedMtx(const CGeometry& geo, const CMaterial& mat,
+                              const CMesh& msh,
+                              const CBoundaryConditions& bnd) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nDof = msh.getNDofTotal();
+    unsigned nEl = msh.getNElem();
+    unsigned nNodPerEl = msh.getNNodePerElem();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    std::vector<bool> known = bnd.getDirichletMask();
+    unsigned nTNod = bnd.getNTempNodes();
+    unsigned rDof = bnd.getNReducedDof();
+    int rank;
+    int nRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+    /*--- Position of every DOF in the known temperature or in the known flux
+          subvector. Both keep the order of the global DOF. ---*/
+    std::vector<unsigned> pos(nDof);
+    unsigned nE = 0, nF = 0;
+    for (unsigned i = 0; i < nDof; i++) {
+        pos[i] = known[i] ? nE++ : nF++;
+    }
+
+    /*--- Elemental matrices of the elements of this rank. The rows of the
+          blocks keep the order of the global DOF, so the rows touched by a
+          rank are a contiguous range. ---*/
+    unsigned initEl, finaEl;
+    std::vector<unsigned> elClass;
+    std::vector<double> classKe;
+    nElemClasses = elementMatrices(geo, mat, msh, initEl, finaEl, elClass,
+                                   classKe);
+    unsigned ffRange[2] = {rDof, 0};
+    unsigned efRange[2] = {nTNod, 0};
+    for (unsigned e = initEl; e < finaEl; e++) {
+        for (unsigned a = 0; a < nNodPerEl; a++) {
+            unsigned i = glDof(conn(e, a + 1), dfPerNod);
+            unsigned* range = known[i] ? efRange : ffRange;
+            range[0] = std::min(range[0], pos[i]);
+            range[1] = std::max(range[1], pos[i] + 1);
+        }
+    }
+
+    /*--- A distributed Kff only stores the rows touched by this rank, and the
+          others store all of them. ---*/
+    unsigned ffFirst = distributed ? ffRange[0] : 0;
+    unsigned ffLast = distributed ? std::max(ffRange[0], ffRange[1]) : rDof;
+
+    /*--- Patterns of the lower triangle of the stored rows of Kff and of
+          Kef. Every DOF is coupled with all the DOF of the elements it
+          belongs to, also the ones of other ranks. ---*/
+    std::vector< std::vector<unsigned> > ffCols(ffLast - ffFirst);
+    std::vector< std::vector<unsigned> > efCols(nTNod);
+    for (unsigned e = 0; e < nEl; e++) {
+        for (unsigned a = 0; a < nNodPerEl; a++) {
+            unsigned i = glDof(conn(e, a + 1), dfPerNod);
+            for (unsigned b = 0; b < nNodPerEl; b++) {
+                unsigned j = glDof(conn(e, b + 1), dfPerNod);
+                if (known[i] && !known[j]) {
+                    efCols[pos[i]].push_back(pos[j]);
+                } else if (!known[i] && !known[j] && j <= i &&
+                           pos[i] >= ffFirst && pos[i] < ffLast) {
+                    ffCols[pos[i] - ffFirst].push_back(pos[j]);
+                }
+            }
+        }
+    }
+    std::vector<unsigned> ffRowPtr(ffLast - ffFirst + 1, 0);
+    std::vector<unsigned> ffColIdx;
+    for (unsigned i = 0; i < ffLast - ffFirst; i++) {
+        std::sort(ffCols[i].begin(), ffCols[i].end());
+        ffCols[i].erase(std::unique(ffCols[i].begin(), ffCols[i].end()),
+                        ffCols[i].end());
+        ffColIdx.insert(ffColIdx.end(), ffCols[i].begin(), ffCols[i].end());
+        ffRowPtr[i + 1] = ffColIdx.size();
+    }
+    std::vector< std::vector<unsigned> >().swap(ffCols);
+    std::vector<unsigned> efRowPtr(nTNod + 1, 0);
+    std::vector<unsigned> efColIdx;
+    for (unsigned i = 0; i < nTNod; i++) {
+        std::sort(efCols[i].begin(), efCols[i].end());
+        efCols[i].erase(std::unique(efCols[i].begin(), efCols[i].end()),
+                        efCols[i].end());
+        efColIdx.insert(efColIdx.end(), efCols[i].begin(), efCols[i].end());
+        efRowPtr[i + 1] = efColIdx.size();
+    }
+    CMatrixSparse ffTouched;
+    if (distributed) {
+        ffTouched = CMatrixSparse(ffLast - ffFirst, rDof, ffRowPtr.data(),
+                                  ffColIdx.data(), 0.0);
+    } else {
+        conducFF = CMatrixSparseSymmetric(rDof, rDof, ffRowPtr.data(),
+                                          ffColIdx.data(), 0.0);
+    }
+    conducEF = CMatrixSparse(nTNod, rDof, efRowPtr.data(), efColIdx.data(),
+                             0.0);
+    conducEE = CMatrix(nTNod, nTNod, 0.0);
+
+    /*--- Assembly of every entry of the element matrices in its block. The
+          entries of Kfe are the transpose of Kef and are not stored. ---*/
+    scatter(msh, initEl, finaEl, elClass, classKe,
+            [&](unsigned i, unsigned j, double v) {
+                if (known[i] && known[j]) {
+                    conducEE(pos[i], pos[j]) += v;
+                } else if (known[i]) {
+                    conducEF.addEntry(pos[i], pos[j], v);
+                } else if (!known[j] && j <= i) {
+                    if (distributed) {
+                        ffTouched.addEntry(pos[i] - ffFirst, pos[j], v);
+                    } else {
+                        conducFF.addEntry(pos[i], pos[j], v);
+                    }
+                }
+            });
+
+    /*--- Combine the contributions of all the ranks. Kee only couples the
+          nodes of the temperature boundary and is summed directly. ---*/
+    ffRowOffsets.assign(1, 0);
+    ffRowOffsets.resize(nRanks + 1, rDof);
+    if (nRanks > 1) {
+        if (distributed) {
+            ffRowOffsets = reduceRanks(rDof, ffRange, ffFirst,
+                                       ffTouched.getRowPtrAddress(),
+                                       ffTouched.getMtxAddress(), false);
+        } else {
+            reduceRanks(rDof, ffRange, 0, conducFF.getRowPtrAddress(),
+                        conducFF.getMtxAddress());
+        }
+        reduceRanks(nTNod, efRange, 0, conducEF.getRowPtrAddress(),
+                    conducEF.getMtxAddress());
+        MPI_Allreduce(MPI_IN_PLACE, conducEE.getMtxAddress(), nTNod*nTNod,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+
+    /*--- A distributed Kff keeps the owned rows, which are complete, and
+          releases the touched rows of the other ranks. ---*/
+    if (!distributed) return;
+    unsigned ownFirst = ffRowOffsets[rank];
+    unsigned nOwn = ffRowOffsets[rank + 1] - ownFirst;
+    if (nOwn > 0 && (ownFirst < ffFirst || ownFirst + nOwn > ffLast))
+        throw std::runtime_error("Owned rows of Kff not assembled by the rank");
+    unsigned* tRowPtr = ffTouched.getRowPtrAddress();
+    unsigned* tColIdx = ffTouched.getColIdxAddress();
+    double* tPtr = ffTouched.getMtxAddress();
+    unsigned shift = nOwn > 0 ? ownFirst - ffFirst : 0;
+    std::vector<unsigned> ownRowPtr(nOwn + 1, 0);
+    for (unsigned i = 0; i < nOwn; i++) {
+        ownRowPtr[i + 1] = tRowPtr[shift + i + 1] - tRowPtr[shift];
+    }
+    conducFFRows = CMatrixSparse(nOwn, rDof, ownRowPtr.data(),
+                                 &tColIdx[tRowPtr[shift]], 0.0);
+    std::copy(&tPtr[tRowPtr[shift]], &tPtr[tRowPtr[shift + nOwn]],
+              conducFFRows.getMtxAddress());
+}
+
 #endif
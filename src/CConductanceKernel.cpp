@@ -0,0 +1,214 @@
+/*!
+ * @file CConductanceKernel.cpp
+ * @brief The main subroutines for computing the conductance matrices of a
+ *        batch of bilinear elements with SIMD instructions.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CCONDUCTANCEKERNEL_CPP
+#define __CCONDUCTANCEKERNEL_CPP
+
+#include <string>
+#include <stdexcept>
+
+#include "../include/CConductanceKernel.hpp"
+#include "../include/CMatrixFixed.hpp"
+#include "../include/CShapeFunctions.hpp"
+
+/*--- The vector kernels need the GCC vector extensions and the x86 function
+      multiversioning, otherwise only the scalar kernel is built. ---*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HEAT_SIMD_X86
+typedef double v4d __attribute__((vector_size(32)));
+typedef double v8d __attribute__((vector_size(64)));
+#endif
+
+CConductanceKernel::TKernel CConductanceKernel::kernel = nullptr;
+
+std::string CConductanceKernel::isaName = "";
+
+std::string CConductanceKernel::detectInstructionSet() {
+#ifdef HEAT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return "avx2";
+#endif
+    return "scalar";
+}
+
+template <typename V, unsigned N>
+__attribute__((always_inline)) inline
+void CConductanceKernel::computeLanes(const CShapeFunctions& shape,
+                                      const double* eCoord, const double* D,
+                                      const double thick, double* Ke) {
+    /*--- Initialize variables to be used in the subroutine. Every variable of
+          type V holds the same quantity for consecutive elements. ---*/
+    const unsigned S = batchSize;
+    V x[N], y[N], K[N*N];
+    for (unsigned a = 0; a < N; a++) {
+        __builtin_memcpy(&x[a], &eCoord[a*S], sizeof(V));
+        __builtin_memcpy(&y[a], &eCoord[(N+a)*S], sizeof(V));
+    }
+    for (unsigned k = 0; k < N*N; k++) {
+        K[k] = V{};
+    }
+
+    /*--- Same operations as the scalar elemental conductance, with the 2x2
+          Jacobian inverted in closed form. ---*/
+    for (unsigned q = 0; q < shape.getNQuadPoints(); q++) {
+        const double* dXi = shape.getQuadDXi(q);
+        const double* dEta = shape.getQuadDEta(q);
+        V J00 = x[0] * dXi[0];
+        V J01 = y[0] * dXi[0];
+        V J10 = x[0] * dEta[0];
+        V J11 = y[0] * dEta[0];
+        for (unsigned a = 1; a < N; a++) {
+            J00 += x[a] * dXi[a];
+            J01 += y[a] * dXi[a];
+            J10 += x[a] * dEta[a];
+            J11 += y[a] * dEta[a];
+        }
+        V detJ = J00 * J11 - J01 * J10;
+        V invDet = 1.0 / detJ;
+
+        /*--- B = inv(J)*GN and D*B. ---*/
+        V B0[N], B1[N], DB0[N], DB1[N];
+        for (unsigned a = 0; a < N; a++) {
+            B0[a] = (J11 * dXi[a] - J01 * dEta[a]) * invDet;
+            B1[a] = (J00 * dEta[a] - J10 * dXi[a]) * invDet;
+            DB0[a] = D[0] * B0[a] + D[2] * B1[a];
+            DB1[a] = D[1] * B0[a] + D[3] * B1[a];
+        }
+
+        /*--- Ke += B'*D*B*t*detJ*w. ---*/
+        V w = detJ * (thick * shape.getQuadWeight(q));
+        for (unsigned b = 0; b < N; b++) {
+            V wDB0 = w * DB0[b];
+            V wDB1 = w * DB1[b];
+            for (unsigned a = 0; a < N; a++) {
+                K[b*N+a] += B0[a] * wDB0 + B1[a] * wDB1;
+            }
+        }
+    }
+
+    for (unsigned k = 0; k < N*N; k++) {
+        __builtin_memcpy(&Ke[k*S], &K[k], sizeof(V));
+    }
+}
+
+template <typename V>
+__attribute__((always_inline)) inline
+void CConductanceKernel::computeElements(const CShapeFunctions& shape,
+                                         const double* eCoord, const double* D,
+                                         const double thick, double* Ke) {
+    /*--- The number of nodes is a template parameter, so the loops over the
+          nodes are unrolled for every element. ---*/
+    switch (shape.getNNodes()) {
+        case 8:
+            computeLanes<V, 8>(shape, eCoord, D, thick, Ke);
+            break;
+        case 9:
+            computeLanes<V, 9>(shape, eCoord, D, thick, Ke);
+            break;
+        default:
+            computeLanes<V, 4>(shape, eCoord, D, thick, Ke);
+    }
+}
+
+void CConductanceKernel::computeScalar(const CShapeFunctions& shape,
+                                       const double* eCoord, const double* D,
+                                       const double thick, double* Ke) {
+    for (unsigned l = 0; l < batchSize; l++) {
+        computeElements<double>(shape, eCoord + l, D, thick, Ke + l);
+    }
+}
+
+#ifdef HEAT_SIMD_X86
+__attribute__((target("avx2,fma")))
+void CConductanceKernel::computeAVX2(const CShapeFunctions& shape,
+                                     const double* eCoord, const double* D,
+                                     const double thick, double* Ke) {
+    for (unsigned l = 0; l < batchSize; l += 4) {
+        computeElements<v4d>(shape, eCoord + l, D, thick, Ke + l);
+    }
+}
+
+__attribute__((target("avx512f")))
+void CConductanceKernel::computeAVX512(const CShapeFunctions& shape,
+                                       const double* eCoord, const double* D,
+                                       const double thick, double* Ke) {
+    computeElements<v8d>(shape, eCoord, D, thick, Ke);
+}
+#else
+void CConductanceKernel::computeAVX2(const CShapeFunctions& shape,
+                                     const double* eCoord, const double* D,
+                                     const double thick, double* Ke) {
+    computeScalar(shape, eCoord, D, thick, Ke);
+}
+
+void CConductanceKernel::computeAVX512(const CShapeFunctions& shape,
+                                       const double* eCoord, const double* D,
+                                       const double thick, double* Ke) {
+    computeScalar(shape, eCoord, D, thick, Ke);
+}
+#endif
+
+std::string CConductanceKernel::getInstructionSet() {
+    if (kernel == nullptr) setInstructionSet(detectInstructionSet());
+    return isaName;
+}
+
+bool CConductanceKernel::isSupported(const std::string& isa) {
+    if (isa == "scalar") return true;
+    std::string best = detectInstructionSet();
+    if (isa == "avx2") return best == "avx2" || best == "avx512";
+    if (isa == "avx512") return best == "avx512";
+    return false;
+}
+
+void CConductanceKernel::setInstructionSet(const std::string& isa) {
+    if (!isSupported(isa))
+        throw std::runtime_error("Instruction set not supported");
+    if (isa == "avx512") {
+        kernel = &computeAVX512;
+    } else if (isa == "avx2") {
+        kernel = &computeAVX2;
+    } else {
+        kernel = &computeScalar;
+    }
+    isaName = isa;
+}
+
+void CConductanceKernel::compute(const CShapeFunctions& shape,
+                                 const double* eCoord,
+                                 const CMatrixFixed<2, 2>& D,
+                                 const double thick, double* Ke) {
+    /*--- The instruction set is detected the first time a batch is computed. ---*/
+    if (kernel == nullptr) setInstructionSet(detectInstructionSet());
+    const double DPtr[4] = {D(0, 0), D(1, 0), D(0, 1), D(1, 1)};
+    kernel(shape, eCoord, DPtr, thick, Ke);
+}
+
+#endif
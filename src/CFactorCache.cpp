@@ -0,0 +1,437 @@
+/*!
+ * @file CFactorCache.cpp
+ * @brief The main subroutines for caching the submatrices and the
+ *        factorization of the reduced system between solutions.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CFACTORCACHE_CPP
+#define __CFACTORCACHE_CPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <mpi.h>
+
+#include "../include/CFactorCache.hpp"
+#include "../include/CGeometry.hpp"
+#include "../include/CMaterial.hpp"
+#include "../include/CMesh.hpp"
+#include "../include/CBoundaryConditions.hpp"
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CSparseCholesky.hpp"
+
+CFactorCache::CFactorCache() {
+    /*--- Initialize properties. ---*/
+    maxBytes = std::numeric_limits<size_t>::max();
+    usedBytes = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    nHits = 0;
+    nMisses = 0;
+    nEvictions = 0;
+    nDiskEvictions = 0;
+}
+
+CFactorCache::CFactorCache(const size_t maxSize, const std::string dir) {
+    /*--- Initialize properties. ---*/
+    maxBytes = maxSize;
+    usedBytes = 0;
+    directory = dir;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    nHits = 0;
+    nMisses = 0;
+    nEvictions = 0;
+    nDiskEvictions = 0;
+}
+
+CFactorCache::~CFactorCache() {}
+
+unsigned CFactorCache::getNHits() const {
+    return nHits;
+}
+
+unsigned CFactorCache::getNMisses() const {
+    return nMisses;
+}
+
+unsigned CFactorCache::getNEvictions() const {
+    return nEvictions;
+}
+
+unsigned CFactorCache::getNDiskEvictions() const {
+    return nDiskEvictions;
+}
+
+unsigned CFactorCache::getNEntries() const {
+    return entries.size();
+}
+
+size_t CFactorCache::getUsedBytes() const {
+    return usedBytes;
+}
+
+std::string CFactorCache::computeKey(const CGeometry& geo,
+                                     const CMaterial& mat, const CMesh& msh,
+                                     const CBoundaryConditions& bnd) {
+    /*--- FNV-1a hash of the bytes of every input that changes K or its
+          partition. ---*/
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* data, size_t n) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < n; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    double real[8] = {geo.getAConst(), geo.getHeightLeft(),
+                      geo.getHeightRight(), geo.getLength(),
+                      geo.getThickness(), mat.getKXX(), mat.getKXY(),
+                      mat.getKYY()};
+    unsigned integer[5] = {msh.getNXDirElem(), msh.getNYDirElem(),
+                           msh.getNNodePerElem(), bnd.getGaussOrder(),
+                           bnd.getNTempNodes()};
+    add(real, sizeof(real));
+    add(integer, sizeof(integer));
+    const CMatrixIndex& tpNod = bnd.getTempNodes();
+    for (unsigned i = 0; i < bnd.getNTempNodes(); i++) {
+        unsigned node = tpNod(0, i);
+        add(&node, sizeof(node));
+    }
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+    return key.str();
+}
+
+const CFactorCache::Entry& CFactorCache::getEntry(const std::string& key) const {
+    std::map<std::string, Entry>::const_iterator it = entries.find(key);
+    if (it == entries.end())
+        throw std::runtime_error("Entry not in the cache");
+    return it->second;
+}
+
+const CMatrix& CFactorCache::getKee(const std::string& key) const {
+    return getEntry(key).Kee;
+}
+
+const CMatrixSparse& CFactorCache::getKef(const std::string& key) const {
+    return getEntry(key).Kef;
+}
+
+const CMatrixSparseSymmetric& CFactorCache::getKff(const std::string& key) const {
+    return getEntry(key).Kff;
+}
+
+bool CFactorCache::isFactored(const std::string& key) const {
+    return getEntry(key).isFactored;
+}
+
+const CSparseCholesky<double>& CFactorCache::getFactor(
+        const std::string& key) const {
+    const Entry& entry = getEntry(key);
+    if (!entry.isFactored)
+        throw std::runtime_error("Entry of the cache without factor");
+    return entry.factor;
+}
+
+size_t CFactorCache::entryBytes(const Entry& entry) {
+    size_t bytes = entry.Kee.getRows()*entry.Kee.getCols()*sizeof(double);
+    bytes += (entry.Kef.getRows() + 1)*sizeof(unsigned) +
+             entry.Kef.getNNonZero()*(sizeof(unsigned) + sizeof(double));
+    bytes += (entry.Kff.getRows() + 1)*sizeof(unsigned) +
+             entry.Kff.getNNonZero()*(sizeof(unsigned) + sizeof(double));
+    if (entry.isFactored) bytes += entry.factor.getBytes();
+    return bytes;
+}
+
+void CFactorCache::touch(const std::string& key) {
+    /*--- Move the key to the front of the recency list. ---*/
+    Entry& entry = entries[key];
+    recency.erase(entry.use);
+    recency.push_front(key);
+    entry.use = recency.begin();
+
+    /*--- Evict from the back, never the entry just used. ---*/
+    while (usedBytes > maxBytes && recency.size() > 1) {
+        std::map<std::string, Entry>::iterator old = entries.find(recency.back());
+        usedBytes -= old->second.bytes;
+        entries.erase(old);
+        recency.pop_back();
+        nEvictions++;
+    }
+}
+
+bool CFactorCache::contains(const std::string& key) const {
+    return entries.count(key) > 0;
+}
+
+void CFactorCache::erase(const std::string& key) {
+    std::map<std::string, Entry>::iterator it = entries.find(key);
+    if (it == entries.end()) return;
+    usedBytes -= it->second.bytes;
+    recency.erase(it->second.use);
+    entries.erase(it);
+}
+
+bool CFactorCache::find(const std::string& key) {
+    /*--- It is a hit only if every rank finds the entry. Otherwise the ranks
+          that found it drop it, so that all of them assemble the
+          submatrices, which takes collective communication. ---*/
+    int isFound = (entries.count(key) || readEntry(key)) ? 1 : 0;
+    int isFoundAll = 0;
+    MPI_Allreduce(&isFound, &isFoundAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (isFoundAll) {
+        touch(key);
+        nHits++;
+        if (!directory.empty() && rank == 0)
+            utime(getPath(key, "mtx").c_str(), nullptr);
+        return true;
+    }
+    erase(key);
+    nMisses++;
+    return false;
+}
+
+void CFactorCache::insert(const std::string& key, const CMatrix& Kee,
+                          const CMatrixSparse& Kef,
+                          const CMatrixSparseSymmetric& Kff) {
+    /*--- A new entry replaces the old one with the same key. ---*/
+    if (entries.count(key)) {
+        usedBytes -= entries[key].bytes;
+        recency.erase(entries[key].use);
+    }
+    recency.push_front(key);
+    Entry& entry = entries[key];
+    entry.Kee = Kee;
+    entry.Kef = Kef;
+    entry.Kff = Kff;
+    entry.factor = CSparseCholesky<double>();
+    entry.isFactored = false;
+    entry.bytes = entryBytes(entry);
+    entry.use = recency.begin();
+    usedBytes += entry.bytes;
+    touch(key);
+
+    /*--- Submatrices on disk, written by a single rank. ---*/
+    if (directory.empty() || rank != 0) return;
+    std::ostringstream out;
+    unsigned nRows = Kee.getRows();
+    unsigned nCols = Kee.getCols();
+    out.write(reinterpret_cast<const char*>(&nRows), sizeof(nRows));
+    out.write(reinterpret_cast<const char*>(&nCols), sizeof(nCols));
+    out.write(reinterpret_cast<const char*>(Kee.getMtxAddress()),
+              nRows*nCols*sizeof(double));
+    writeSparse(out, Kef);
+    writeSparse(out, Kff);
+    writeFile(getPath(key, "mtx"), out.str());
+    evictDisk(key);
+}
+
+void CFactorCache::insertFactor(const std::string& key,
+                                const CSparseCholesky<double>& factor) {
+    getEntry(key);
+    Entry& entry = entries[key];
+    usedBytes -= entry.bytes;
+    entry.factor = factor;
+    entry.isFactored = true;
+    entry.bytes = entryBytes(entry);
+    usedBytes += entry.bytes;
+    touch(key);
+
+    /*--- Factor on disk, next to the submatrices. ---*/
+    if (directory.empty() || rank != 0) return;
+    std::ostringstream out;
+    factor.write(out);
+    writeFile(getPath(key, "chol"), out.str());
+    evictDisk(key);
+}
+
+std::string CFactorCache::getPath(const std::string& key,
+                                  const std::string ext) const {
+    return directory + "/" + key + "." + ext;
+}
+
+void CFactorCache::evictDisk(const std::string& key) {
+    /*--- Size and last use of every entry on disk, which is the latest
+          modification time of its files. ---*/
+    std::map<std::string, std::pair<size_t, double> > files;
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) return;
+    for (struct dirent* ent = readdir(dir); ent != nullptr; ent = readdir(dir)) {
+        std::string name = ent->d_name;
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos) continue;
+        std::string ext = name.substr(dot + 1);
+        if (ext != "mtx" && ext != "chol") continue;
+        struct stat info;
+        if (stat((directory + "/" + name).c_str(), &info) != 0) continue;
+        std::pair<size_t, double>& file = files[name.substr(0, dot)];
+        file.first += info.st_size;
+        file.second = std::max(file.second, info.st_mtim.tv_sec +
+                                            1e-9*info.st_mtim.tv_nsec);
+    }
+    closedir(dir);
+
+    size_t diskBytes = 0;
+    std::vector<std::pair<double, std::string> > byAge;
+    for (std::map<std::string, std::pair<size_t, double> >::iterator it =
+             files.begin(); it != files.end(); ++it) {
+        diskBytes += it->second.first;
+        if (it->first != key) byAge.push_back(std::make_pair(it->second.second,
+                                                             it->first));
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    /*--- Evict the oldest, never the entry just written or used. ---*/
+    for (unsigned i = 0; i < byAge.size() && diskBytes > maxBytes; i++) {
+        const std::string& old = byAge[i].second;
+        std::remove(getPath(old, "mtx").c_str());
+        std::remove(getPath(old, "chol").c_str());
+        diskBytes -= files[old].first;
+        nDiskEvictions++;
+    }
+}
+
+void CFactorCache::writeFile(const std::string& path, const std::string& data) {
+    std::string tmpPath = path + ".tmp" + std::to_string(getpid());
+    std::ofstream file(tmpPath, std::ios::binary);
+    file.write(data.data(), data.size());
+    file.close();
+    if (!file || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Cannot write the cache entry " + path);
+    }
+}
+
+bool CFactorCache::readEntry(const std::string& key) {
+    if (directory.empty()) return false;
+    std::ifstream file(getPath(key, "mtx"), std::ios::binary);
+    if (!file.good()) return false;
+
+    /*--- Submatrices. A truncated or corrupted file is removed and the
+          lookup becomes a miss, so the submatrices are assembled again. ---*/
+    Entry entry;
+    try {
+        unsigned nRows = 0;
+        unsigned nCols = 0;
+        file.read(reinterpret_cast<char*>(&nRows), sizeof(nRows));
+        file.read(reinterpret_cast<char*>(&nCols), sizeof(nCols));
+        if (!file) throw std::runtime_error("Corrupted cache entry " + key);
+        entry.Kee = CMatrix(nRows, nCols, 0.0);
+        file.read(reinterpret_cast<char*>(entry.Kee.getMtxAddress()),
+                  nRows*nCols*sizeof(double));
+        entry.Kef = readSparse<CMatrixSparse>(file);
+        entry.Kff = readSparse<CMatrixSparseSymmetric>(file);
+        if (!file || file.peek() != EOF || nRows != nCols ||
+            entry.Kef.getRows() != nRows ||
+            entry.Kef.getCols() != entry.Kff.getRows() ||
+            entry.Kff.getCols() != entry.Kff.getRows())
+            throw std::runtime_error("Corrupted cache entry " + key);
+    } catch (const std::exception&) {
+        std::remove(getPath(key, "mtx").c_str());
+        std::remove(getPath(key, "chol").c_str());
+        return false;
+    }
+
+    /*--- Factor if it was written. A corrupted factor is computed again. ---*/
+    std::ifstream cholFile(getPath(key, "chol"), std::ios::binary);
+    entry.isFactored = false;
+    if (cholFile.good()) {
+        try {
+            entry.factor.read(cholFile);
+            if (entry.factor.getSize() != entry.Kff.getRows())
+                throw std::runtime_error("Corrupted cache entry " + key);
+            entry.isFactored = true;
+        } catch (const std::exception&) {
+            entry.factor = CSparseCholesky<double>();
+            std::remove(getPath(key, "chol").c_str());
+        }
+    }
+    entry.bytes = entryBytes(entry);
+
+    recency.push_front(key);
+    entry.use = recency.begin();
+    entries[key] = entry;
+    usedBytes += entry.bytes;
+
+    return true;
+}
+
+template <typename M>
+void CFactorCache::writeSparse(std::ostream& out, const M& A) {
+    unsigned size[3] = {A.getRows(), A.getCols(), A.getNNonZero()};
+    out.write(reinterpret_cast<const char*>(size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(A.getRowPtrAddress()),
+              (size[0] + 1)*sizeof(unsigned));
+    out.write(reinterpret_cast<const char*>(A.getColIdxAddress()),
+              size[2]*sizeof(unsigned));
+    out.write(reinterpret_cast<const char*>(A.getMtxAddress()),
+              size[2]*sizeof(double));
+}
+
+template <typename M>
+M CFactorCache::readSparse(std::istream& in) {
+    unsigned size[3] = {0, 0, 0};
+    in.read(reinterpret_cast<char*>(size), sizeof(size));
+    std::vector<unsigned> rowPtr(size[0] + 1, 0);
+    std::vector<unsigned> colIdx(size[2]);
+    in.read(reinterpret_cast<char*>(rowPtr.data()),
+            (size[0] + 1)*sizeof(unsigned));
+    in.read(reinterpret_cast<char*>(colIdx.data()), size[2]*sizeof(unsigned));
+
+    /*--- Pointers from zero to the number of entries and columns below the
+          number of columns, so a damaged file can not index out of the
+          matrix. ---*/
+    bool isValid = in && rowPtr[0] == 0 && rowPtr[size[0]] == size[2];
+    for (unsigned i = 0; i < size[0] && isValid; i++) {
+        isValid = rowPtr[i] <= rowPtr[i + 1];
+    }
+    for (unsigned k = 0; k < size[2] && isValid; k++) {
+        isValid = colIdx[k] < size[1];
+    }
+    if (!isValid)
+        throw std::runtime_error("Corrupted sparse matrix in the cache");
+    M A(size[0], size[1], rowPtr.data(), colIdx.data(), 0.0);
+    in.read(reinterpret_cast<char*>(A.getMtxAddress()), size[2]*sizeof(double));
+
+    return A;
+}
+
+#endif
@@ -30,66 +30,146 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
 
 #include "../include/CHeatConduction.hpp"
 #include "../include/CBoundaryConditions.hpp"
 #include "../include/CConductance.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CMatrixBanded.hpp"
+#include "../include/CMatrixFree.hpp"
+#include "../include/CMatrixDistributed.hpp"
+#include "../include/CSparseCholesky.hpp"
+#include "../include/CFactorCache.hpp"
 #include "../include/CMesh.hpp"
 #include "../include/CLinearSystem.hpp"
+#include "../include/CPreconditioner.hpp"
+#include "../include/CMultigrid.hpp"
+#include "../include/CAlgebraicMultigrid.hpp"
 #include "../include/CMaterial.hpp"
 
-CHeatConduction::CHeatConduction() {}
+CHeatConduction::CHeatConduction() {
+    /*--- Initialize properties. ---*/
+    precondType = "none";
+    solverType = "cg";
+    cycleType = "V";
+    cgMethod = "classic";
+    sStep = 4;
+    sBasis = "newton";
+    nIterations = 0;
+    halfBandwidth = 0;
+    cache = nullptr;
+}
 
 CHeatConduction::CHeatConduction(const CBoundaryConditions& bnd,
                                  const CConductance& cnd,
                                  const CMesh& msh) {
+    /*--- Initialize properties. ---*/
+    precondType = "none";
+    solverType = "cg";
+    cycleType = "V";
+    cgMethod = "classic";
+    sStep = 4;
+    sBasis = "newton";
+    nIterations = 0;
+    halfBandwidth = 0;
+    cache = nullptr;
+
+    /*--- Solve heat conduction problem. ---*/
+    partitionMatrices(bnd, cnd);
+    temp = solveTemperature(msh, bnd, cnd);
+    flux = solveFlux(msh, bnd, cnd);
+}
+
+CHeatConduction::CHeatConduction(const CBoundaryConditions& bnd,
+                                 const CConductance& cnd,
+                                 const CMesh& msh,
+                                 const std::string precond,
+                                 const std::string solver,
+                                 const std::string cycle,
+                                 const std::string method,
+                                 const unsigned s,
+                                 const std::string basis,
+                                 CFactorCache* factorCache,
+                                 const std::string key) {
+    /*--- Initialize properties. ---*/
+    precondType = precond;
+    solverType = solver;
+    cycleType = cycle;
+    cgMethod = method;
+    sStep = s;
+    sBasis = basis;
+    nIterations = 0;
+    halfBandwidth = 0;
+    cache = factorCache;
+    cacheKey = key;
+
     /*--- Solve heat conduction problem. ---*/
     partitionMatrices(bnd, cnd);
-    temp = solveTemperature(msh, bnd);
-    flux = solveFlux(msh, bnd);
+    temp = solveTemperature(msh, bnd, cnd);
+    flux = solveFlux(msh, bnd, cnd);
 }
 
 CHeatConduction::~CHeatConduction() {}
 
-CMatrix CHeatConduction::getKee() const {
+const CMatrix& CHeatConduction::getKee() const {
     return Kee;
 }
 
-CMatrix CHeatConduction::getKff() const {
+const CMatrixSparseSymmetric& CHeatConduction::getKff() const {
     return Kff;
 }
 
-CMatrix CHeatConduction::getKef() const {
+const CMatrixSparse& CHeatConduction::getKef() const {
     return Kef;
 }
 
-CMatrix CHeatConduction::getTe() const {
+const CMatrix& CHeatConduction::getTe() const {
     return Te;
 }
 
-CMatrix CHeatConduction::getFf() const {
+const CMatrix& CHeatConduction::getFf() const {
     return Ff;
 }
 
 
-CMatrix CHeatConduction::getTemp() const {
+const CMatrix& CHeatConduction::getTemp() const {
     return temp;
 }
 
-CMatrix CHeatConduction::getFlux() const {
+const CMatrix& CHeatConduction::getFlux() const {
     return flux;
 }
 
+unsigned CHeatConduction::getNIterations() const {
+    return nIterations;
+}
+
+const std::vector<double>& CHeatConduction::getIterationTimes() const {
+    return iterationTimes;
+}
+
+unsigned CHeatConduction::getHalfBandwidth() const {
+    return halfBandwidth;
+}
+
 void CHeatConduction::partitionMatrices(const CBoundaryConditions& bnd,
                                         const CConductance& cnd) {
     /*--- Initialize variables to be used in the subroutine. ---*/
     unsigned nTNod = bnd.getNTempNodes();
-    CMatrix tpNod = bnd.getTempNodes();
+    const CMatrixIndex& tpNod = bnd.getTempNodes();
     unsigned rDof = bnd.getNReducedDof();
-    CMatrix rDofVec = bnd.getReducedDofVector();
-    CMatrix T = bnd.getTempBCVector();
-    CMatrix f = bnd.getFluxBCVector();
-    CMatrix K = cnd.getConducMtx();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+    const CMatrix& T = bnd.getTempBCVector();
+    const CMatrix& f = bnd.getFluxBCVector();
+    const CMatrixSparse& K = cnd.getConducMtx();
+    unsigned nDof = K.getRows();
+    unsigned* rowPtr = K.getRowPtrAddress();
+    unsigned* colIdx = K.getColIdxAddress();
+    double* KPtr = K.getMtxAddress();
 
     /*--- Te subvector. ---*/
     Te = CMatrix(nTNod, 1, 0.0);
@@ -103,47 +183,208 @@ void CHeatConduction::partitionMatrices(const CBoundaryConditions& bnd,
         Ff(i, 0) =  f(rDofVec(0, i), 0);
     }
 
-    /*--- Kee submatrix. ---*/
-    Kee = CMatrix(nTNod, nTNod, 0.0);
-    for (unsigned i = 0; i < nTNod; i++) {
-        for (unsigned j = 0; j < nTNod; j++) {
-            Kee(i, j) = K(tpNod(0, i), tpNod(0, j));
-        }
+    /*--- The matrix-free solver does not assemble the submatrices. ---*/
+    if (solverType == "matrix-free") return;
+
+    /*--- Submatrices kept by the cache from a previous problem. ---*/
+    if (cache != nullptr && cache->contains(cacheKey)) {
+        Kee = cache->getKee(cacheKey);
+        Kef = cache->getKef(cacheKey);
+        Kff = cache->getKff(cacheKey);
+        return;
     }
 
-    /*--- Kff submatrix. ---*/
-    Kff = CMatrix(rDof, rDof, 0.0);
-    for (unsigned i = 0; i < rDof; i++) {
-        for (unsigned j = 0; j < rDof; j++) {
-            Kff(i, j) = K(rDofVec(0, i), rDofVec(0, j));
-        }
+    /*--- Submatrices assembled directly by the conductance. A distributed
+          Kff is only kept by the conductance as the owned rows of every
+          rank, which only the distributed solver handles. ---*/
+    if (cnd.isDistributed() && solverType != "distributed")
+        throw std::runtime_error("Distributed conductance needs the distributed solver");
+    if (cnd.isReduced()) {
+        Kee = cnd.getConducEE();
+        Kef = cnd.getConducEF();
+        if (cnd.isDistributed()) return;
+        Kff = cnd.getConducFF();
+        if (cache != nullptr) cache->insert(cacheKey, Kee, Kef, Kff);
+        return;
     }
 
-    /*--- Kef submatrix. ---*/
-    Kef = CMatrix(nTNod, rDof, 0.0);
+    /*--- Position of every global DOF in the known temperature or known flux
+          subvectors. A value of -1 means that the DOF is not in the subvector. ---*/
+    std::vector<int> tpPos(nDof, -1);
+    std::vector<int> rDofPos(nDof, -1);
     for (unsigned i = 0; i < nTNod; i++) {
-        for (unsigned j = 0; j < rDof; j++) {
-            Kef(i, j) = K(tpNod(0, i), rDofVec(0, j));
+        tpPos[tpNod(0, i)] = i;
+    }
+    for (unsigned i = 0; i < rDof; i++) {
+        rDofPos[rDofVec(0, i)] = i;
+    }
+
+    /*--- Kee from the stored entries of K. Patterns of Kef and of the lower
+          triangle of Kff, which keep the order of the global DOF. ---*/
+    Kee = CMatrix(nTNod, nTNod, 0.0);
+    std::vector<unsigned> efRowPtr(nTNod + 1, 0);
+    std::vector<unsigned> efColIdx;
+    std::vector<unsigned> efPos;
+    std::vector<unsigned> ffRowPtr(rDof + 1, 0);
+    std::vector<unsigned> ffColIdx;
+    std::vector<unsigned> ffPos;
+    for (unsigned i = 0; i < nDof; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            if (tpPos[i] >= 0 && tpPos[j] >= 0) {
+                Kee(tpPos[i], tpPos[j]) = KPtr[k];
+            } else if (rDofPos[i] >= 0 && rDofPos[j] >= 0) {
+                if (j <= i) {
+                    ffColIdx.push_back(rDofPos[j]);
+                    ffPos.push_back(k);
+                }
+            } else if (tpPos[i] >= 0) {
+                efColIdx.push_back(rDofPos[j]);
+                efPos.push_back(k);
+            }
         }
+        if (tpPos[i] >= 0) efRowPtr[tpPos[i] + 1] = efColIdx.size();
+        if (rDofPos[i] >= 0) ffRowPtr[rDofPos[i] + 1] = ffColIdx.size();
+    }
+
+    /*--- Kef in sparse storage and Kff in symmetric sparse storage. ---*/
+    Kef = CMatrixSparse(nTNod, rDof, efRowPtr.data(), efColIdx.data(), 0.0);
+    double* KefPtr = Kef.getMtxAddress();
+    for (unsigned k = 0; k < efPos.size(); k++) {
+        KefPtr[k] = KPtr[efPos[k]];
+    }
+    Kff = CMatrixSparseSymmetric(rDof, rDof, ffRowPtr.data(), ffColIdx.data(),
+                                 0.0);
+    double* KffPtr = Kff.getMtxAddress();
+    for (unsigned k = 0; k < ffPos.size(); k++) {
+        KffPtr[k] = KPtr[ffPos[k]];
     }
+    if (cache != nullptr) cache->insert(cacheKey, Kee, Kef, Kff);
+}
+
+template <typename T>
+CMatrix CHeatConduction::solveCG(CLinearSystem<T>& sys) {
+    sys.setMethod(cgMethod);
+    sys.setSStep(sStep, sBasis);
+    CMatrix x = sys.iterativeSolve();
+    nIterations = sys.getNIterations();
+
+    /*--- Time breakdown per iteration. ---*/
+    double nIt = (nIterations > 0) ? nIterations : 1.0;
+    iterationTimes.resize(4);
+    iterationTimes[0] = sys.getTimeProduct() / nIt;
+    iterationTimes[1] = sys.getTimePrecond() / nIt;
+    iterationTimes[2] = sys.getTimeReduction() / nIt;
+    iterationTimes[3] = sys.getTimeVector() / nIt;
+
+    return x;
 }
 
 CMatrix CHeatConduction::solveTemperature(const CMesh& msh,
-                                          const CBoundaryConditions& bnd) {
+                                          const CBoundaryConditions& bnd,
+                                          const CConductance& cnd) {
     /*--- Initialize variables to be used in the subroutine. ---*/
     unsigned nDof = msh.getNDofTotal();
     CMatrix T = CMatrix(nDof, 1, 0.0);
     unsigned nTNod = bnd.getNTempNodes();
-    CMatrix tpNod = bnd.getTempNodes();
+    const CMatrixIndex& tpNod = bnd.getTempNodes();
     unsigned rDof = bnd.getNReducedDof();
-    CMatrix rDofVec = bnd.getReducedDofVector();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+
+    /*--- RHS of the system. Without the assembled matrix, Kef'*Te is the
+          product of K with the known temperatures at the rows of Kff. ---*/
+    CMatrix RHS = Ff;
+    if (solverType == "matrix-free") {
+        CMatrix TKnown = CMatrix(nDof, 1, 0.0);
+        for (unsigned i = 0; i < nTNod; i++) {
+            TKnown(tpNod(0, i), 0) = Te(i, 0);
+        }
+        CMatrix KT = CMatrixFree(cnd, msh, bnd).globalProduct(TKnown);
+        for (unsigned i = 0; i < rDof; i++) {
+            RHS(i, 0) -= KT(rDofVec(0, i), 0);
+        }
+    } else {
+        RHS -= Kef.transpose() * Te;
+    }
 
     /*--- Solve the linear system of equations. ---*/
-    CMatrix RHS = Ff - Kef.transpose() * Te;
-    CMatrixSymmetric KffSym = Kff.toSymmetricStorage();
-    CLinearSystem<CMatrixSymmetric> sys =
-        CLinearSystem<CMatrixSymmetric>(KffSym, RHS);
-    Tf = sys.iterativeSolve();
+    if (solverType == "multigrid") {
+        CMultigrid mg = CMultigrid(cnd, msh, bnd, cycleType);
+        Tf = mg.solve(RHS);
+        nIterations = mg.getNIterations();
+    } else if (solverType == "direct") {
+        Tf = solveBanded(msh, bnd, RHS);
+    } else if (solverType == "cholesky") {
+        if (cache != nullptr && cache->isFactored(cacheKey)) {
+            Tf = cache->getFactor(cacheKey).solve(RHS);
+        } else {
+            CSparseCholesky<double> chol =
+                CSparseCholesky<double>(Kff, choleskyOrder(msh, bnd));
+            Tf = chol.solve(RHS);
+            if (cache != nullptr) cache->insertFactor(cacheKey, chol);
+        }
+    } else if (solverType == "mixed") {
+        CSparseCholesky<float> chol =
+            CSparseCholesky<float>(Kff, choleskyOrder(msh, bnd));
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(Kff, RHS);
+        Tf = sys.refinementSolve(chol);
+        nIterations = sys.getNIterations();
+    } else if (solverType == "matrix-free") {
+        if (precondType != "none")
+            throw std::runtime_error("Preconditioner needs the assembled matrix");
+        CLinearSystem<CMatrixFree> sys =
+            CLinearSystem<CMatrixFree>(CMatrixFree(cnd, msh, bnd), RHS);
+        Tf = solveCG(sys);
+    } else if (solverType == "cg") {
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(Kff, RHS);
+
+        /*--- Preconditioner of the CG method specified by the user. ---*/
+        CPreconditioner* M = nullptr;
+        if (precondType == "jacobi") {
+            M = new CPreconditionerJacobi(Kff);
+        } else if (precondType == "ssor") {
+            M = new CPreconditionerSSOR(Kff);
+        } else if (precondType == "ic0") {
+            M = new CPreconditionerIC0(Kff);
+        } else if (precondType == "multigrid") {
+            M = new CMultigrid(cnd, msh, bnd, cycleType);
+        } else if (precondType == "amg") {
+            M = new CAlgebraicMultigrid(Kff, cycleType);
+        } else if (precondType != "none") {
+            throw std::runtime_error("Unknown preconditioner");
+        }
+        sys.setPreconditioner(M);
+        Tf = solveCG(sys);
+        delete M;
+    } else if (solverType == "distributed") {
+        /*--- Every rank owns a block of rows of Kff and of the vectors. The
+              preconditioner of a rank only sees its diagonal block, so the
+              preconditioners become block Jacobi. A distributed assembly
+              gives the rows of every rank. ---*/
+        CMatrixDistributed A = cnd.isDistributed() ?
+            CMatrixDistributed(cnd.getConducFFRows(),
+                               cnd.getConducFFOffsets()) :
+            CMatrixDistributed(Kff);
+        CLinearSystem<CMatrixDistributed> sys =
+            CLinearSystem<CMatrixDistributed>(A, A.getLocalVector(RHS));
+        CPreconditioner* M = nullptr;
+        if (precondType == "jacobi") {
+            M = new CPreconditionerJacobi(A.getDiagonalBlock());
+        } else if (precondType == "ssor") {
+            M = new CPreconditionerSSOR(A.getDiagonalBlock());
+        } else if (precondType == "ic0") {
+            M = new CPreconditionerIC0(A.getDiagonalBlock());
+        } else if (precondType != "none") {
+            throw std::runtime_error("Preconditioner needs the whole matrix");
+        }
+        sys.setPreconditioner(M);
+        Tf = A.gatherVector(solveCG(sys));
+        delete M;
+    } else {
+        throw std::runtime_error("Unknown solver");
+    }
 
     /*--- Build global temperature vector combining Te and Tf. ---*/
     for (unsigned i = 0; i < nTNod; i++) {
@@ -156,17 +397,132 @@ CMatrix CHeatConduction::solveTemperature(const CMesh& msh,
     return T;
 }
 
+CMatrix CHeatConduction::solveBanded(const CMesh& msh,
+                                     const CBoundaryConditions& bnd,
+                                     const CMatrix& RHS) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const CMatrixIndex& topol = msh.getTopolMtx();
+    unsigned nX = topol.getCols() - 1;
+    unsigned nY = topol.getRows() - 1;
+    unsigned nDof = msh.getNDofTotal();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    unsigned rDof = bnd.getNReducedDof();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+    unsigned* rowPtr = Kff.getRowPtrAddress();
+    unsigned* colIdx = Kff.getColIdxAddress();
+    double* KffPtr = Kff.getMtxAddress();
+
+    /*--- The mesh numbers the nodes from bottom to top, giving a band of about
+          nY+2. Numbering them from left to right gives a band of about nX+2.
+          Position of every DOF in the second numbering. ---*/
+    std::vector<unsigned> rowWise(nDof, 0);
+    for (unsigned j = 0; j < nX + 1; j++) {
+        for (unsigned i = 0; i < nY + 1; i++) {
+            if (topol(i, j) == CMesh::noNode) continue;
+            rowWise[glDof(topol(i, j), dfPerNod)] = i*(nX + 1) + j;
+        }
+    }
+    std::vector<unsigned> order(rDof);
+    for (unsigned k = 0; k < rDof; k++) {
+        order[k] = k;
+    }
+    std::sort(order.begin(), order.end(),
+              [&](unsigned a, unsigned b) {
+                  return rowWise[rDofVec(0, a)] < rowWise[rDofVec(0, b)];
+              });
+    std::vector<unsigned> colWisePos(rDof);
+    std::vector<unsigned> rowWisePos(rDof);
+    for (unsigned k = 0; k < rDof; k++) {
+        colWisePos[k] = k;
+        rowWisePos[order[k]] = k;
+    }
+
+    /*--- Half-bandwidth of Kff with both numberings. ---*/
+    unsigned colWiseBand = 0;
+    unsigned rowWiseBand = 0;
+    for (unsigned i = 0; i < rDof; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            colWiseBand = std::max(colWiseBand, i - j);
+            rowWiseBand = std::max(rowWiseBand,
+                                   rowWisePos[i] > rowWisePos[j] ?
+                                   rowWisePos[i] - rowWisePos[j] :
+                                   rowWisePos[j] - rowWisePos[i]);
+        }
+    }
+    std::vector<unsigned>& pos = (rowWiseBand < colWiseBand) ?
+                                 rowWisePos : colWisePos;
+    halfBandwidth = std::min(colWiseBand, rowWiseBand);
+
+    /*--- Band matrix and RHS vector in the numbering with the smaller band. ---*/
+    CMatrixBanded A = CMatrixBanded(rDof, halfBandwidth, 0.0);
+    CMatrix b = CMatrix(rDof, 1, 0.0);
+    for (unsigned i = 0; i < rDof; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            A(pos[i], pos[colIdx[k]]) = KffPtr[k];
+        }
+        b(pos[i], 0) = RHS(i, 0);
+    }
+
+    /*--- Solve with the banded Cholesky factorization and go back to the
+          numbering of the mesh. ---*/
+    CLinearSystem<CMatrixBanded> sys = CLinearSystem<CMatrixBanded>(A, b);
+    CMatrix x = sys.directSolve();
+    CMatrix sol = CMatrix(rDof, 1, 0.0);
+    for (unsigned i = 0; i < rDof; i++) {
+        sol(i, 0) = x(pos[i], 0);
+    }
+
+    return sol;
+}
+
+std::vector<unsigned> CHeatConduction::choleskyOrder(
+        const CMesh& msh, const CBoundaryConditions& bnd) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nDof = msh.getNDofTotal();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    unsigned rDof = bnd.getNReducedDof();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+    std::vector<unsigned> nodes = msh.nestedDissection();
+    std::vector<int> rDofPos(nDof, -1);
+    std::vector<unsigned> order;
+
+    /*--- Keep the nodes of the nested dissection with known flux. ---*/
+    for (unsigned i = 0; i < rDof; i++) {
+        rDofPos[rDofVec(0, i)] = i;
+    }
+    for (unsigned k = 0; k < nodes.size(); k++) {
+        int pos = rDofPos[glDof(nodes[k], dfPerNod)];
+        if (pos >= 0) order.push_back(pos);
+    }
+
+    return order;
+}
+
 CMatrix CHeatConduction::solveFlux(const CMesh& msh,
-                                   const CBoundaryConditions& bnd) {
+                                   const CBoundaryConditions& bnd,
+                                   const CConductance& cnd) {
     /*--- Initialize variables to be used in the subroutine. ---*/
     unsigned nDof = msh.getNDofTotal();
     CMatrix F = CMatrix(nDof, 1, 0.0);
     unsigned nTNod = bnd.getNTempNodes();
-    CMatrix tpNod = bnd.getTempNodes();
+    const CMatrixIndex& tpNod = bnd.getTempNodes();
     unsigned rDof = bnd.getNReducedDof();
-    CMatrix rDofVec = bnd.getReducedDofVector();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
 
-    Fe = Kee * Te + Kef * Tf;
+    /*--- Without the assembled matrix, Fe is the product of K with the
+          temperature vector at the rows of the known temperatures. ---*/
+    if (solverType == "matrix-free") {
+        CMatrix KT = CMatrixFree(cnd, msh, bnd).globalProduct(temp);
+        Fe = CMatrix(nTNod, 1, 0.0);
+        for (unsigned i = 0; i < nTNod; i++) {
+            Fe(i, 0) = KT(tpNod(0, i), 0);
+        }
+    } else {
+        Fe = Kee * Te + Kef * Tf;
+    }
 
     /*--- Build global flux vector combining Fe and Ff. ---*/
     for (unsigned i = 0; i < nTNod; i++) {
@@ -29,10 +29,21 @@
 #define __CLINEARSYSTEM_CPP
 
 #include <iostream>
+#include <cmath>
 #include <mpi.h>
 #include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
 
 #include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CMatrixBanded.hpp"
+#include "../include/CMatrixFree.hpp"
+#include "../include/CMatrixDistributed.hpp"
+#include "../include/CPreconditioner.hpp"
 #include "../include/CLinearSystem.hpp"
 
 template<typename T>
@@ -40,6 +51,16 @@ CLinearSystem<T>::CLinearSystem(const T& A, const CMatrix& b) {
     /*--- Initialize properties. ---*/
     lhsMatrix = T(A);
     rhsVector = CMatrix(b);
+    precond = nullptr;
+    nIterations = 0;
+    method = "classic";
+    sStep = 4;
+    sBasis = "newton";
+    timeProduct = 0.0;
+    timePrecond = 0.0;
+    timeReduction = 0.0;
+    timeVector = 0.0;
+    setOwnedRange(lhsMatrix);
 
     /*--- Check if the system is valid. ---*/
     if(!isSystemValid())
@@ -61,6 +82,48 @@ CMatrix CLinearSystem<T>::getRhsVector() {
     return res;
 }
 
+template<typename T>
+void CLinearSystem<T>::setPreconditioner(const CPreconditioner* M) {
+    precond = M;
+}
+
+template<typename T>
+void CLinearSystem<T>::setMethod(const std::string m) {
+    method = m;
+}
+
+template<typename T>
+void CLinearSystem<T>::setSStep(const unsigned s, const std::string basis) {
+    if (s == 0) throw std::runtime_error("The s-step CG method needs s > 0");
+    sStep = s;
+    sBasis = basis;
+}
+
+template<typename T>
+unsigned CLinearSystem<T>::getNIterations() const {
+    return nIterations;
+}
+
+template<typename T>
+double CLinearSystem<T>::getTimeProduct() const {
+    return timeProduct;
+}
+
+template<typename T>
+double CLinearSystem<T>::getTimePrecond() const {
+    return timePrecond;
+}
+
+template<typename T>
+double CLinearSystem<T>::getTimeReduction() const {
+    return timeReduction;
+}
+
+template<typename T>
+double CLinearSystem<T>::getTimeVector() const {
+    return timeVector;
+}
+
 template<typename T>
 bool CLinearSystem<T>::isSystemValid() {
     bool isSquareMatrix = lhsMatrix.getRows() == lhsMatrix.getCols();
@@ -71,12 +134,53 @@ bool CLinearSystem<T>::isSystemValid() {
 
 template<typename T>
 CMatrix CLinearSystem<T>::directSolve() {
+    return factorSolve(lhsMatrix, rhsVector);
+}
+
+template<typename T>
+template<typename F>
+CMatrix CLinearSystem<T>::refinementSolve(const F& factor) {
     /*--- Initialize variables to be used in the subroutine. ---*/
-    const unsigned size = lhsMatrix.getRows();
-    const unsigned nRhs = 1;
-    int info = 0;
-    CMatrix A = lhsMatrix;
+    const unsigned n = lhsMatrix.getRows();
+    unsigned k;
+    double eps;
+    double epsOld = std::numeric_limits<double>::max();
+    T A = lhsMatrix;
     CMatrix b = rhsVector;
+    CMatrix x = factor.solve(b);
+    CMatrix r = rhsVector;
+    double* bPtr = b.getMtxAddress();
+    double* xPtr = x.getMtxAddress();
+    double* rPtr = r.getMtxAddress();
+    const double stop = stopNorm(bPtr, n);
+
+    /*--- The error of the factorization is corrected with the residual in
+          double precision, x = x + inv(L*L')*(b - A*x), until the residual
+          reaches the tolerance of the CG method or a correction no longer
+          reduces it by half, which happens at the round-off of the
+          residual. ---*/
+    for (k = 0; k < 100; k++) {
+        F77NAME(dcopy)(n, bPtr, 1, rPtr, 1);
+        parallelMul(A, xPtr, rPtr, n, -1.0, 1.0);
+        eps = sqrt(parallelDot(rPtr, rPtr, n));
+        if (eps <= stop || eps > 0.5*epsOld) break;
+        epsOld = eps;
+        CMatrix d = factor.solve(r);
+        F77NAME(daxpy)(n, 1.0, d.getMtxAddress(), 1, xPtr, 1);
+    }
+    nIterations = k;
+
+    return x;
+}
+
+template<typename T>
+CMatrix CLinearSystem<T>::factorSolve(const CMatrix& lhs, const CMatrix& rhs) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const unsigned size = lhs.getRows();
+    const unsigned nRhs = rhs.getCols();
+    int info = 0;
+    CMatrix A = lhs;
+    CMatrix b = rhs;
     int* vPivPtr = new int[size];
     double* APtr = A.getMtxAddress();
     double* bPtr = b.getMtxAddress();
@@ -90,62 +194,262 @@ CMatrix CLinearSystem<T>::directSolve() {
     return b;
 }
 
+template<typename T>
+CMatrix CLinearSystem<T>::factorSolve(const CMatrixSymmetric& lhs,
+                                      const CMatrix& rhs) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const unsigned size = lhs.getRows();
+    const unsigned nRhs = rhs.getCols();
+    int info = 0;
+    CMatrixSymmetric A = lhs;
+    CMatrix b = rhs;
+    double* APtr = A.getMtxAddress();
+    double* bPtr = b.getMtxAddress();
+
+    /*--- Factorize and solve system with LAPACK subroutines, working on the
+          packed lower triangle. ---*/
+    if (size == 0) return b;
+    F77NAME(dpptrf)('L', size, APtr, info);
+    if (info != 0) throw std::runtime_error("Matrix not positive definite");
+    F77NAME(dpptrs)('L', size, nRhs, APtr, bPtr, size, info);
+
+    return b;
+}
+
+template<typename T>
+CMatrix CLinearSystem<T>::factorSolve(const CMatrixBanded& lhs,
+                                      const CMatrix& rhs) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const unsigned size = lhs.getRows();
+    const unsigned kd = lhs.getNBands();
+    const unsigned nRhs = rhs.getCols();
+    int info = 0;
+    CMatrixBanded A = lhs;
+    CMatrix b = rhs;
+    double* APtr = A.getMtxAddress();
+    double* bPtr = b.getMtxAddress();
+
+    /*--- Factorize and solve system with LAPACK subroutines. The work is
+          O(n*kd^2) instead of O(n^3) of the dense solution. ---*/
+    if (size == 0) return b;
+    F77NAME(dpbtrf)('L', size, kd, APtr, kd + 1, info);
+    if (info != 0) throw std::runtime_error("Band matrix not positive definite");
+    F77NAME(dpbtrs)('L', size, kd, nRhs, APtr, kd + 1, bPtr, size, info);
+
+    return b;
+}
+
 template<typename T>
 CMatrix CLinearSystem<T>::iterativeSolve() {
+    /*--- Reset the time breakdown of the solution. ---*/
+    timeProduct = 0.0;
+    timePrecond = 0.0;
+    timeReduction = 0.0;
+    timeVector = 0.0;
+
+    if (rhsVector.getCols() > 1) {
+        if (method != "classic")
+            throw std::runtime_error("Several RHS vectors need the classic CG");
+        return blockSolve();
+    }
+    if (method == "classic") return classicSolve();
+    if (method == "pipelined") return pipelinedSolve();
+    if (method == "s-step") return sStepSolve();
+    throw std::runtime_error("Unknown CG method");
+}
+
+template<typename T>
+CMatrix CLinearSystem<T>::classicSolve() {
     /*--- Initialize variables to be used in the subroutine. ---*/
     const unsigned n = lhsMatrix.getRows();
     double* r = new double[n];
+    double* z = new double[n];
     double* p = new double[n];
     double* t = new double[n];
     int k;
     double alpha;
     double beta;
+    double rz;
     double eps;
-    double tol = 0.00001;
+    double tic;
     T A = lhsMatrix;
     CMatrix b = rhsVector;
     CMatrix x = rhsVector;
     // double* APtr = A.getMtxAddress();
     double* bPtr = b.getMtxAddress();
     double* xPtr = x.getMtxAddress();
+    const double stop = stopNorm(bPtr, n);
 
-    /*--- CG method algorithm. ---*/
+    /*--- Preconditioned CG method algorithm. Without preconditioner z = r and
+          the classic CG method is recovered. ---*/
     F77NAME(dcopy)(n, bPtr, 1, r, 1);
     // F77NAME(dgemv)('N', n, n, -1.0, APtr, n, xPtr, 1, 1.0, r, 1);
     parallelMul(A, xPtr, r, n, -1.0, 1.0);
-    F77NAME(dcopy)(n, r, 1, p, 1);
+    precondition(r, z, n);
+    F77NAME(dcopy)(n, z, 1, p, 1);
+    rz = parallelDot(r, z, n);
     k = 0;
     do {
         // F77NAME(dgemv)('N', n, n, 1.0, APtr, n, p, 1, 0.0, t, 1);
+        tic = MPI_Wtime();
         parallelMul(A, p, t, n, 1.0, 0.0);
+        timeProduct += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
         alpha = parallelDot(t, p, n);
-        alpha = parallelDot(r, r, n) / alpha;
-        beta = parallelDot(r, r, n);
+        timeReduction += MPI_Wtime() - tic;
+        alpha = rz / alpha;
 
+        tic = MPI_Wtime();
         F77NAME(daxpy)(n, alpha, p, 1, xPtr, 1);
         F77NAME(daxpy)(n, -alpha, t, 1, r, 1);
+        timeVector += MPI_Wtime() - tic;
+        k++;
 
-        eps = F77NAME(dnrm2)(n, r, 1);
-        if (eps < tol*tol) {
+        tic = MPI_Wtime();
+        eps = sqrt(parallelDot(r, r, n));
+        timeReduction += MPI_Wtime() - tic;
+        if (eps <= stop) {
             break;
         }
-        beta = parallelDot(r, r, n) / beta;
+        tic = MPI_Wtime();
+        precondition(r, z, n);
+        timePrecond += MPI_Wtime() - tic;
+        beta = rz;
+        tic = MPI_Wtime();
+        rz = parallelDot(r, z, n);
+        timeReduction += MPI_Wtime() - tic;
+        beta = rz / beta;
 
-        F77NAME(dcopy)(n, r, 1, t, 1);
+        tic = MPI_Wtime();
+        F77NAME(dcopy)(n, z, 1, t, 1);
         F77NAME(daxpy)(n, beta, p, 1, t, 1);
         F77NAME(dcopy)(n, t, 1, p, 1);
-
-        k++;
+        timeVector += MPI_Wtime() - tic;
     } while (k < 5000);
+    nIterations = k;
 
     /*--- Release allocated memory. ---*/
     delete[] r;
+    delete[] z;
     delete[] p;
     delete[] t;
 
     return x;
 }
 
+template<typename T>
+CMatrix CLinearSystem<T>::pipelinedSolve() {
+    /*--- Initialize variables to be used in the subroutine. The vectors keep
+          the recurrences u = M*r, w = A*u, s = A*p, q = M*s and z = A*q,
+          besides m = M*w and v = A*m. ---*/
+    const unsigned n = lhsMatrix.getRows();
+    std::vector<double> r(n), u(n), w(n), m(n), v(n);
+    std::vector<double> p(n, 0.0), s(n, 0.0), q(n, 0.0), z(n, 0.0);
+    unsigned k;
+    double alpha = 0.0;
+    double beta;
+    double gamma;
+    double gammaOld = 0.0;
+    double delta;
+    double eps;
+    const unsigned nReplace = 10;
+    double tic;
+    double dots[3];
+    double sums[3];
+    MPI_Request req;
+    T A = lhsMatrix;
+    CMatrix b = rhsVector;
+    CMatrix x = rhsVector;
+    double* bPtr = b.getMtxAddress();
+    double* xPtr = x.getMtxAddress();
+    const double stop = stopNorm(bPtr, n);
+
+    /*--- The recurrences drift away from the true residual, which stalls
+          the convergence well above the tolerance. Every nReplace iterations
+          they are recomputed from the solution and the search direction, at
+          the cost of four products and two preconditioner applications. ---*/
+    auto replaceResidual = [&]() {
+        tic = MPI_Wtime();
+        F77NAME(dcopy)(n, bPtr, 1, r.data(), 1);
+        parallelMul(A, xPtr, r.data(), n, -1.0, 1.0);
+        parallelMul(A, p.data(), s.data(), n, 1.0, 0.0);
+        timeProduct += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
+        precondition(r.data(), u.data(), n);
+        precondition(s.data(), q.data(), n);
+        timePrecond += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
+        parallelMul(A, u.data(), w.data(), n, 1.0, 0.0);
+        parallelMul(A, q.data(), z.data(), n, 1.0, 0.0);
+        timeProduct += MPI_Wtime() - tic;
+    };
+
+    /*--- Initial residual and its recurrences. ---*/
+    F77NAME(dcopy)(n, bPtr, 1, r.data(), 1);
+    parallelMul(A, xPtr, r.data(), n, -1.0, 1.0);
+    precondition(r.data(), u.data(), n);
+    parallelMul(A, u.data(), w.data(), n, 1.0, 0.0);
+
+    /*--- Every iteration starts the reduction of (r, u), (w, u) and (r, r),
+          and applies the preconditioner and the matrix while the reduction
+          is in progress. The norm of the residual tells if the previous
+          iteration converged. ---*/
+    k = 0;
+    while (true) {
+        tic = MPI_Wtime();
+        dots[0] = localDot(r.data(), u.data());
+        dots[1] = localDot(w.data(), u.data());
+        dots[2] = localDot(r.data(), r.data());
+        MPI_Iallreduce(dots, sums, 3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD,
+                       &req);
+        timeReduction += MPI_Wtime() - tic;
+
+        tic = MPI_Wtime();
+        precondition(w.data(), m.data(), n);
+        timePrecond += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
+        parallelMul(A, m.data(), v.data(), n, 1.0, 0.0);
+        timeProduct += MPI_Wtime() - tic;
+
+        tic = MPI_Wtime();
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        timeReduction += MPI_Wtime() - tic;
+        gamma = sums[0];
+        delta = sums[1];
+        eps = sqrt(sums[2]);
+        if ((k > 0 && eps <= stop) || k == 5000) break;
+
+        /*--- Step lengths from the reduced dot products. ---*/
+        if (k > 0) {
+            beta = gamma / gammaOld;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        } else {
+            beta = 0.0;
+            alpha = gamma / delta;
+        }
+        gammaOld = gamma;
+
+        /*--- Update the recurrences and the solution. ---*/
+        tic = MPI_Wtime();
+        for (unsigned i = 0; i < n; i++) {
+            z[i] = v[i] + beta * z[i];
+            q[i] = m[i] + beta * q[i];
+            s[i] = w[i] + beta * s[i];
+            p[i] = u[i] + beta * p[i];
+            xPtr[i] += alpha * p[i];
+            r[i] -= alpha * s[i];
+            u[i] -= alpha * q[i];
+            w[i] -= alpha * z[i];
+        }
+        timeVector += MPI_Wtime() - tic;
+        k++;
+        if (k % nReplace == 0) replaceResidual();
+    }
+    nIterations = k;
+
+    return x;
+}
+
 // template<T>
 // CMatrix CLinearSystem<T>::iterativeSolve() {
 //     /*--- Initialize variables to be used in the subroutine. ---*/
@@ -201,34 +505,437 @@ CMatrix CLinearSystem<T>::iterativeSolve() {
 // }
 
 template<typename T>
-double CLinearSystem<T>::parallelDot(double* x, double* y, unsigned n) {
+template<typename M>
+void CLinearSystem<T>::setOwnedRange(const M& A) {
     /*--- Initialize variables to be used in the subroutine. ---*/
-    double dot = 0.0, res = 0.0;
-    unsigned size;
     int rank;
     int nRanks;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
-    double* xInit = x;
-    double* yInit = y;
+    unsigned long long n = A.getRows();
 
-    /*--- Divide dot product between ranks 0 and 1. ---*/
-    if (rank == 0) {
-        size = n / nRanks;
-        dot = F77NAME(ddot)(size, xInit, 1, yInit, 1);
-    } else {
-        size = n / nRanks + n % nRanks;
-        xInit += n / nRanks;
-        yInit += n / nRanks;
-        dot = F77NAME(ddot)(size, xInit, 1, yInit, 1);
+    /*--- Consecutive blocks, so every entry is reduced by a single rank. ---*/
+    ownFirst = n * rank / nRanks;
+    ownSize = n * (rank + 1) / nRanks - ownFirst;
+}
+
+template<typename T>
+void CLinearSystem<T>::setOwnedRange(const CMatrixDistributed& A) {
+    ownFirst = 0;
+    ownSize = A.getRows();
+}
+
+template<typename T>
+CMatrix CLinearSystem<T>::blockSolve() {
+    /*--- Initialize variables to be used in the subroutine. The vectors of
+          all the RHS are interleaved, entry i of column c at i*nRhs+c, so
+          that the products and the updates visit every row once. ---*/
+    const unsigned n = lhsMatrix.getRows();
+    const unsigned nRhs = rhsVector.getCols();
+    std::vector<double> X(n*nRhs), R(n*nRhs), Z(n*nRhs), P(n*nRhs), Q(n*nRhs);
+    std::vector<double> r(n), z(n);
+    std::vector<double> alpha(nRhs), beta(nRhs);
+    std::vector<double> pq(nRhs), rz(nRhs), dots(2*nRhs), stop(nRhs);
+    std::vector<bool> active(nRhs, true);
+    unsigned k;
+    unsigned nActive = nRhs;
+    double tic;
+    T A = lhsMatrix;
+    CMatrix x = rhsVector;
+
+    /*--- Initial guess x = b, residuals and search directions. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned c = 0; c < nRhs; c++) {
+            X[i*nRhs+c] = rhsVector(i, c);
+        }
     }
+    blockDot(X.data(), X.data(), n, nRhs, stop.data());
+    for (unsigned c = 0; c < nRhs; c++) {
+        stop[c] = 1e-10 * sqrt(stop[c]);
+    }
+    R = X;
+    parallelMul(A, X.data(), R.data(), n, nRhs, -1.0, 1.0);
+    auto preconditionBlock = [&]() {
+        if (!precond) {
+            Z = R;
+            return;
+        }
+        for (unsigned c = 0; c < nRhs; c++) {
+            if (!active[c]) continue;
+            F77NAME(dcopy)(n, &R[c], nRhs, r.data(), 1);
+            precondition(r.data(), z.data(), n);
+            F77NAME(dcopy)(n, z.data(), 1, &Z[c], nRhs);
+        }
+    };
+    preconditionBlock();
+    P = Z;
+    blockDot(R.data(), Z.data(), n, nRhs, rz.data());
 
-    /*--- Combine the results from ranks 0 and 1. ---*/
+    k = 0;
+    do {
+        tic = MPI_Wtime();
+        parallelMul(A, P.data(), Q.data(), n, nRhs, 1.0, 0.0);
+        timeProduct += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
+        blockDot(P.data(), Q.data(), n, nRhs, pq.data());
+        timeReduction += MPI_Wtime() - tic;
+
+        /*--- Update the columns that have not converged. The others keep
+              alpha = 0, so their search directions are not used. ---*/
+        tic = MPI_Wtime();
+        for (unsigned c = 0; c < nRhs; c++) {
+            alpha[c] = active[c] ? rz[c] / pq[c] : 0.0;
+        }
+        for (unsigned i = 0; i < n*nRhs; i += nRhs) {
+            for (unsigned c = 0; c < nRhs; c++) {
+                X[i+c] += alpha[c] * P[i+c];
+                R[i+c] -= alpha[c] * Q[i+c];
+            }
+        }
+        timeVector += MPI_Wtime() - tic;
+        tic = MPI_Wtime();
+        preconditionBlock();
+        timePrecond += MPI_Wtime() - tic;
+
+        /*--- (r, r) and (r, z) of every column in a single reduction. ---*/
+        tic = MPI_Wtime();
+        for (unsigned c = 0; c < 2*nRhs; c++) {
+            dots[c] = 0.0;
+        }
+        for (unsigned i = ownFirst; i < ownFirst + ownSize; i++) {
+            for (unsigned c = 0; c < nRhs; c++) {
+                dots[c] += R[i*nRhs+c] * R[i*nRhs+c];
+                dots[nRhs+c] += R[i*nRhs+c] * Z[i*nRhs+c];
+            }
+        }
+        MPI_Allreduce(MPI_IN_PLACE, dots.data(), 2*nRhs, MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        timeReduction += MPI_Wtime() - tic;
+        k++;
+
+        tic = MPI_Wtime();
+        for (unsigned c = 0; c < nRhs; c++) {
+            beta[c] = 0.0;
+            if (!active[c]) continue;
+            if (sqrt(dots[c]) <= stop[c]) {
+                active[c] = false;
+                nActive--;
+                continue;
+            }
+            beta[c] = dots[nRhs+c] / rz[c];
+            rz[c] = dots[nRhs+c];
+        }
+        for (unsigned i = 0; i < n*nRhs; i += nRhs) {
+            for (unsigned c = 0; c < nRhs; c++) {
+                P[i+c] = Z[i+c] + beta[c] * P[i+c];
+            }
+        }
+        timeVector += MPI_Wtime() - tic;
+    } while (nActive > 0 && k < 5000);
+    nIterations = k;
+
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned c = 0; c < nRhs; c++) {
+            x(i, c) = X[i*nRhs+c];
+        }
+    }
+
+    return x;
+}
+
+template<typename T>
+CMatrix CLinearSystem<T>::sStepSolve() {
+    /*--- Initialize variables to be used in the subroutine. The basis V of a
+          block of sb steps has the columns of Y = [P, Z] followed by the
+          columns of M*Y, where P spans the search direction and its sb
+          products by inv(M)*A, and Z the preconditioned residual and its sb-1
+          products. The vectors pt and r are M*p and M*z. ---*/
+    const unsigned n = lhsMatrix.getRows();
+    const unsigned s = sStep;
+    const unsigned nReplace = 10;
+    std::vector<double> V(2*(2*s+1)*n);
+    std::vector<double> r(n), z(n), p(n), pt(n), t(n);
+    std::vector<double> GH, G, H, B;
+    std::vector<double> xc, zc, pc, Bp, zNew;
+    std::vector<double> theta(s, 0.0);
+    std::vector<double> alphas;
+    std::vector<double> betas;
+    unsigned k;
+    unsigned lastReplace = 0;
+    bool converged = false;
+    double sigma = 1.0;
+    double bestEps = std::numeric_limits<double>::max();
+    double alpha;
+    double beta;
+    double rz;
+    double eps = 0.0;
+    double tic;
+    T A = lhsMatrix;
+    CMatrix b = rhsVector;
+    CMatrix x = rhsVector;
+    double* bPtr = b.getMtxAddress();
+    double* xPtr = x.getMtxAddress();
+    const double stop = stopNorm(bPtr, n);
+    if (sBasis != "monomial" && sBasis != "newton")
+        throw std::runtime_error("Unknown basis of the s-step CG method");
+
+    /*--- Initial residual, p = z = inv(M)*r and M*p = r. ---*/
+    F77NAME(dcopy)(n, bPtr, 1, r.data(), 1);
+    parallelMul(A, xPtr, r.data(), n, -1.0, 1.0);
+    precondition(r.data(), z.data(), n);
+    F77NAME(dcopy)(n, z.data(), 1, p.data(), 1);
+    F77NAME(dcopy)(n, r.data(), 1, pt.data(), 1);
+
+    k = 0;
+    while (!converged && k < 5000) {
+        /*--- The first s iterations are blocks of one step, which estimate
+              the spectrum used to scale and shift the basis. ---*/
+        const unsigned sb = (k < s) ? 1 : s;
+        const unsigned m = 2*sb + 1;
+        const unsigned ld = std::max(n, 1u);
+        double* Y = V.data();
+        double* Yt = V.data() + m*n;
+
+        /*--- Basis y(i+1) = (inv(M)*A - theta(i))*y(i)/sigma, with the
+              columns of M*Y following y~(i+1) = (A*y(i) - theta(i)*y~(i))/sigma.
+              The shifts are zero in the monomial basis. ---*/
+        tic = MPI_Wtime();
+        F77NAME(dcopy)(n, p.data(), 1, Y, 1);
+        F77NAME(dcopy)(n, pt.data(), 1, Yt, 1);
+        F77NAME(dcopy)(n, z.data(), 1, Y + (sb+1)*n, 1);
+        F77NAME(dcopy)(n, r.data(), 1, Yt + (sb+1)*n, 1);
+        timeVector += MPI_Wtime() - tic;
+        for (unsigned blk = 0; blk < 2; blk++) {
+            unsigned first = (blk == 0) ? 0 : sb + 1;
+            unsigned nCols = (blk == 0) ? sb + 1 : sb;
+            for (unsigned i = 0; i + 1 < nCols; i++) {
+                double* yi = Y + (first+i)*n;
+                double* yti = Yt + (first+i)*n;
+                double shift = (sb > 1) ? theta[i] : 0.0;
+                double scale = (sb > 1) ? 1.0/sigma : 1.0;
+                tic = MPI_Wtime();
+                parallelMul(A, yi, t.data(), n, 1.0, 0.0);
+                timeProduct += MPI_Wtime() - tic;
+                tic = MPI_Wtime();
+                precondition(t.data(), yi + n, n);
+                timePrecond += MPI_Wtime() - tic;
+                tic = MPI_Wtime();
+                F77NAME(dcopy)(n, t.data(), 1, yti + n, 1);
+                F77NAME(daxpy)(n, -shift, yi, 1, yi + n, 1);
+                F77NAME(daxpy)(n, -shift, yti, 1, yti + n, 1);
+                F77NAME(dscal)(n, scale, yi + n, 1);
+                F77NAME(dscal)(n, scale, yti + n, 1);
+                timeVector += MPI_Wtime() - tic;
+            }
+        }
+
+        /*--- Single reduction of G = Y'*M*Y and H = Y'*M*M*Y, from the
+              entries of this rank of [Y, M*Y]'*(M*Y). ---*/
+        tic = MPI_Wtime();
+        GH.assign(2*m*m, 0.0);
+        G.resize(m*m);
+        H.resize(m*m);
+        if (ownSize > 0) {
+            F77NAME(dgemm)('T', 'N', 2*m, m, ownSize, 1.0, V.data() + ownFirst,
+                           ld, Yt + ownFirst, ld, 0.0, GH.data(), 2*m);
+        }
+        MPI_Allreduce(MPI_IN_PLACE, GH.data(), 2*m*m, MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+        for (unsigned j = 0; j < m; j++) {
+            for (unsigned i = 0; i < m; i++) {
+                G[j*m+i] = GH[j*2*m+i];
+                H[j*m+i] = GH[j*2*m+m+i];
+            }
+        }
+        timeReduction += MPI_Wtime() - tic;
+
+        /*--- Change of basis, inv(M)*A*y(i) = sigma*y(i+1) + theta(i)*y(i). ---*/
+        B.assign(m*m, 0.0);
+        for (unsigned i = 0; i < sb; i++) {
+            B[i*m+i] = (sb > 1) ? theta[i] : 0.0;
+            B[i*m+i+1] = (sb > 1) ? sigma : 1.0;
+        }
+        for (unsigned i = 0; i + 1 < sb; i++) {
+            B[(sb+1+i)*m+sb+1+i] = theta[i];
+            B[(sb+1+i)*m+sb+2+i] = sigma;
+        }
+
+        /*--- sb iterations of the CG method on the coordinates. The dot
+              products are quadratic forms of the Gram matrices. ---*/
+        xc.assign(m, 0.0);
+        zc.assign(m, 0.0);
+        pc.assign(m, 0.0);
+        Bp.assign(m, 0.0);
+        zNew.assign(m, 0.0);
+        pc[0] = 1.0;
+        zc[sb+1] = 1.0;
+        auto form = [&](const std::vector<double>& M, const double* u,
+                        const double* v) {
+            double sum = 0.0;
+            for (unsigned j = 0; j < m; j++) {
+                for (unsigned i = 0; i < m; i++) {
+                    sum += u[i] * M[j*m+i] * v[j];
+                }
+            }
+            return sum;
+        };
+        tic = MPI_Wtime();
+        rz = form(G, zc.data(), zc.data());
+        for (unsigned j = 0; j < sb; j++) {
+            for (unsigned i = 0; i < m; i++) {
+                Bp[i] = 0.0;
+                for (unsigned l = 0; l < m; l++) {
+                    Bp[i] += B[l*m+i] * pc[l];
+                }
+            }
+            alpha = rz / form(G, pc.data(), Bp.data());
+            for (unsigned i = 0; i < m; i++) {
+                xc[i] += alpha * pc[i];
+                zNew[i] = zc[i] - alpha * Bp[i];
+            }
+            k++;
+            eps = sqrt(fabs(form(H, zNew.data(), zNew.data())));
+            zc = zNew;
+            bestEps = std::min(bestEps, eps);
+            if (k <= s) alphas.push_back(alpha);
+            if (eps <= stop || k == 5000) {
+                converged = true;
+                break;
+            }
+            beta = rz;
+            rz = form(G, zc.data(), zc.data());
+            beta = rz / beta;
+            if (k < s) betas.push_back(beta);
+            for (unsigned i = 0; i < m; i++) {
+                pc[i] = zc[i] + beta * pc[i];
+            }
+        }
+
+        /*--- Vectors of the next block from the coordinates. ---*/
+        F77NAME(dgemv)('N', n, m, 1.0, Y, ld, xc.data(), 1, 1.0, xPtr, 1);
+        F77NAME(dgemv)('N', n, m, 1.0, Yt, ld, zc.data(), 1, 0.0, r.data(), 1);
+        F77NAME(dgemv)('N', n, m, 1.0, Y, ld, zc.data(), 1, 0.0, z.data(), 1);
+        F77NAME(dgemv)('N', n, m, 1.0, Y, ld, pc.data(), 1, 0.0, p.data(), 1);
+        F77NAME(dgemv)('N', n, m, 1.0, Yt, ld, pc.data(), 1, 0.0, pt.data(), 1);
+        timeVector += MPI_Wtime() - tic;
+
+        /*--- The recurrences of r and z drift apart near the tolerance, so
+              they are replaced with the true residual every nReplace
+              iterations, and the convergence in the coordinates is confirmed
+              with the true residual. ---*/
+        if (converged || k - lastReplace >= nReplace) {
+            lastReplace = k;
+            tic = MPI_Wtime();
+            F77NAME(dcopy)(n, bPtr, 1, r.data(), 1);
+            parallelMul(A, xPtr, r.data(), n, -1.0, 1.0);
+            timeProduct += MPI_Wtime() - tic;
+            tic = MPI_Wtime();
+            precondition(r.data(), z.data(), n);
+            timePrecond += MPI_Wtime() - tic;
+            if (eps > 10.0*bestEps) {
+                F77NAME(dcopy)(n, z.data(), 1, p.data(), 1);
+                F77NAME(dcopy)(n, r.data(), 1, pt.data(), 1);
+            }
+            if (converged && k < 5000) {
+                tic = MPI_Wtime();
+                eps = sqrt(parallelDot(r.data(), r.data(), n));
+                timeReduction += MPI_Wtime() - tic;
+                converged = eps <= stop;
+            }
+        }
+
+        /*--- After the first s iterations, the Ritz values of inv(M)*A are
+              the eigenvalues of the Lanczos matrix of the CG coefficients.
+              The basis is scaled by the largest one, and the Newton basis is
+              shifted by them in Leja order. ---*/
+        if (k == s && s > 1) {
+            std::vector<double> d(s), e(s), work(1);
+            int info = 0;
+            for (unsigned j = 0; j < s; j++) {
+                d[j] = 1.0 / alphas[j];
+                if (j > 0) d[j] += betas[j-1] / alphas[j-1];
+                if (j + 1 < s) e[j] = sqrt(betas[j]) / alphas[j];
+            }
+            F77NAME(dstev)('N', s, d.data(), e.data(), nullptr, 1, work.data(),
+                           info);
+            if (info != 0 || d[s-1] <= 0.0)
+                throw std::runtime_error("Ritz values of the s-step CG method");
+            sigma = d[s-1];
+            if (sBasis == "newton") {
+                std::vector<bool> used(s, false);
+                for (unsigned i = 0; i < s; i++) {
+                    unsigned best = 0;
+                    double bestVal = -1.0;
+                    for (unsigned j = 0; j < s; j++) {
+                        if (used[j]) continue;
+                        double val = fabs(d[j]);
+                        for (unsigned l = 0; l < i; l++) {
+                            val *= fabs(d[j] - theta[l]);
+                        }
+                        if (val > bestVal) {
+                            bestVal = val;
+                            best = j;
+                        }
+                    }
+                    used[best] = true;
+                    theta[i] = d[best];
+                }
+            }
+        }
+    }
+    nIterations = k;
+
+    return x;
+}
+
+template<typename T>
+double CLinearSystem<T>::localDot(const double* x, const double* y) {
+    return F77NAME(ddot)(ownSize, x + ownFirst, 1, y + ownFirst, 1);
+}
+
+template<typename T>
+void CLinearSystem<T>::blockDot(const double* X, const double* Y, unsigned n,
+                                unsigned nRhs, double* dots) {
+    /*--- Dot products of the entries of this rank, combined from all the
+          ranks at once. ---*/
+    for (unsigned c = 0; c < nRhs; c++) {
+        dots[c] = 0.0;
+    }
+    for (unsigned i = ownFirst*nRhs; i < (ownFirst + ownSize)*nRhs; i += nRhs) {
+        for (unsigned c = 0; c < nRhs; c++) {
+            dots[c] += X[i+c] * Y[i+c];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, dots, nRhs, MPI_DOUBLE, MPI_SUM,
+                  MPI_COMM_WORLD);
+}
+
+template<typename T>
+double CLinearSystem<T>::parallelDot(double* x, double* y, unsigned n) {
+    /*--- Dot product of the entries of this rank. ---*/
+    double dot = 0.0, res = 0.0;
+    dot = localDot(x, y);
+
+    /*--- Combine the results from all the ranks. ---*/
     MPI_Allreduce(&dot, &res, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
 
     return res;
 }
 
+template<typename T>
+double CLinearSystem<T>::stopNorm(double* b, unsigned n) {
+    return 1e-10 * sqrt(parallelDot(b, b, n));
+}
+
+template<typename T>
+void CLinearSystem<T>::precondition(double* r, double* z, unsigned n) {
+    if (precond) {
+        precond->apply(r, z);
+    } else {
+        F77NAME(dcopy)(n, r, 1, z, 1);
+    }
+}
+
 template<typename T>
 void CLinearSystem<T>::parallelMul(const CMatrix& A, double* x, double* y,
                                    unsigned n, double alpha, double beta) {
@@ -244,4 +951,115 @@ void CLinearSystem<T>::parallelMul(const CMatrixSymmetric& A, double* x,
     F77NAME(dspmv)('L', n, alpha, APtr, x, 1, beta, y, 1);
 }
 
+template<typename T>
+void CLinearSystem<T>::parallelMul(const CMatrixSparse& A, double* x,
+                                   double* y,
+                                   unsigned n, double alpha, double beta) {
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+
+    /*--- Every row only visits its stored entries. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            sum += APtr[k] * x[colIdx[k]];
+        }
+        y[i] = alpha * sum + (beta == 0.0 ? 0.0 : beta * y[i]);
+    }
+}
+
+template<typename T>
+void CLinearSystem<T>::parallelMul(const CMatrixSparseSymmetric& A, double* x,
+                                   double* y,
+                                   unsigned n, double alpha, double beta) {
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+
+    /*--- Scale y first because the upper triangle scatters into rows that
+          have not been visited yet. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        y[i] = (beta == 0.0 ? 0.0 : beta * y[i]);
+    }
+
+    /*--- The stored entry (i, j) contributes to row i with x[j] and, out of
+          the diagonal, to row j with x[i]. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        double sum = 0.0;
+        double xi = alpha * x[i];
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            sum += APtr[k] * x[j];
+            if (j != i) y[j] += APtr[k] * xi;
+        }
+        y[i] += alpha * sum;
+    }
+}
+
+template<typename T>
+void CLinearSystem<T>::parallelMul(const CMatrixSparseSymmetric& A, double* X,
+                                   double* Y, unsigned n, unsigned nRhs,
+                                   double alpha, double beta) {
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+
+    for (unsigned l = 0; l < n*nRhs; l++) {
+        Y[l] = (beta == 0.0 ? 0.0 : beta * Y[l]);
+    }
+
+    /*--- Every stored entry is read once and applied to the entries of all
+          the vectors at its row and column, which are contiguous. ---*/
+    std::vector<double> xi(nRhs);
+    for (unsigned i = 0; i < n; i++) {
+        double* yi = Y + i*nRhs;
+        for (unsigned c = 0; c < nRhs; c++) {
+            xi[c] = alpha * X[i*nRhs+c];
+        }
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            double a = APtr[k];
+            const double* xj = X + j*nRhs;
+            for (unsigned c = 0; c < nRhs; c++) {
+                yi[c] += alpha * a * xj[c];
+            }
+            if (j != i) {
+                double* yj = Y + j*nRhs;
+                for (unsigned c = 0; c < nRhs; c++) {
+                    yj[c] += a * xi[c];
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+template<typename M>
+void CLinearSystem<T>::parallelMul(const M& A, double* X, double* Y,
+                                   unsigned n, unsigned nRhs, double alpha,
+                                   double beta) {
+    /*--- One product per vector, copying it out of the interleaved storage. ---*/
+    std::vector<double> x(n), y(n);
+    for (unsigned c = 0; c < nRhs; c++) {
+        F77NAME(dcopy)(n, X + c, nRhs, x.data(), 1);
+        F77NAME(dcopy)(n, Y + c, nRhs, y.data(), 1);
+        parallelMul(A, x.data(), y.data(), n, alpha, beta);
+        F77NAME(dcopy)(n, y.data(), 1, Y + c, nRhs);
+    }
+}
+
+template<typename T>
+void CLinearSystem<T>::parallelMul(const CMatrixFree& A, double* x, double* y,
+                                   unsigned n, double alpha, double beta) {
+    A.multiply(x, y, alpha, beta);
+}
+
+template<typename T>
+void CLinearSystem<T>::parallelMul(const CMatrixDistributed& A, double* x,
+                                   double* y,
+                                   unsigned n, double alpha, double beta) {
+    A.multiply(x, y, alpha, beta);
+}
+
 #endif
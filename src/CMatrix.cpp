@@ -30,6 +30,8 @@
 
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 
 #include "../include/CMatrix.hpp"
 
@@ -74,6 +76,16 @@ CMatrix::CMatrix(const CMatrix& rhs) {
     }
 }
 
+CMatrix::CMatrix(CMatrix&& rhs) {
+    /*--- Take the entries of rhs and leave it empty. ---*/
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    mtx = rhs.mtx;
+    rhs.nRows = 0;
+    rhs.nCols = 0;
+    rhs.mtx = nullptr;
+}
+
 CMatrix::~CMatrix() {
     /*--- Release the memory allocated for the entries. ---*/
     delete[] mtx;
@@ -87,20 +99,31 @@ unsigned CMatrix::getCols() const {
     return nCols;
 }
 
-CMatrixSymmetric CMatrix::toSymmetricStorage() {
-    CMatrixSymmetric res(nCols, nRows, 0.0);
+void CMatrix::resize(const unsigned rows, const unsigned cols) {
+    /*--- Only allocate new memory if the number of entries changes. ---*/
+    if (rows*cols != nRows*nCols) {
+        delete[] mtx;
+        mtx = new double[rows*cols];
+    }
+    nRows = rows;
+    nCols = cols;
+}
 
-    /*--- Convert to symmetric storage using the access operator. ---*/
-    for (unsigned j = 0; j < nCols; j++) {
-        for (unsigned i = j; i < nRows; i++) {
-            res(j, i) = mtx[j*nRows+i];
-        }
+CMatrixSymmetric CMatrix::toSymmetricStorage() const {
+    CMatrixSymmetric res(nRows, nCols, 0.0);
+    double* resPtr = res.getMtxAddress();
+
+    /*--- The lower part of every column is contiguous in both storages, so it
+          is copied as a block. ---*/
+    for (unsigned j = 0; j < nCols && j < nRows; j++) {
+        std::copy(mtx + j*nRows + j, mtx + (j + 1)*nRows, resPtr);
+        resPtr += nRows - j;
     }
 
     return res;
 }
 
-CMatrix CMatrix::transpose() {
+CMatrix CMatrix::transpose() const {
     CMatrix res(nCols, nRows, 0.0);
 
     /*--- Change the i-j indices to obtain the transpose. ---*/
@@ -128,51 +151,112 @@ CMatrix CMatrix::linspace(const double left, const double right,
     return res;
 }
 
-double CMatrix::determinant() {
-    /*--- Initialize variables to use in the subroutine. ---*/
+double CMatrix::determinant() const {
+    /*--- Initialize variables to use in the subroutine. Small matrices, as the
+          Jacobians of the elements, are factorized in buffers on the stack. ---*/
     double res = 1.0;
     int info = 0;
-    CMatrix A = CMatrix(*this);
-    int* vPivPtr = new int[nCols];
-    double* APtr = A.getMtxAddress();
+    double smallA[nSmall*nSmall];
+    int smallPiv[nSmall];
+    std::vector<double> largeA;
+    std::vector<int> largePiv;
+    double* APtr = smallA;
+    int* vPivPtr = smallPiv;
+    if (nCols > nSmall) {
+        largeA.resize(nCols*nCols);
+        largePiv.resize(nCols);
+        APtr = largeA.data();
+        vPivPtr = largePiv.data();
+    }
+    std::copy(mtx, mtx + nCols*nCols, APtr);
 
     /*--- LU decomposition of the matrix. ---*/
     F77NAME(dgetrf)(nCols, nCols, APtr, nCols, vPivPtr, info);
 
     /*--- The determinant will be the product of the diagonal of U. ---*/
     for (unsigned j = 0; j < nCols; j++) {
-        res *= A(j, j);
+        res *= APtr[j*nCols+j];
         if (j != vPivPtr[j]) {
             res *= -1.0;
         }
     }
 
-    /*--- Release allocated memory. ---*/
-    delete[] vPivPtr;
+    return res;
+}
 
+CMatrix CMatrix::inverse() const {
+    CMatrix res;
+    inverse(res);
     return res;
 }
 
-CMatrix CMatrix::inverse() {
-    /*--- Initialize variables to use in the subroutine. ---*/
+void CMatrix::inverse(CMatrix& res) const {
+    /*--- Initialize variables to use in the subroutine. Small matrices use
+          pivots and workspace on the stack. ---*/
     int info = 0;
-    CMatrix A = CMatrix(*this);
-    int* vPivPtr = new int[nCols];
-    double* APtr = A.getMtxAddress();
+    int smallPiv[nSmall];
+    double smallWork[nSmall*nSmall];
+    std::vector<int> largePiv;
+    std::vector<double> largeWork;
+    int* vPivPtr = smallPiv;
+    double* workspace = smallWork;
     int nWorkspace = nCols * nCols;
-    double* workspace = new double[nWorkspace];
+    if (nCols > nSmall) {
+        largePiv.resize(nCols);
+        largeWork.resize(nWorkspace);
+        vPivPtr = largePiv.data();
+        workspace = largeWork.data();
+    }
+    res = *this;
+    double* APtr = res.getMtxAddress();
 
     /*--- LU decomposition of the matrix. ---*/
     F77NAME(dgetrf)(nCols, nCols, APtr, nCols, vPivPtr, info);
 
     /*--- LAPACK subroutine to compute the inverse. ---*/
     F77NAME(dgetri)(nCols, APtr, nCols, vPivPtr, workspace, nWorkspace, info);
+}
+
+CMatrix& CMatrix::setProduct(const CMatrix& lhs, const CMatrix& rhs,
+                             const double alpha) {
+    /*--- An operand sharing the entries of the result needs a temporary. ---*/
+    if (&lhs == this || &rhs == this) return (*this) = lhs * rhs * alpha;
+
+    /*--- Initialize variables to use in the subroutine. The product is
+          computed directly in the entries of the current matrix. ---*/
+    unsigned n = lhs.nCols;
+    resize(lhs.nRows, rhs.nCols);
+    std::fill(mtx, mtx + nRows*nCols, 0.0);
 
-    /*--- Release allocated memory. ---*/
-    delete[] vPivPtr;
-    delete[] workspace;
+    /*--- Compute the product column by column. ---*/
+    for (unsigned j = 0; j < nCols; j++) {
+        for (unsigned k = 0; k < n; k++) {
+            double r = alpha * rhs.mtx[j*n+k];
+            for (unsigned i = 0; i < nRows; i++) {
+                mtx[j*nRows+i] += lhs.mtx[k*nRows+i] * r;
+            }
+        }
+    }
 
-    return A;
+    return *this;
+}
+
+CMatrix& CMatrix::addTransposeProduct(const CMatrix& lhs, const CMatrix& rhs,
+                                      const double alpha) {
+    /*--- Entry (i, j) is the dot product of columns i of lhs and j of rhs,
+          both contiguous in memory. ---*/
+    unsigned n = lhs.nRows;
+    for (unsigned j = 0; j < nCols; j++) {
+        for (unsigned i = 0; i < nRows; i++) {
+            double sum = 0.0;
+            for (unsigned k = 0; k < n; k++) {
+                sum += lhs.mtx[i*n+k] * rhs.mtx[j*n+k];
+            }
+            mtx[j*nRows+i] += alpha * sum;
+        }
+    }
+
+    return *this;
 }
 
 double* CMatrix::getMtxAddress() const {
@@ -201,26 +285,33 @@ CMatrix& CMatrix::operator=(const CMatrix& rhs) {
     /*--- If the matrix is the same, simply return the same matrix. ---*/
     if (&rhs == this) return *this;
 
-    /*--- Release allocated memory for entries in order to allocate new space for
-          different nRows and nCols. ---*/
-    delete mtx;
-    nRows = rhs.getRows();
-    nCols = rhs.getCols();
-
-    /*--- Allocated memory for the new entries. ---*/
-    mtx = new double[nCols*nRows];
+    /*--- The memory of the entries is reused if rhs has the same number of
+          entries, otherwise it is allocated again. ---*/
+    resize(rhs.getRows(), rhs.getCols());
 
     /*--- Copy entries from the rhs to the current matrix. ---*/
-    for (unsigned j = 0; j < nCols; j++) {
-        for (unsigned i = 0; i < nRows; i++) {
-            mtx[j*nRows+i] = rhs.mtx[j*nRows+i];
-        }
-    }
+    std::copy(rhs.mtx, rhs.mtx + nCols*nRows, mtx);
 
     return *this;
 }
 
-CMatrix CMatrix::operator+(const CMatrix& rhs) {
+CMatrix& CMatrix::operator=(CMatrix&& rhs) {
+    /*--- If the matrix is the same, simply return the same matrix. ---*/
+    if (&rhs == this) return *this;
+
+    /*--- Release the current entries and take the ones of rhs. ---*/
+    delete[] mtx;
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    mtx = rhs.mtx;
+    rhs.nRows = 0;
+    rhs.nCols = 0;
+    rhs.mtx = nullptr;
+
+    return *this;
+}
+
+CMatrix CMatrix::operator+(const CMatrix& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Sum every entry. ---*/
@@ -234,13 +325,15 @@ CMatrix CMatrix::operator+(const CMatrix& rhs) {
 }
 
 CMatrix& CMatrix::operator+=(const CMatrix& rhs) {
-    /*--- Use the + overloaded sign to compute +=. ---*/
-    CMatrix res = (*this) + rhs;
-    (*this) = res;
+    /*--- Sum every entry in place. ---*/
+    for (unsigned k = 0; k < nCols*nRows; k++) {
+        mtx[k] += rhs.mtx[k];
+    }
+
     return *this;
 }
 
-CMatrix CMatrix::operator-(const CMatrix& rhs) {
+CMatrix CMatrix::operator-(const CMatrix& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Substract every entry. ---*/
@@ -254,13 +347,15 @@ CMatrix CMatrix::operator-(const CMatrix& rhs) {
 }
 
 CMatrix& CMatrix::operator-=(const CMatrix& rhs) {
-    /*--- Use the - overloaded sign to compute -=. ---*/
-    CMatrix res = (*this) - rhs;
-    (*this) = res;
+    /*--- Substract every entry in place. ---*/
+    for (unsigned k = 0; k < nCols*nRows; k++) {
+        mtx[k] -= rhs.mtx[k];
+    }
+
     return *this;
 }
 
-CMatrix CMatrix::operator*(const CMatrix& rhs) {
+CMatrix CMatrix::operator*(const CMatrix& rhs) const {
     unsigned rhsCols = rhs.getCols();
     CMatrix res(nRows, rhsCols, 0.0);
 
@@ -277,13 +372,21 @@ CMatrix CMatrix::operator*(const CMatrix& rhs) {
 }
 
 CMatrix& CMatrix::operator*=(const CMatrix& rhs) {
-    /*--- Use the * overloaded sign to compute *=. ---*/
-    CMatrix res = (*this) * rhs;
-    (*this) = res;
+    /*--- The product needs new entries, which are moved into the matrix. ---*/
+    (*this) = (*this) * rhs;
+    return *this;
+}
+
+CMatrix& CMatrix::operator*=(const double& rhs) {
+    /*--- Multiply every entry with the constant in place. ---*/
+    for (unsigned k = 0; k < nCols*nRows; k++) {
+        mtx[k] *= rhs;
+    }
+
     return *this;
 }
 
-CMatrix CMatrix::operator+(const double& rhs) {
+CMatrix CMatrix::operator+(const double& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Sum every entry with the constant. ---*/
@@ -297,7 +400,7 @@ CMatrix CMatrix::operator+(const double& rhs) {
 }
 
 
-CMatrix CMatrix::operator-(const double& rhs) {
+CMatrix CMatrix::operator-(const double& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Substract every entry with the constant. ---*/
@@ -311,7 +414,7 @@ CMatrix CMatrix::operator-(const double& rhs) {
 }
 
 
-CMatrix CMatrix::operator*(const double& rhs) {
+CMatrix CMatrix::operator*(const double& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Multiply every entry with the constant. ---*/
@@ -325,7 +428,7 @@ CMatrix CMatrix::operator*(const double& rhs) {
 }
 
 
-CMatrix CMatrix::operator/(const double& rhs) {
+CMatrix CMatrix::operator/(const double& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Divide every entry with the constant. ---*/
@@ -338,7 +441,7 @@ CMatrix CMatrix::operator/(const double& rhs) {
     return res;
 }
 
-CMatrix CMatrix::operator^(const double& rhs) {
+CMatrix CMatrix::operator^(const double& rhs) const {
     CMatrix res(nRows, nCols, 0.0);
 
     /*--- Take the power of every entry with the constant. ---*/
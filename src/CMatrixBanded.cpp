@@ -0,0 +1,146 @@
+/*!
+ * @file CMatrixBanded.cpp
+ * @brief The main subroutines for defining symmetric band matrices and their
+ *        operations.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXBANDED_CPP
+#define __CMATRIXBANDED_CPP
+
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/CMatrixBanded.hpp"
+
+CMatrixBanded::CMatrixBanded() {
+    /*--- Initialize properties. ---*/
+    nRows = 0;
+    nCols = 0;
+    nBands = 0;
+
+    /*--- Allocate memory for the entries. ---*/
+    mtx = new double[0];
+}
+
+CMatrixBanded::CMatrixBanded(unsigned size, unsigned bands,
+                             const double initValue) {
+    /*--- Initialize properties. ---*/
+    nRows = size;
+    nCols = size;
+    nBands = bands;
+
+    /*--- Allocate memory for the entries. The positions below the last row
+          are never used, but LAPACK expects the full band of every column. ---*/
+    mtx = new double[(nBands + 1)*nCols];
+
+    /*--- Initialize entries with initValue. ---*/
+    for (unsigned k = 0; k < (nBands + 1)*nCols; k++) {
+        mtx[k] = initValue;
+    }
+}
+
+CMatrixBanded::CMatrixBanded(const CMatrixBanded& rhs) {
+    /*--- Initialize properties. ---*/
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    nBands = rhs.nBands;
+
+    /*--- Allocate memory for the entries. ---*/
+    mtx = new double[(nBands + 1)*nCols];
+
+    /*--- Initialize entries with the same entries in rhs. ---*/
+    for (unsigned k = 0; k < (nBands + 1)*nCols; k++) {
+        mtx[k] = rhs.mtx[k];
+    }
+}
+
+CMatrixBanded::~CMatrixBanded() {
+    /*--- Release the memory allocated for the entries. ---*/
+    delete[] mtx;
+}
+
+unsigned CMatrixBanded::getRows() const {
+    return nRows;
+}
+
+unsigned CMatrixBanded::getCols() const {
+    return nCols;
+}
+
+unsigned CMatrixBanded::getNBands() const {
+    return nBands;
+}
+
+double* CMatrixBanded::getMtxAddress() const {
+    return &mtx[0];
+}
+
+void CMatrixBanded::printMtx() {
+    const CMatrixBanded& A = *this;
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned j = 0; j < nCols; j++) {
+            std::cout.width(10);
+            std::cout << A(i, j) << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+double& CMatrixBanded::operator()(const unsigned i, const unsigned j) {
+    if (i < j) return (*this)(j, i);
+    if (i - j > nBands)
+        throw std::runtime_error("Entry outside the band");
+    return mtx[j*(nBands + 1) + i - j];
+}
+
+double CMatrixBanded::operator()(const unsigned i, const unsigned j) const {
+    if (i < j) return (*this)(j, i);
+    if (i - j > nBands) return 0.0;
+    return mtx[j*(nBands + 1) + i - j];
+}
+
+CMatrixBanded& CMatrixBanded::operator=(const CMatrixBanded& rhs) {
+    /*--- If the matrix is the same, simply return the same matrix. ---*/
+    if (&rhs == this) return *this;
+
+    /*--- Release allocated memory for entries in order to allocate new space for
+          a different size or band. ---*/
+    delete[] mtx;
+    nRows = rhs.getRows();
+    nCols = rhs.getCols();
+    nBands = rhs.getNBands();
+
+    /*--- Allocated memory for the new entries. ---*/
+    mtx = new double[(nBands + 1)*nCols];
+
+    /*--- Copy entries from the rhs to the current matrix. ---*/
+    for (unsigned k = 0; k < (nBands + 1)*nCols; k++) {
+        mtx[k] = rhs.mtx[k];
+    }
+
+    return *this;
+}
+
+#endif
@@ -0,0 +1,200 @@
+/*!
+ * @file CMatrixCompressedRow.cpp
+ * @brief The main subroutines for defining the storage in compressed sparse
+ *        row (CSR) format shared by the general and the symmetric sparse
+ *        matrices.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXCOMPRESSEDROW_CPP
+#define __CMATRIXCOMPRESSEDROW_CPP
+
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/CMatrixCompressedRow.hpp"
+
+CMatrixCompressedRow::CMatrixCompressedRow() {
+    /*--- Initialize properties. ---*/
+    nRows = 0;
+    nCols = 0;
+    nNonZero = 0;
+
+    /*--- Allocate memory for the pattern and the entries. ---*/
+    rowPtr = new unsigned[1];
+    rowPtr[0] = 0;
+    colIdx = new unsigned[0];
+    mtx = new double[0];
+}
+
+CMatrixCompressedRow::CMatrixCompressedRow(unsigned rows, unsigned cols,
+                                           const unsigned* rowPtrs,
+                                           const unsigned* colIdxs,
+                                           const double initValue) {
+    /*--- Initialize properties. ---*/
+    nRows = rows;
+    nCols = cols;
+    nNonZero = rowPtrs[rows];
+
+    /*--- Allocate memory for the pattern and the entries. ---*/
+    rowPtr = new unsigned[nRows + 1];
+    colIdx = new unsigned[nNonZero];
+    mtx = new double[nNonZero];
+
+    /*--- Copy the sparsity pattern and initialize entries with initValue. ---*/
+    for (unsigned i = 0; i < nRows + 1; i++) {
+        rowPtr[i] = rowPtrs[i];
+    }
+    for (unsigned k = 0; k < nNonZero; k++) {
+        colIdx[k] = colIdxs[k];
+        mtx[k] = initValue;
+    }
+}
+
+CMatrixCompressedRow::CMatrixCompressedRow(const CMatrixCompressedRow& rhs) {
+    /*--- Initialize properties. ---*/
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    nNonZero = rhs.nNonZero;
+
+    /*--- Allocate memory for the pattern and the entries. ---*/
+    rowPtr = new unsigned[nRows + 1];
+    colIdx = new unsigned[nNonZero];
+    mtx = new double[nNonZero];
+
+    /*--- Initialize pattern and entries with the ones in rhs. ---*/
+    for (unsigned i = 0; i < nRows + 1; i++) {
+        rowPtr[i] = rhs.rowPtr[i];
+    }
+    for (unsigned k = 0; k < nNonZero; k++) {
+        colIdx[k] = rhs.colIdx[k];
+        mtx[k] = rhs.mtx[k];
+    }
+}
+
+CMatrixCompressedRow::~CMatrixCompressedRow() {
+    /*--- Release the memory allocated for the pattern and the entries. ---*/
+    delete[] rowPtr;
+    delete[] colIdx;
+    delete[] mtx;
+}
+
+void CMatrixCompressedRow::copy(const CMatrixCompressedRow& rhs) {
+    /*--- If the matrix is the same, there is nothing to copy. ---*/
+    if (&rhs == this) return;
+
+    /*--- Release allocated memory in order to allocate new space for a
+          different pattern. ---*/
+    delete[] rowPtr;
+    delete[] colIdx;
+    delete[] mtx;
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    nNonZero = rhs.nNonZero;
+
+    /*--- Allocated memory for the new pattern and entries. ---*/
+    rowPtr = new unsigned[nRows + 1];
+    colIdx = new unsigned[nNonZero];
+    mtx = new double[nNonZero];
+
+    /*--- Copy pattern and entries from the rhs to the current matrix. ---*/
+    for (unsigned i = 0; i < nRows + 1; i++) {
+        rowPtr[i] = rhs.rowPtr[i];
+    }
+    for (unsigned k = 0; k < nNonZero; k++) {
+        colIdx[k] = rhs.colIdx[k];
+        mtx[k] = rhs.mtx[k];
+    }
+}
+
+unsigned CMatrixCompressedRow::getRows() const {
+    return nRows;
+}
+
+unsigned CMatrixCompressedRow::getCols() const {
+    return nCols;
+}
+
+unsigned CMatrixCompressedRow::getNNonZero() const {
+    return nNonZero;
+}
+
+unsigned* CMatrixCompressedRow::getRowPtrAddress() const {
+    return &rowPtr[0];
+}
+
+unsigned* CMatrixCompressedRow::getColIdxAddress() const {
+    return &colIdx[0];
+}
+
+double* CMatrixCompressedRow::getMtxAddress() const {
+    return &mtx[0];
+}
+
+void CMatrixCompressedRow::printMtx() {
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned j = 0; j < nCols; j++) {
+            std::cout.width(10);
+            std::cout << (*this)(i, j) << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int CMatrixCompressedRow::findInRow(const unsigned i, const unsigned j) const {
+    /*--- Binary search of the column inside the row, which is sorted. ---*/
+    unsigned lo = rowPtr[i];
+    unsigned hi = rowPtr[i + 1];
+    while (lo < hi) {
+        unsigned mid = lo + (hi - lo) / 2;
+        if (colIdx[mid] < j) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < rowPtr[i + 1] && colIdx[lo] == j) return lo;
+    return -1;
+}
+
+int CMatrixCompressedRow::findEntry(const unsigned i, const unsigned j) const {
+    return findInRow(i, j);
+}
+
+void CMatrixCompressedRow::addEntry(const unsigned i, const unsigned j,
+                                    const double val) {
+    int pos = findEntry(i, j);
+    if (pos < 0)
+        throw std::runtime_error("Entry outside the sparsity pattern");
+    mtx[pos] += val;
+}
+
+double CMatrixCompressedRow::operator()(const unsigned i,
+                                        const unsigned j) const {
+    int pos = findEntry(i, j);
+    if (pos < 0) return 0.0;
+    return mtx[pos];
+}
+
+#endif
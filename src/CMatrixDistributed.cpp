@@ -0,0 +1,396 @@
+/*!
+ * @file CMatrixDistributed.cpp
+ * @brief The main subroutines for defining sparse matrices whose rows are
+ *        distributed among the MPI ranks.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXDISTRIBUTED_CPP
+#define __CMATRIXDISTRIBUTED_CPP
+
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+#include "../include/CMatrixDistributed.hpp"
+
+CMatrixDistributed::CMatrixDistributed() {
+    /*--- Initialize properties. ---*/
+    nGlobal = 0;
+    nLocal = 0;
+    firstRow = 0;
+    rowPtr.assign(1, 0);
+}
+
+CMatrixDistributed::CMatrixDistributed(const CMatrixSparseSymmetric& A)
+    : CMatrixDistributed(A, balancedOffsets(A.getRows())) {}
+
+CMatrixDistributed::CMatrixDistributed(const CMatrixSparseSymmetric& A,
+                                       const std::vector<unsigned>& offsets)
+    : CMatrixDistributed(ownedRows(A, offsets), offsets) {}
+
+CMatrixDistributed::CMatrixDistributed(const CMatrixSparse& lower,
+                                       const std::vector<unsigned>& offsets) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    int rank;
+    int nRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+    unsigned* lRowPtr = lower.getRowPtrAddress();
+    unsigned* lColIdx = lower.getColIdxAddress();
+    double* LPtr = lower.getMtxAddress();
+
+    /*--- Blocks of consecutive rows given by the caller. ---*/
+    nGlobal = lower.getCols();
+    rowOffsets = offsets;
+    firstRow = rowOffsets[rank];
+    nLocal = rowOffsets[rank + 1] - firstRow;
+    unsigned lastRow = firstRow + nLocal;
+    if (lower.getRows() != nLocal)
+        throw std::runtime_error("Rows of the rank differ from the offsets");
+
+    /*--- Only the lower triangle is stored, so the stored entry (i, j) is in
+          row i and, out of the diagonal, in row j. The entries of the owned
+          rows with a column of a previous rank are sent to its owner, with
+          their global row and column. ---*/
+    std::vector< std::vector<unsigned> > sendPair(nRanks);
+    std::vector< std::vector<double> > sendVal(nRanks);
+    for (unsigned i = 0; i < nLocal; i++) {
+        for (unsigned k = lRowPtr[i]; k < lRowPtr[i + 1]; k++) {
+            unsigned j = lColIdx[k];
+            if (j >= firstRow) break;
+            int owner = std::upper_bound(rowOffsets.begin(), rowOffsets.end(),
+                                         j) - rowOffsets.begin() - 1;
+            sendPair[owner].push_back(firstRow + i);
+            sendPair[owner].push_back(j);
+            sendVal[owner].push_back(LPtr[k]);
+        }
+    }
+    std::vector<int> sendCount(nRanks);
+    std::vector<int> recvCount(nRanks);
+    for (int r = 0; r < nRanks; r++) {
+        sendCount[r] = sendVal[r].size();
+    }
+    MPI_Alltoall(sendCount.data(), 1, MPI_INT, recvCount.data(), 1, MPI_INT,
+                 MPI_COMM_WORLD);
+    std::vector<unsigned> recvPos(nRanks + 1, 0);
+    for (int r = 0; r < nRanks; r++) {
+        recvPos[r + 1] = recvPos[r] + recvCount[r];
+    }
+    std::vector<unsigned> recvIdx(2*recvPos[nRanks]);
+    std::vector<double> recvVal(recvPos[nRanks]);
+    std::vector<MPI_Request> reqs;
+    for (int r = 0; r < nRanks; r++) {
+        if (recvCount[r] > 0) {
+            reqs.push_back(MPI_Request());
+            MPI_Irecv(&recvIdx[2*recvPos[r]], 2*recvCount[r], MPI_UNSIGNED, r,
+                      1, MPI_COMM_WORLD, &reqs.back());
+            reqs.push_back(MPI_Request());
+            MPI_Irecv(&recvVal[recvPos[r]], recvCount[r], MPI_DOUBLE, r, 2,
+                      MPI_COMM_WORLD, &reqs.back());
+        }
+    }
+    for (int r = 0; r < nRanks; r++) {
+        if (sendCount[r] > 0) {
+            reqs.push_back(MPI_Request());
+            MPI_Isend(sendPair[r].data(), 2*sendCount[r], MPI_UNSIGNED, r, 1,
+                      MPI_COMM_WORLD, &reqs.back());
+            reqs.push_back(MPI_Request());
+            MPI_Isend(sendVal[r].data(), sendCount[r], MPI_DOUBLE, r, 2,
+                      MPI_COMM_WORLD, &reqs.back());
+        }
+    }
+    MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
+
+    /*--- Full owned rows. A row takes its own entries, whose columns are not
+          larger than the row, then the transposed entries of the next owned
+          rows and last the received ones, which come from the next ranks in
+          order. So the columns of every full row are sorted. ---*/
+    rowPtr.assign(nLocal + 1, 0);
+    for (unsigned i = 0; i < nLocal; i++) {
+        for (unsigned k = lRowPtr[i]; k < lRowPtr[i + 1]; k++) {
+            unsigned j = lColIdx[k];
+            rowPtr[i + 1]++;
+            if (j != firstRow + i && j >= firstRow) rowPtr[j - firstRow + 1]++;
+        }
+    }
+    for (unsigned k = 0; k < recvVal.size(); k++) {
+        rowPtr[recvIdx[2*k+1] - firstRow + 1]++;
+    }
+    for (unsigned i = 0; i < nLocal; i++) {
+        rowPtr[i + 1] += rowPtr[i];
+    }
+    std::vector<unsigned> globalCol(rowPtr[nLocal]);
+    std::vector<unsigned> fill(rowPtr.begin(), rowPtr.end() - 1);
+    mtx.resize(rowPtr[nLocal]);
+    for (unsigned i = 0; i < nLocal; i++) {
+        for (unsigned k = lRowPtr[i]; k < lRowPtr[i + 1]; k++) {
+            unsigned pos = fill[i]++;
+            globalCol[pos] = lColIdx[k];
+            mtx[pos] = LPtr[k];
+        }
+    }
+    for (unsigned i = 0; i < nLocal; i++) {
+        for (unsigned k = lRowPtr[i]; k < lRowPtr[i + 1]; k++) {
+            unsigned j = lColIdx[k];
+            if (j == firstRow + i || j < firstRow) continue;
+            unsigned pos = fill[j - firstRow]++;
+            globalCol[pos] = firstRow + i;
+            mtx[pos] = LPtr[k];
+        }
+    }
+    for (unsigned k = 0; k < recvVal.size(); k++) {
+        unsigned pos = fill[recvIdx[2*k+1] - firstRow]++;
+        globalCol[pos] = recvIdx[2*k];
+        mtx[pos] = recvVal[k];
+    }
+
+    /*--- Ghost columns sorted by global row, which groups them by owner. ---*/
+    for (unsigned k = 0; k < globalCol.size(); k++) {
+        if (globalCol[k] < firstRow || globalCol[k] >= lastRow)
+            ghostRows.push_back(globalCol[k]);
+    }
+    std::sort(ghostRows.begin(), ghostRows.end());
+    ghostRows.erase(std::unique(ghostRows.begin(), ghostRows.end()),
+                    ghostRows.end());
+
+    /*--- Local columns, and rows that can be multiplied before the ghosts
+          arrive. ---*/
+    colIdx.resize(globalCol.size());
+    for (unsigned i = 0; i < nLocal; i++) {
+        bool hasGhost = false;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = globalCol[k];
+            if (j >= firstRow && j < lastRow) {
+                colIdx[k] = j - firstRow;
+            } else {
+                colIdx[k] = nLocal + (std::lower_bound(ghostRows.begin(),
+                                                       ghostRows.end(), j)
+                                      - ghostRows.begin());
+                hasGhost = true;
+            }
+        }
+        if (hasGhost) {
+            boundaryRows.push_back(i);
+        } else {
+            interiorRows.push_back(i);
+        }
+    }
+
+    /*--- Ghosts received from every neighbour. ---*/
+    recvPtr.push_back(0);
+    for (unsigned g = 0; g < ghostRows.size(); g++) {
+        int owner = std::upper_bound(rowOffsets.begin(), rowOffsets.end(),
+                                     ghostRows[g]) - rowOffsets.begin() - 1;
+        if (neighbours.empty() || neighbours.back() != owner) {
+            if (!neighbours.empty()) recvPtr.push_back(g);
+            neighbours.push_back(owner);
+        }
+    }
+    if (!neighbours.empty()) recvPtr.push_back(ghostRows.size());
+
+    /*--- The pattern is symmetric, so a neighbour needs the owned rows that
+          have columns in its block, in the same order as its ghosts. ---*/
+    sendPtr.push_back(0);
+    for (unsigned q = 0; q < neighbours.size(); q++) {
+        unsigned qFirst = rowOffsets[neighbours[q]];
+        unsigned qLast = rowOffsets[neighbours[q] + 1];
+        for (unsigned i = 0; i < nLocal; i++) {
+            for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                if (globalCol[k] >= qFirst && globalCol[k] < qLast) {
+                    sendIdx.push_back(i);
+                    break;
+                }
+            }
+        }
+        sendPtr.push_back(sendIdx.size());
+    }
+
+    /*--- Buffers of the products. ---*/
+    xExt.resize(nLocal + ghostRows.size());
+    sendBuf.resize(sendIdx.size());
+}
+
+CMatrixDistributed::~CMatrixDistributed() {}
+
+std::vector<unsigned> CMatrixDistributed::balancedOffsets(const unsigned n) {
+    /*--- Blocks of consecutive rows of nearly the same size. ---*/
+    int nRanks;
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+    std::vector<unsigned> offsets(nRanks + 1);
+    for (int r = 0; r <= nRanks; r++) {
+        offsets[r] = (unsigned long long)n * r / nRanks;
+    }
+
+    return offsets;
+}
+
+CMatrixSparse CMatrixDistributed::ownedRows(const CMatrixSparseSymmetric& A,
+                                            const std::vector<unsigned>& offsets) {
+    /*--- Rows of the block of the rank, which are contiguous in the CSR
+          storage. ---*/
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    unsigned first = offsets[rank];
+    unsigned nRows = offsets[rank + 1] - first;
+    unsigned* aRowPtr = A.getRowPtrAddress();
+    unsigned* aColIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+    std::vector<unsigned> rowPtr(nRows + 1, 0);
+    for (unsigned i = 0; i < nRows; i++) {
+        rowPtr[i + 1] = aRowPtr[first + i + 1] - aRowPtr[first];
+    }
+    CMatrixSparse res(nRows, A.getCols(), rowPtr.data(),
+                      &aColIdx[aRowPtr[first]], 0.0);
+    std::copy(&APtr[aRowPtr[first]], &APtr[aRowPtr[first + nRows]],
+              res.getMtxAddress());
+
+    return res;
+}
+
+unsigned CMatrixDistributed::getRows() const {
+    return nLocal;
+}
+
+unsigned CMatrixDistributed::getCols() const {
+    return nLocal;
+}
+
+unsigned CMatrixDistributed::getGlobalRows() const {
+    return nGlobal;
+}
+
+unsigned CMatrixDistributed::getFirstRow() const {
+    return firstRow;
+}
+
+unsigned CMatrixDistributed::getNGhosts() const {
+    return ghostRows.size();
+}
+
+unsigned CMatrixDistributed::getNNeighbours() const {
+    return neighbours.size();
+}
+
+CMatrixSparseSymmetric CMatrixDistributed::getDiagonalBlock() const {
+    std::vector<unsigned> blkRowPtr(nLocal + 1, 0);
+    std::vector<unsigned> blkColIdx;
+    std::vector<double> blkVal;
+
+    /*--- Owned columns of the lower triangle. They keep the order of the
+          global columns, so the diagonal is the last entry of every row. ---*/
+    for (unsigned i = 0; i < nLocal; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (colIdx[k] <= i) {
+                blkColIdx.push_back(colIdx[k]);
+                blkVal.push_back(mtx[k]);
+            }
+        }
+        blkRowPtr[i + 1] = blkColIdx.size();
+    }
+
+    CMatrixSparseSymmetric res(nLocal, nLocal, blkRowPtr.data(),
+                               blkColIdx.data(), 0.0);
+    double* resPtr = res.getMtxAddress();
+    for (unsigned k = 0; k < blkVal.size(); k++) {
+        resPtr[k] = blkVal[k];
+    }
+
+    return res;
+}
+
+CMatrix CMatrixDistributed::getLocalVector(const CMatrix& v) const {
+    CMatrix res = CMatrix(nLocal, 1, 0.0);
+    for (unsigned i = 0; i < nLocal; i++) {
+        res(i, 0) = v(firstRow + i, 0);
+    }
+
+    return res;
+}
+
+CMatrix CMatrixDistributed::gatherVector(const CMatrix& v) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nRanks = rowOffsets.size() - 1;
+    std::vector<int> counts(nRanks);
+    std::vector<int> displs(nRanks);
+    for (unsigned r = 0; r < nRanks; r++) {
+        counts[r] = rowOffsets[r + 1] - rowOffsets[r];
+        displs[r] = rowOffsets[r];
+    }
+    CMatrix res = CMatrix(nGlobal, 1, 0.0);
+
+    /*--- Every rank receives the blocks of all the ranks. ---*/
+    MPI_Allgatherv(v.getMtxAddress(), nLocal, MPI_DOUBLE, res.getMtxAddress(),
+                   counts.data(), displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+
+    return res;
+}
+
+void CMatrixDistributed::multiply(const double* x, double* y, double alpha,
+                                  double beta) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nNb = neighbours.size();
+    std::vector<MPI_Request> reqs(2*nNb);
+
+    /*--- Start the exchange of the ghost entries. ---*/
+    for (unsigned q = 0; q < nNb; q++) {
+        MPI_Irecv(&xExt[nLocal + recvPtr[q]], recvPtr[q + 1] - recvPtr[q],
+                  MPI_DOUBLE, neighbours[q], 0, MPI_COMM_WORLD, &reqs[q]);
+    }
+    for (unsigned k = 0; k < sendIdx.size(); k++) {
+        sendBuf[k] = x[sendIdx[k]];
+    }
+    for (unsigned q = 0; q < nNb; q++) {
+        MPI_Isend(&sendBuf[sendPtr[q]], sendPtr[q + 1] - sendPtr[q],
+                  MPI_DOUBLE, neighbours[q], 0, MPI_COMM_WORLD, &reqs[nNb + q]);
+    }
+    std::copy(x, x + nLocal, xExt.begin());
+
+    /*--- Rows without ghosts while the messages are in flight. ---*/
+    for (unsigned r = 0; r < interiorRows.size(); r++) {
+        unsigned i = interiorRows[r];
+        double sum = 0.0;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            sum += mtx[k] * xExt[colIdx[k]];
+        }
+        y[i] = alpha * sum + (beta == 0.0 ? 0.0 : beta * y[i]);
+    }
+
+    /*--- Rows with ghosts once the exchange is complete. ---*/
+    MPI_Waitall(2*nNb, reqs.data(), MPI_STATUSES_IGNORE);
+    for (unsigned r = 0; r < boundaryRows.size(); r++) {
+        unsigned i = boundaryRows[r];
+        double sum = 0.0;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            sum += mtx[k] * xExt[colIdx[k]];
+        }
+        y[i] = alpha * sum + (beta == 0.0 ? 0.0 : beta * y[i]);
+    }
+}
+
+#endif
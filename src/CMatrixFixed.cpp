@@ -0,0 +1,233 @@
+/*!
+ * @file CMatrixFixed.cpp
+ * @brief The main subroutines for defining small matrices with the size fixed
+ *        at compile time and their operations.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXFIXED_CPP
+#define __CMATRIXFIXED_CPP
+
+#include "../include/CMatrixFixed.hpp"
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C>::CMatrixFixed() {
+    for (unsigned k = 0; k < R*C; k++) {
+        mtx[k] = 0.0;
+    }
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C>::CMatrixFixed(const double initValue) {
+    for (unsigned k = 0; k < R*C; k++) {
+        mtx[k] = initValue;
+    }
+}
+
+template <unsigned R, unsigned C>
+unsigned CMatrixFixed<R, C>::getRows() const {
+    return R;
+}
+
+template <unsigned R, unsigned C>
+unsigned CMatrixFixed<R, C>::getCols() const {
+    return C;
+}
+
+template <unsigned R, unsigned C>
+double* CMatrixFixed<R, C>::getMtxAddress() {
+    return &mtx[0];
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<C, R> CMatrixFixed<R, C>::transpose() const {
+    CMatrixFixed<C, R> res;
+
+    /*--- Change the i-j indices to obtain the transpose. ---*/
+    for (unsigned j = 0; j < C; j++) {
+        for (unsigned i = 0; i < R; i++) {
+            res(j, i) = mtx[j*R+i];
+        }
+    }
+
+    return res;
+}
+
+template <unsigned R, unsigned C>
+double CMatrixFixed<R, C>::determinant() const {
+    static_assert(R == 0, "Closed-form determinant only for square matrices "
+                          "up to 3x3");
+    return 0.0;
+}
+
+template <>
+inline double CMatrixFixed<1, 1>::determinant() const {
+    return mtx[0];
+}
+
+template <>
+inline double CMatrixFixed<2, 2>::determinant() const {
+    return mtx[0]*mtx[3] - mtx[2]*mtx[1];
+}
+
+template <>
+inline double CMatrixFixed<3, 3>::determinant() const {
+    /*--- Cofactor expansion along the first column. ---*/
+    return mtx[0]*(mtx[4]*mtx[8] - mtx[7]*mtx[5]) -
+           mtx[1]*(mtx[3]*mtx[8] - mtx[6]*mtx[5]) +
+           mtx[2]*(mtx[3]*mtx[7] - mtx[6]*mtx[4]);
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C> CMatrixFixed<R, C>::inverse() const {
+    static_assert(R == 0, "Closed-form inverse only for square matrices "
+                          "up to 3x3");
+    return CMatrixFixed<R, C>();
+}
+
+template <>
+inline CMatrixFixed<1, 1> CMatrixFixed<1, 1>::inverse() const {
+    return CMatrixFixed<1, 1>(1.0 / mtx[0]);
+}
+
+template <>
+inline CMatrixFixed<2, 2> CMatrixFixed<2, 2>::inverse() const {
+    /*--- Adjugate divided by the determinant. ---*/
+    CMatrixFixed<2, 2> res;
+    double invDet = 1.0 / determinant();
+    res(0, 0) = mtx[3] * invDet;
+    res(1, 0) = -mtx[1] * invDet;
+    res(0, 1) = -mtx[2] * invDet;
+    res(1, 1) = mtx[0] * invDet;
+    return res;
+}
+
+template <>
+inline CMatrixFixed<3, 3> CMatrixFixed<3, 3>::inverse() const {
+    /*--- Adjugate divided by the determinant. ---*/
+    CMatrixFixed<3, 3> res;
+    const CMatrixFixed<3, 3>& A = *this;
+    double invDet = 1.0 / determinant();
+    res(0, 0) = (A(1, 1)*A(2, 2) - A(1, 2)*A(2, 1)) * invDet;
+    res(0, 1) = (A(0, 2)*A(2, 1) - A(0, 1)*A(2, 2)) * invDet;
+    res(0, 2) = (A(0, 1)*A(1, 2) - A(0, 2)*A(1, 1)) * invDet;
+    res(1, 0) = (A(1, 2)*A(2, 0) - A(1, 0)*A(2, 2)) * invDet;
+    res(1, 1) = (A(0, 0)*A(2, 2) - A(0, 2)*A(2, 0)) * invDet;
+    res(1, 2) = (A(0, 2)*A(1, 0) - A(0, 0)*A(1, 2)) * invDet;
+    res(2, 0) = (A(1, 0)*A(2, 1) - A(1, 1)*A(2, 0)) * invDet;
+    res(2, 1) = (A(0, 1)*A(2, 0) - A(0, 0)*A(2, 1)) * invDet;
+    res(2, 2) = (A(0, 0)*A(1, 1) - A(0, 1)*A(1, 0)) * invDet;
+    return res;
+}
+
+template <unsigned R, unsigned C>
+double& CMatrixFixed<R, C>::operator()(const unsigned i, const unsigned j) {
+    return mtx[j*R+i];
+}
+
+template <unsigned R, unsigned C>
+const double& CMatrixFixed<R, C>::operator()(const unsigned i,
+                                             const unsigned j) const {
+    return mtx[j*R+i];
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C> CMatrixFixed<R, C>::operator+(
+        const CMatrixFixed<R, C>& rhs) const {
+    CMatrixFixed<R, C> res;
+
+    /*--- Sum every entry. ---*/
+    for (unsigned k = 0; k < R*C; k++) {
+        res.mtx[k] = mtx[k] + rhs.mtx[k];
+    }
+
+    return res;
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C>& CMatrixFixed<R, C>::operator+=(
+        const CMatrixFixed<R, C>& rhs) {
+    /*--- Sum every entry in place. ---*/
+    for (unsigned k = 0; k < R*C; k++) {
+        mtx[k] += rhs.mtx[k];
+    }
+
+    return *this;
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C> CMatrixFixed<R, C>::operator-(
+        const CMatrixFixed<R, C>& rhs) const {
+    CMatrixFixed<R, C> res;
+
+    /*--- Substract every entry. ---*/
+    for (unsigned k = 0; k < R*C; k++) {
+        res.mtx[k] = mtx[k] - rhs.mtx[k];
+    }
+
+    return res;
+}
+
+template <unsigned R, unsigned C>
+template <unsigned K>
+CMatrixFixed<R, K> CMatrixFixed<R, C>::operator*(
+        const CMatrixFixed<C, K>& rhs) const {
+    CMatrixFixed<R, K> res;
+
+    /*--- Compute the product of matrices column by column. ---*/
+    for (unsigned j = 0; j < K; j++) {
+        for (unsigned k = 0; k < C; k++) {
+            double r = rhs(k, j);
+            for (unsigned i = 0; i < R; i++) {
+                res(i, j) += mtx[k*R+i] * r;
+            }
+        }
+    }
+
+    return res;
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C> CMatrixFixed<R, C>::operator*(const double& rhs) const {
+    CMatrixFixed<R, C> res;
+
+    /*--- Multiply every entry with the constant. ---*/
+    for (unsigned k = 0; k < R*C; k++) {
+        res.mtx[k] = mtx[k] * rhs;
+    }
+
+    return res;
+}
+
+template <unsigned R, unsigned C>
+CMatrixFixed<R, C>& CMatrixFixed<R, C>::operator*=(const double& rhs) {
+    /*--- Multiply every entry with the constant in place. ---*/
+    for (unsigned k = 0; k < R*C; k++) {
+        mtx[k] *= rhs;
+    }
+
+    return *this;
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*!
+ * @file CMatrixFree.cpp
+ * @brief The main subroutines for applying the conductance matrix element by
+ *        element, without assembling it.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXFREE_CPP
+#define __CMATRIXFREE_CPP
+
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+
+#include "../include/CMatrixFree.hpp"
+#include "../include/CMatrix.hpp"
+#include "../include/CConductance.hpp"
+#include "../include/CMesh.hpp"
+#include "../include/CBoundaryConditions.hpp"
+
+CMatrixFree::CMatrixFree() {
+    /*--- Initialize properties. ---*/
+    nRows = 0;
+    nDof = 0;
+    nNodPerEl = 0;
+    initEl = 0;
+    finaEl = 0;
+}
+
+CMatrixFree::CMatrixFree(const CConductance& cnd, const CMesh& msh,
+                         const CBoundaryConditions& bnd) {
+    /*--- Initialize properties. ---*/
+    nRows = bnd.getNReducedDof();
+    nDof = msh.getNDofTotal();
+    nNodPerEl = msh.getNNodePerElem();
+    unsigned dfPerNod = msh.getDofPerNode();
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrixIndex& glDof = msh.getGlDofMtx();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+
+    /*--- Elemental matrices of the strip of this rank, computed once per
+          group of elements with the same geometry with the batched kernel. ---*/
+    cnd.elementMatrices(cnd.getGeometry(), cnd.getMaterial(), msh, initEl,
+                        finaEl, elClass, classKe);
+
+    /*--- DOF of the nodes of every element of this rank. ---*/
+    elemDof.resize((finaEl - initEl)*nNodPerEl);
+    for (unsigned e = initEl; e < finaEl; e++) {
+        for (unsigned a = 0; a < nNodPerEl; a++) {
+            elemDof[(e-initEl)*nNodPerEl+a] = glDof(conn(e, a + 1), dfPerNod);
+        }
+    }
+
+    /*--- Row of every DOF at known flux. ---*/
+    dofPos.assign(nDof, -1);
+    for (unsigned i = 0; i < nRows; i++) {
+        dofPos[rDofVec(0, i)] = i;
+    }
+}
+
+CMatrixFree::~CMatrixFree() {}
+
+unsigned CMatrixFree::getRows() const {
+    return nRows;
+}
+
+unsigned CMatrixFree::getCols() const {
+    return nRows;
+}
+
+void CMatrixFree::globalMul(const double* x, double* y) const {
+    std::fill(y, y + nDof, 0.0);
+    if (nNodPerEl == 8) {
+        elementMul<8>(x, y);
+    } else if (nNodPerEl == 9) {
+        elementMul<9>(x, y);
+    } else {
+        elementMul<4>(x, y);
+    }
+
+    /*--- Every rank applied the elements of its strip, so the partial
+          products are summed. ---*/
+    int nRanks;
+    MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+    if (nRanks > 1) {
+        MPI_Allreduce(MPI_IN_PLACE, y, nDof, MPI_DOUBLE, MPI_SUM,
+                      MPI_COMM_WORLD);
+    }
+}
+
+template <unsigned N>
+void CMatrixFree::elementMul(const double* x, double* y) const {
+    /*--- Every element gathers its entries of x, multiplies them with the
+          conductance matrix of its group and scatters the result. ---*/
+    for (unsigned e = 0; e < finaEl - initEl; e++) {
+        const unsigned* eDof = &elemDof[e*N];
+        const double* Ke = &classKe[elClass[e]*N*N];
+        for (unsigned b = 0; b < N; b++) {
+            double xb = x[eDof[b]];
+            if (xb == 0.0) continue;
+            for (unsigned a = 0; a < N; a++) {
+                y[eDof[a]] += Ke[b*N+a] * xb;
+            }
+        }
+    }
+}
+
+void CMatrixFree::multiply(const double* x, double* y, const double alpha,
+                           const double beta) const {
+    /*--- Extend x with zeros at the known temperatures. ---*/
+    std::vector<double> xGlobal(nDof, 0.0);
+    std::vector<double> yGlobal(nDof, 0.0);
+    for (unsigned i = 0; i < nDof; i++) {
+        if (dofPos[i] >= 0) xGlobal[i] = x[dofPos[i]];
+    }
+
+    /*--- Global product and restriction to the rows of Kff. ---*/
+    globalMul(xGlobal.data(), yGlobal.data());
+    for (unsigned i = 0; i < nDof; i++) {
+        if (dofPos[i] < 0) continue;
+        double& yi = y[dofPos[i]];
+        yi = alpha * yGlobal[i] + (beta == 0.0 ? 0.0 : beta * yi);
+    }
+}
+
+CMatrix CMatrixFree::globalProduct(const CMatrix& T) const {
+    CMatrix res = CMatrix(nDof, 1, 0.0);
+    globalMul(T.getMtxAddress(), res.getMtxAddress());
+    return res;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*!
+ * @file CMatrixIndex.cpp
+ * @brief The main subroutines for defining matrices of indices.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXINDEX_CPP
+#define __CMATRIXINDEX_CPP
+
+#include <vector>
+
+#include "../include/CMatrixIndex.hpp"
+
+CMatrixIndex::CMatrixIndex() {
+    /*--- Initialize properties. ---*/
+    nRows = 0;
+    nCols = 0;
+}
+
+CMatrixIndex::CMatrixIndex(unsigned rows, unsigned cols,
+                           const unsigned initValue) {
+    /*--- Initialize properties and entries. ---*/
+    nRows = rows;
+    nCols = cols;
+    mtx.assign(nRows * nCols, initValue);
+}
+
+CMatrixIndex::~CMatrixIndex() {}
+
+unsigned CMatrixIndex::getRows() const {
+    return nRows;
+}
+
+unsigned CMatrixIndex::getCols() const {
+    return nCols;
+}
+
+const unsigned* CMatrixIndex::getRowAddress(const unsigned i) const {
+    return &mtx[i*nCols];
+}
+
+unsigned& CMatrixIndex::operator()(const unsigned i, const unsigned j) {
+    return mtx[i*nCols+j];
+}
+
+const unsigned& CMatrixIndex::operator()(const unsigned i,
+                                         const unsigned j) const {
+    return mtx[i*nCols+j];
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*!
+ * @file CMatrixSparse.cpp
+ * @brief The main subroutines for defining sparse matrices in compressed sparse
+ *        row (CSR) format and their operations.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXSPARSE_CPP
+#define __CMATRIXSPARSE_CPP
+
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixCompressedRow.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+
+CMatrixSparse::CMatrixSparse() : CMatrixCompressedRow() {}
+
+CMatrixSparse::CMatrixSparse(unsigned rows, unsigned cols,
+                             const unsigned* rowPtrs, const unsigned* colIdxs,
+                             const double initValue)
+    : CMatrixCompressedRow(rows, cols, rowPtrs, colIdxs, initValue) {}
+
+CMatrixSparse::CMatrixSparse(const CMatrixSparse& rhs)
+    : CMatrixCompressedRow(rhs) {}
+
+CMatrixSparse::~CMatrixSparse() {}
+
+CMatrixSparseSymmetric CMatrixSparse::toSymmetricStorage() const {
+    std::vector<unsigned> lowRowPtr(nRows + 1, 0);
+    std::vector<unsigned> lowColIdx;
+    std::vector<unsigned> lowPos;
+
+    /*--- Keep the pattern of the lower triangle, including the diagonal. ---*/
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1] && colIdx[k] <= i; k++) {
+            lowColIdx.push_back(colIdx[k]);
+            lowPos.push_back(k);
+        }
+        lowRowPtr[i + 1] = lowColIdx.size();
+    }
+
+    /*--- Copy the entries of the lower triangle. ---*/
+    CMatrixSparseSymmetric res(nRows, nCols, lowRowPtr.data(),
+                               lowColIdx.data(), 0.0);
+    double* resPtr = res.getMtxAddress();
+    for (unsigned k = 0; k < lowPos.size(); k++) {
+        resPtr[k] = mtx[lowPos[k]];
+    }
+
+    return res;
+}
+
+CMatrixSparse CMatrixSparse::transpose() const {
+    std::vector<unsigned> trRowPtr(nCols + 1, 0);
+    std::vector<unsigned> fill(nCols, 0);
+
+    /*--- Count the entries of every column. ---*/
+    for (unsigned k = 0; k < nNonZero; k++) {
+        trRowPtr[colIdx[k] + 1]++;
+    }
+    for (unsigned j = 0; j < nCols; j++) {
+        trRowPtr[j + 1] += trRowPtr[j];
+    }
+
+    /*--- Rows are visited in increasing order, so the columns of the
+          transpose are sorted. ---*/
+    std::vector<unsigned> trColIdx(nNonZero);
+    std::vector<unsigned> trPos(nNonZero);
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned pos = trRowPtr[colIdx[k]] + fill[colIdx[k]]++;
+            trColIdx[pos] = i;
+            trPos[pos] = k;
+        }
+    }
+
+    CMatrixSparse res(nCols, nRows, trRowPtr.data(), trColIdx.data(), 0.0);
+    for (unsigned k = 0; k < nNonZero; k++) {
+        res.mtx[k] = mtx[trPos[k]];
+    }
+
+    return res;
+}
+
+CMatrixSparse& CMatrixSparse::operator=(const CMatrixSparse& rhs) {
+    copy(rhs);
+
+    return *this;
+}
+
+CMatrixSparse& CMatrixSparse::operator+=(const CMatrixSparse& rhs) {
+    if (nNonZero != rhs.getNNonZero())
+        throw std::runtime_error("Sparse matrices with different pattern");
+
+    /*--- Both patterns are the same, so the entries are summed one by one. ---*/
+    for (unsigned k = 0; k < nNonZero; k++) {
+        mtx[k] += rhs.mtx[k];
+    }
+
+    return *this;
+}
+
+CMatrix CMatrixSparse::operator*(const CMatrix& rhs) const {
+    unsigned rhsCols = rhs.getCols();
+    CMatrix res(nRows, rhsCols, 0.0);
+
+    /*--- Compute the product row by row visiting only the stored entries. ---*/
+    for (unsigned j = 0; j < rhsCols; j++) {
+        for (unsigned i = 0; i < nRows; i++) {
+            double sum = 0.0;
+            for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                sum += mtx[k] * rhs(colIdx[k], j);
+            }
+            res(i, j) = sum;
+        }
+    }
+
+    return res;
+}
+
+CMatrixSparse CMatrixSparse::operator*(const CMatrixSparse& rhs) const {
+    if (nCols != rhs.nRows)
+        throw std::runtime_error("Matrices with incompatible dimensions");
+
+    /*--- Initialize variables to be used in the subroutine. The entries of a
+          row of the product are accumulated in a dense vector. ---*/
+    unsigned rhsCols = rhs.nCols;
+    std::vector<double> acc(rhsCols, 0.0);
+    std::vector<bool> used(rhsCols, false);
+    std::vector<unsigned> resRowPtr(nRows + 1, 0);
+    std::vector<unsigned> resColIdx;
+    std::vector<double> resVal;
+
+    /*--- Row i of the product combines the rows of rhs selected by the
+          entries of row i. ---*/
+    for (unsigned i = 0; i < nRows; i++) {
+        unsigned first = resColIdx.size();
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            for (unsigned m = rhs.rowPtr[j]; m < rhs.rowPtr[j + 1]; m++) {
+                unsigned c = rhs.colIdx[m];
+                if (!used[c]) {
+                    used[c] = true;
+                    resColIdx.push_back(c);
+                }
+                acc[c] += mtx[k] * rhs.mtx[m];
+            }
+        }
+        std::sort(resColIdx.begin() + first, resColIdx.end());
+        for (unsigned k = first; k < resColIdx.size(); k++) {
+            unsigned c = resColIdx[k];
+            resVal.push_back(acc[c]);
+            acc[c] = 0.0;
+            used[c] = false;
+        }
+        resRowPtr[i + 1] = resColIdx.size();
+    }
+
+    CMatrixSparse res(nRows, rhsCols, resRowPtr.data(), resColIdx.data(), 0.0);
+    for (unsigned k = 0; k < resVal.size(); k++) {
+        res.mtx[k] = resVal[k];
+    }
+
+    return res;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*!
+ * @file CMatrixSparseSymmetric.cpp
+ * @brief The main subroutines for defining symmetric sparse matrices in
+ *        compressed sparse row (CSR) format and their operations.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CMATRIXSPARSESYMMETRIC_CPP
+#define __CMATRIXSPARSESYMMETRIC_CPP
+
+#include <vector>
+
+#include "../include/CMatrixCompressedRow.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+
+CMatrixSparseSymmetric::CMatrixSparseSymmetric() : CMatrixCompressedRow() {}
+
+CMatrixSparseSymmetric::CMatrixSparseSymmetric(unsigned rows, unsigned cols,
+                             const unsigned* rowPtrs, const unsigned* colIdxs,
+                             const double initValue)
+    : CMatrixCompressedRow(rows, cols, rowPtrs, colIdxs, initValue) {}
+
+CMatrixSparseSymmetric::CMatrixSparseSymmetric(const CMatrixSparseSymmetric& rhs)
+    : CMatrixCompressedRow(rhs) {}
+
+CMatrixSparseSymmetric::~CMatrixSparseSymmetric() {}
+
+CMatrixSparse CMatrixSparseSymmetric::toGeneralStorage() const {
+    std::vector<unsigned> genRowPtr(nRows + 1, 0);
+    std::vector<unsigned> fill(nRows, 0);
+
+    /*--- Every row keeps its stored entries and receives the entries of the
+          strictly lower part of its column. ---*/
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            genRowPtr[i + 1]++;
+            if (colIdx[k] != i) genRowPtr[colIdx[k] + 1]++;
+        }
+    }
+    for (unsigned i = 0; i < nRows; i++) {
+        genRowPtr[i + 1] += genRowPtr[i];
+    }
+
+    /*--- The lower part of every row goes first. The upper part is appended
+          visiting the rows in increasing order, so columns stay sorted. ---*/
+    std::vector<unsigned> genColIdx(genRowPtr[nRows]);
+    std::vector<double> genVal(genRowPtr[nRows]);
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned pos = genRowPtr[i] + fill[i]++;
+            genColIdx[pos] = colIdx[k];
+            genVal[pos] = mtx[k];
+        }
+    }
+    for (unsigned i = 0; i < nRows; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            if (j == i) continue;
+            unsigned pos = genRowPtr[j] + fill[j]++;
+            genColIdx[pos] = i;
+            genVal[pos] = mtx[k];
+        }
+    }
+
+    CMatrixSparse res(nRows, nCols, genRowPtr.data(), genColIdx.data(), 0.0);
+    double* resPtr = res.getMtxAddress();
+    for (unsigned k = 0; k < genVal.size(); k++) {
+        resPtr[k] = genVal[k];
+    }
+
+    return res;
+}
+
+int CMatrixSparseSymmetric::findEntry(const unsigned i, const unsigned j) const {
+    /*--- Entries of the upper triangle are stored in the lower one. ---*/
+    return i < j ? findInRow(j, i) : findInRow(i, j);
+}
+
+CMatrixSparseSymmetric& CMatrixSparseSymmetric::operator=(const CMatrixSparseSymmetric& rhs) {
+    copy(rhs);
+
+    return *this;
+}
+
+#endif
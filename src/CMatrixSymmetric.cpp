@@ -30,6 +30,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include "../include/CMatrixSymmetric.hpp"
 
@@ -47,15 +48,11 @@ CMatrixSymmetric::CMatrixSymmetric(unsigned rows, unsigned cols, const double in
     nRows = rows;
     nCols = cols;
 
-    /*--- Allocate memory for the entries. ---*/
-    mtx = new double[cols*rows];
+    /*--- Allocate memory for the entries of the lower triangle. ---*/
+    mtx = new double[getNEntries()];
 
     /*--- Initialize entries with initValue. ---*/
-    for (unsigned j = 0; j < nCols; j++) {
-        for (unsigned i = j; i < nRows; i++) {
-            mtx[j*nRows-(j-1)*j/2+i-j] = initValue;
-        }
-    }
+    std::fill(mtx, mtx + getNEntries(), initValue);
 }
 
 CMatrixSymmetric::CMatrixSymmetric(const CMatrixSymmetric& rhs) {
@@ -63,15 +60,21 @@ CMatrixSymmetric::CMatrixSymmetric(const CMatrixSymmetric& rhs) {
     nRows = rhs.nRows;
     nCols = rhs.nCols;
 
-    /*--- Allocate memory for the entries. ---*/
-    mtx = new double[nCols*nRows];
+    /*--- Allocate memory for the entries of the lower triangle. ---*/
+    mtx = new double[getNEntries()];
 
     /*--- Initialize entries with the same entries in rhs. ---*/
-    for (unsigned j = 0; j < nCols; j++) {
-        for (unsigned i = j; i < nRows; i++) {
-            mtx[j*nRows-(j-1)*j/2+i-j] = rhs.mtx[j*nRows-(j-1)*j/2+i-j];
-        }
-    }
+    std::copy(rhs.mtx, rhs.mtx + getNEntries(), mtx);
+}
+
+CMatrixSymmetric::CMatrixSymmetric(CMatrixSymmetric&& rhs) {
+    /*--- Take the entries of rhs and leave it empty. ---*/
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    mtx = rhs.mtx;
+    rhs.nRows = 0;
+    rhs.nCols = 0;
+    rhs.mtx = nullptr;
 }
 
 CMatrixSymmetric::~CMatrixSymmetric() {
@@ -87,6 +90,12 @@ unsigned CMatrixSymmetric::getCols() const {
     return nCols;
 }
 
+unsigned CMatrixSymmetric::getNEntries() const {
+    /*--- Column j keeps the entries from the diagonal to the last row. ---*/
+    if (nCols > nRows) return nRows*(nRows+1)/2;
+    return nCols*nRows-(nCols-1)*nCols/2;
+}
+
 double* CMatrixSymmetric::getMtxAddress() const {
     return &mtx[0];
 }
@@ -120,25 +129,38 @@ CMatrixSymmetric& CMatrixSymmetric::operator=(const CMatrixSymmetric& rhs) {
     if (&rhs == this) return *this;
 
     /*--- Release allocated memory for entries in order to allocate new space for
-          different nRows and nCols. ---*/
-    delete mtx;
+          different nRows and nCols. The memory is reused if the number of
+          entries is the same. ---*/
+    if (getNEntries() != rhs.getNEntries()) {
+        delete[] mtx;
+        mtx = new double[rhs.getNEntries()];
+    }
     nRows = rhs.getRows();
     nCols = rhs.getCols();
 
-    /*--- Allocated memory for the new entries. ---*/
-    mtx = new double[nCols*nRows];
-
     /*--- Copy entries from the rhs to the current matrix. ---*/
-    for (unsigned j = 0; j < nCols; j++) {
-        for (unsigned i = j; i < nRows; i++) {
-            mtx[j*nRows-(j-1)*j/2+i-j] = rhs.mtx[j*nRows-(j-1)*j/2+i-j];
-        }
-    }
+    std::copy(rhs.mtx, rhs.mtx + getNEntries(), mtx);
 
     return *this;
 }
 
-CMatrixSymmetric CMatrixSymmetric::operator+(const CMatrixSymmetric& rhs) {
+CMatrixSymmetric& CMatrixSymmetric::operator=(CMatrixSymmetric&& rhs) {
+    /*--- If the matrix is the same, simply return the same matrix. ---*/
+    if (&rhs == this) return *this;
+
+    /*--- Release the current entries and take the ones of rhs. ---*/
+    delete[] mtx;
+    nRows = rhs.nRows;
+    nCols = rhs.nCols;
+    mtx = rhs.mtx;
+    rhs.nRows = 0;
+    rhs.nCols = 0;
+    rhs.mtx = nullptr;
+
+    return *this;
+}
+
+CMatrixSymmetric CMatrixSymmetric::operator+(const CMatrixSymmetric& rhs) const {
     CMatrixSymmetric res(nRows, nCols, 0.0);
 
     /*--- Sum every entry. ---*/
@@ -152,9 +174,11 @@ CMatrixSymmetric CMatrixSymmetric::operator+(const CMatrixSymmetric& rhs) {
 }
 
 CMatrixSymmetric& CMatrixSymmetric::operator+=(const CMatrixSymmetric& rhs) {
-    /*--- Use the + overloaded sign to compute +=. ---*/
-    CMatrixSymmetric res = (*this) + rhs;
-    (*this) = res;
+    /*--- Sum every stored entry in place. ---*/
+    for (unsigned k = 0; k < getNEntries(); k++) {
+        mtx[k] += rhs.mtx[k];
+    }
+
     return *this;
 }
 
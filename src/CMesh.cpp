@@ -28,10 +28,16 @@
 #ifndef __CMESH_CPP
 #define __CMESH_CPP
 
+#include <vector>
+#include <stdexcept>
+
 #include "../include/CMatrix.hpp"
+#include "../include/CMatrixIndex.hpp"
 #include "../include/CGeometry.hpp"
 #include "../include/CMesh.hpp"
 
+const unsigned CMesh::noNode;
+
 CMesh::CMesh() {
     /*--- Initialize properties. ---*/
     nXDirElem = 0;
@@ -39,23 +45,32 @@ CMesh::CMesh() {
     nElem = 0;
     nNode = 0;
     nNodePerElem = 4;
+    elemOrder = 1;
     dofPerNode = 1;
     totalDofInElem = nNodePerElem * dofPerNode;
 }
 
-CMesh::CMesh(const unsigned NElx, const unsigned NEly, const CGeometry geo) {
-    /*--- Initialize properties. ---*/
+CMesh::CMesh(const unsigned NElx, const unsigned NEly, const CGeometry geo,
+             const unsigned nodPerEl) {
+    if (nodPerEl != 4 && nodPerEl != 8 && nodPerEl != 9)
+        throw std::runtime_error("Unsupported number of nodes per element");
+
+    /*--- Initialize properties. The quadratic elements have a node grid twice
+          as fine, without the centre of the elements for the serendipity
+          element. ---*/
     nXDirElem = NElx;
     nYDirElem = NEly;
     nElem = nXDirElem * nYDirElem;
-    nNode = (nXDirElem + 1) * (nYDirElem + 1);
-    nNodePerElem = 4;
+    nNodePerElem = nodPerEl;
+    elemOrder = (nNodePerElem == 4) ? 1 : 2;
+    nNode = (elemOrder * nXDirElem + 1) * (elemOrder * nYDirElem + 1);
+    if (nNodePerElem == 8) nNode -= nElem;
     dofPerNode = 1;
     totalDofInElem = nNodePerElem * dofPerNode;
 
     /*--- Compute main matrices of the mesh. ---*/
-    coorMtx = coordinateMtx(geo);
     topolMtx = topologyMtx();
+    coorMtx = coordinateMtx(geo);
     connMtx = connectivityMtx(topolMtx);
     glDofMtx = globalDofMtx(connMtx);
 }
@@ -82,6 +97,10 @@ unsigned CMesh::getNNodePerElem() const {
     return nNodePerElem;
 }
 
+unsigned CMesh::getElemOrder() const {
+    return elemOrder;
+}
+
 unsigned CMesh::getDofPerNode() const {
     return dofPerNode;
 }
@@ -94,41 +113,114 @@ unsigned CMesh::getNDofTotal() const {
     return nDofTotal;
 }
 
-CMatrix CMesh::getCoorMtx() const {
+const CMatrix& CMesh::getCoorMtx() const {
     return coorMtx;
 }
 
-CMatrix CMesh::getTopolMtx() const {
+const double* CMesh::getCoorX() const {
+    return coorMtx.getMtxAddress();
+}
+
+const double* CMesh::getCoorY() const {
+    return coorMtx.getMtxAddress() + nNode;
+}
+
+const CMatrixIndex& CMesh::getTopolMtx() const {
     return topolMtx;
 }
 
-CMatrix CMesh::getConnMtx() const {
+const CMatrixIndex& CMesh::getConnMtx() const {
     return connMtx;
 }
 
-CMatrix CMesh::getGlDofMtx() const {
+const CMatrixIndex& CMesh::getGlDofMtx() const {
     return glDofMtx;
 }
 
+std::vector<unsigned> CMesh::nestedDissection() const {
+    std::vector<unsigned> order;
+    order.reserve(nNode);
+    if (nNode > 0) {
+        dissect(0, topolMtx.getRows() - 1, 0, topolMtx.getCols() - 1, order);
+    }
+
+    return order;
+}
+
+std::vector< std::vector<unsigned> > CMesh::elementColors() const {
+    std::vector< std::vector<unsigned> > colors(4);
+
+    /*--- Elements are numbered column by column, like in the connectivity. ---*/
+    unsigned elem = 0;
+    for (unsigned j = 0; j < nXDirElem; j++) {
+        for (unsigned i = 0; i < nYDirElem; i++) {
+            colors[(i % 2) + 2 * (j % 2)].push_back(elem);
+            elem++;
+        }
+    }
+
+    return colors;
+}
+
+void CMesh::dissect(const unsigned i0, const unsigned i1,
+                    const unsigned j0, const unsigned j1,
+                    std::vector<unsigned>& order) const {
+    /*--- Small blocks are ordered column by column, skipping the grid points
+          without node. ---*/
+    unsigned nRows = i1 - i0 + 1;
+    unsigned nCols = j1 - j0 + 1;
+    if (nRows * nCols <= 16) {
+        for (unsigned j = j0; j <= j1; j++) {
+            for (unsigned i = i0; i <= i1; i++) {
+                if (topolMtx(i, j) != noNode) order.push_back(topolMtx(i, j));
+            }
+        }
+        return;
+    }
+
+    /*--- Nodes only couple with the nodes of the neighbour elements, so a line
+          of nodes across the longer side splits the block in two. The line
+          has to follow the edges of the elements. ---*/
+    if (nCols >= nRows) {
+        unsigned jm = (j0 + j1) / 2;
+        jm += jm % elemOrder;
+        if (jm > j0) dissect(i0, i1, j0, jm - 1, order);
+        if (jm < j1) dissect(i0, i1, jm + 1, j1, order);
+        for (unsigned i = i0; i <= i1; i++) {
+            order.push_back(topolMtx(i, jm));
+        }
+    } else {
+        unsigned im = (i0 + i1) / 2;
+        im += im % elemOrder;
+        if (im > i0) dissect(i0, im - 1, j0, j1, order);
+        if (im < i1) dissect(im + 1, i1, j0, j1, order);
+        for (unsigned j = j0; j <= j1; j++) {
+            order.push_back(topolMtx(im, j));
+        }
+    }
+}
+
 CMatrix CMesh::coordinateMtx(CGeometry geo) {
     /*--- Initialize variables to be used in the subroutine. ---*/
     CMatrix xVec, hVec, yMat, yLocVec, coorMat;
     double a = geo.getAConst();
     double b = geo.getBConst();
     double hLeft = geo.getHeightLeft();
+    unsigned nGridX = elemOrder * nXDirElem;
+    unsigned nGridY = elemOrder * nYDirElem;
     unsigned nod;
 
     /*--- Build x coordinates and height distribution. ---*/
-    xVec = CMatrix::linspace(0.0, geo.getLength(), nXDirElem + 1);
+    xVec = CMatrix::linspace(0.0, geo.getLength(), nGridX + 1);
     hVec = (xVec^2)*a + xVec*b + hLeft;
 
     /*--- Build y coordinates. ---*/
-    yMat = CMatrix(nYDirElem + 1, nXDirElem + 1, 0.0);
-    for (unsigned j = 0; j < nXDirElem + 1; j++) {
+    yMat = CMatrix(nGridY + 1, nGridX + 1, 0.0);
+    for (unsigned j = 0; j < nGridX + 1; j++) {
         yLocVec = CMatrix::linspace(-hVec(j, 0) / 2.0,
                                  hVec(j, 0) / 2.0,
-                                 nYDirElem + 1);
-        for (unsigned i = 0; i < nYDirElem + 1; i++) {
+                                 nGridY + 1);
+        for (unsigned i = 0; i < nGridY + 1; i++) {
             yMat(i, j) = yLocVec(i, 0);
         }
     }
@@ -136,8 +228,9 @@ CMatrix CMesh::coordinateMtx(CGeometry geo) {
     /*--- Build coordinate matrix from xVec and yMat. ---*/
     coorMat = CMatrix(nNode, 2, 0.0);
     nod = 0;
-    for (unsigned j = 0; j < nXDirElem + 1; j++) {
-        for (unsigned i = 0; i < nYDirElem + 1; i++) {
+    for (unsigned j = 0; j < nGridX + 1; j++) {
+        for (unsigned i = 0; i < nGridY + 1; i++) {
+            if (topolMtx(i, j) == noNode) continue;
             coorMat(nod, 0) = xVec(j, 0);
             coorMat(nod, 1) = yMat(i, j);
             nod++;
@@ -147,13 +240,20 @@ CMatrix CMesh::coordinateMtx(CGeometry geo) {
     return coorMat;
 }
 
-CMatrix CMesh::topologyMtx() {
-    CMatrix topol = CMatrix(nYDirElem + 1, nXDirElem + 1, 0.0);
+CMatrixIndex CMesh::topologyMtx() {
+    unsigned nGridX = elemOrder * nXDirElem;
+    unsigned nGridY = elemOrder * nYDirElem;
+    CMatrixIndex topol = CMatrixIndex(nGridY + 1, nGridX + 1, 0);
 
-    /*--- Node numbers increase from bottom to top and left to right. ---*/
+    /*--- Node numbers increase from bottom to top and left to right. The
+          centres of the serendipity elements have no node. ---*/
     unsigned nod = 0;
-    for (unsigned j = 0; j < nXDirElem + 1; j++) {
-        for (unsigned i = 0; i < nYDirElem + 1; i++) {
+    for (unsigned j = 0; j < nGridX + 1; j++) {
+        for (unsigned i = 0; i < nGridY + 1; i++) {
+            if (nNodePerElem == 8 && i % 2 == 1 && j % 2 == 1) {
+                topol(i, j) = noNode;
+                continue;
+            }
             topol(i, j) = nod;
             nod++;
         }
@@ -162,19 +262,29 @@ CMatrix CMesh::topologyMtx() {
     return topol;
 }
 
-CMatrix CMesh::connectivityMtx(CMatrix topol) {
-    CMatrix conn = CMatrix(nElem, nNodePerElem + 1, 0.0);
+CMatrixIndex CMesh::connectivityMtx(const CMatrixIndex& topol) {
+    CMatrixIndex conn = CMatrixIndex(nElem, nNodePerElem + 1, 0);
 
     /*--- First column is element number. The other columns are the nodes in the
-          element. ---*/
+          element, the corners counterclockwise from the bottom left one,
+          then the midsides of the bottom, right, top and left edges and the
+          centre. ---*/
+    unsigned p = elemOrder;
     unsigned elem = 0;
     for (unsigned j = 0; j < nXDirElem; j++) {
         for (unsigned i = 0; i < nYDirElem; i++) {
             conn(elem, 0) = elem;
-            conn(elem, 1) = topol(i, j);
-            conn(elem, 2) = topol(i, j + 1);
-            conn(elem, 3) = topol(i + 1, j + 1);
-            conn(elem, 4) = topol(i + 1, j);
+            conn(elem, 1) = topol(p*i, p*j);
+            conn(elem, 2) = topol(p*i, p*(j + 1));
+            conn(elem, 3) = topol(p*(i + 1), p*(j + 1));
+            conn(elem, 4) = topol(p*(i + 1), p*j);
+            if (nNodePerElem > 4) {
+                conn(elem, 5) = topol(2*i, 2*j + 1);
+                conn(elem, 6) = topol(2*i + 1, 2*j + 2);
+                conn(elem, 7) = topol(2*i + 2, 2*j + 1);
+                conn(elem, 8) = topol(2*i + 1, 2*j);
+            }
+            if (nNodePerElem == 9) conn(elem, 9) = topol(2*i + 1, 2*j + 1);
             elem++;
         }
     }
@@ -182,8 +292,8 @@ CMatrix CMesh::connectivityMtx(CMatrix topol) {
     return conn;
 }
 
-CMatrix CMesh::globalDofMtx(CMatrix conn) {
-    CMatrix glDof = CMatrix(nNode, 2, 0.0);
+CMatrixIndex CMesh::globalDofMtx(const CMatrixIndex& conn) {
+    CMatrixIndex glDof = CMatrixIndex(nNode, 2, 0);
     unsigned nod, elemNDof;
 
     /*--- Populate first column of glDof with the number of DOF per node. ---*/
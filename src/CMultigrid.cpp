@@ -0,0 +1,493 @@
+/*!
+ * @file CMultigrid.cpp
+ * @brief The main subroutines for the geometric multigrid method.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CMULTIGRID_CPP
+#define __CMULTIGRID_CPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <stdexcept>
+
+#include "../include/CMultigrid.hpp"
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparse.hpp"
+#include "../include/CMesh.hpp"
+#include "../include/CGeometry.hpp"
+#include "../include/CMaterial.hpp"
+#include "../include/CConductance.hpp"
+#include "../include/CBoundaryConditions.hpp"
+#include "../include/CLinearSystem.hpp"
+
+CMultigrid::CMultigrid() {
+    /*--- Initialize properties. ---*/
+    nLevels = 0;
+    nSmooth = 2;
+    nCoarseVisits = 1;
+    nIterations = 0;
+    maxDenseSize = 2000;
+}
+
+CMultigrid::CMultigrid(const CConductance& cnd, const CMesh& msh,
+                       const CBoundaryConditions& bnd,
+                       const std::string cycleType) {
+    /*--- The coarse levels are bilinear meshes, so the prolongation between
+          the grids needs bilinear elements at the finest level too. ---*/
+    if (msh.getNNodePerElem() != 4)
+        throw std::runtime_error("Geometric multigrid needs bilinear elements");
+
+    /*--- Initialize properties. ---*/
+    setCycleType(cycleType);
+    nSmooth = 2;
+    nIterations = 0;
+    maxDenseSize = 2000;
+
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    CGeometry geo = cnd.getGeometry();
+    CMaterial mat = cnd.getMaterial();
+    std::string flLoc = bnd.getFluxBCLoc();
+    std::string tpLoc = bnd.getTempBCLoc();
+    double flVal = bnd.getFluxValue();
+    double tpVal = bnd.getTempValue();
+    CMesh fine = msh;
+    std::vector<int> finePos = freePositions(bnd, msh.getNDofTotal());
+    unsigned nFine = bnd.getNReducedDof();
+
+    /*--- Finest level from the assembled conductance matrix, or directly from
+          the submatrix at known fluxes when only the reduced system is
+          assembled. ---*/
+    if (cnd.isReduced()) {
+        lhs.push_back(cnd.getConducFF().toGeneralStorage());
+    } else {
+        lhs.push_back(freeMatrix(cnd.getConducMtx(), finePos, nFine));
+    }
+
+    /*--- Coarse levels halve the number of elements of the directions with
+          the strongest coupling, which is the conductivity over the squared
+          element size, until the grid has at most two elements per
+          direction. The Gauss-Seidel sweeps do not smooth the error along a
+          weak direction, so the coarsening stops when only the weak
+          direction has more than two elements. ---*/
+    unsigned nX = msh.getNXDirElem();
+    unsigned nY = msh.getNYDirElem();
+    double length = geo.getLength();
+    double height = geo.getHeight(0.5 * length);
+    while (nX > 2 || nY > 2) {
+        double hX = length / nX;
+        double hY = height / nY;
+        double sX = mat.getKXX() / (hX * hX);
+        double sY = mat.getKYY() / (hY * hY);
+        bool coarsenX = nX > 2 && 2.0 * sX >= sY;
+        bool coarsenY = nY > 2 && 2.0 * sY >= sX;
+        if (!coarsenX && !coarsenY) break;
+        if (coarsenX) nX = (nX + 1) / 2;
+        if (coarsenY) nY = (nY + 1) / 2;
+        CMesh coarse = CMesh(nX, nY, geo);
+        CBoundaryConditions cBnd = CBoundaryConditions(flLoc, flVal,
+                                                       tpLoc, tpVal,
+                                                       coarse, geo);
+        std::vector<int> coarsePos = freePositions(cBnd,
+                                                   coarse.getNDofTotal());
+        unsigned nCoarse = cBnd.getNReducedDof();
+
+        /*--- Galerkin coarse operator, P'*A*P, which keeps the coarse
+              correction consistent with the fine level on distorted and
+              anisotropic grids. ---*/
+        CMatrixSparse P = prolongationMtx(fine, coarse, finePos, coarsePos,
+                                          nFine, nCoarse);
+        CMatrixSparse Ac = P.transpose() * (lhs.back() * P);
+        prolong.push_back(P);
+        lhs.push_back(Ac);
+
+        fine = coarse;
+        finePos = coarsePos;
+        nFine = nCoarse;
+    }
+    nLevels = lhs.size();
+    factorizeCoarsest();
+}
+
+CMultigrid::~CMultigrid() {}
+
+unsigned CMultigrid::getNLevels() const {
+    return nLevels;
+}
+
+unsigned CMultigrid::getNIterations() const {
+    return nIterations;
+}
+
+void CMultigrid::setCycleType(const std::string cycleType) {
+    if (cycleType == "V") {
+        nCoarseVisits = 1;
+    } else if (cycleType == "W") {
+        nCoarseVisits = 2;
+    } else {
+        throw std::runtime_error("Unknown multigrid cycle");
+    }
+}
+
+void CMultigrid::factorizeCoarsest() {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const CMatrixSparse& Ac = lhs[nLevels - 1];
+    unsigned nc = Ac.getRows();
+    unsigned* rowPtr = Ac.getRowPtrAddress();
+    unsigned* colIdx = Ac.getColIdxAddress();
+    double* APtr = Ac.getMtxAddress();
+    int info = 0;
+
+    /*--- The dense factor takes nc*nc entries, so a large coarsest level is
+          smoothed by the cycle instead. ---*/
+    if (nc > maxDenseSize) {
+        coarseFactor = CMatrix();
+        return;
+    }
+
+    /*--- Cholesky factorization of the coarsest level with LAPACK. ---*/
+    coarseFactor = CMatrix(nc, nc, 0.0);
+    for (unsigned i = 0; i < nc; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            coarseFactor(i, colIdx[k]) = APtr[k];
+        }
+    }
+    if (nc > 0) {
+        F77NAME(dpotrf)('L', nc, coarseFactor.getMtxAddress(), nc, info);
+        if (info != 0)
+            throw std::runtime_error("Coarsest multigrid level not positive definite");
+    }
+}
+
+std::vector<int> CMultigrid::freePositions(const CBoundaryConditions& bnd,
+                                           const unsigned nDof) {
+    unsigned rDof = bnd.getNReducedDof();
+    const CMatrixIndex& rDofVec = bnd.getReducedDofVector();
+    std::vector<int> pos(nDof, -1);
+    for (unsigned i = 0; i < rDof; i++) {
+        pos[rDofVec(0, i)] = i;
+    }
+
+    return pos;
+}
+
+CMatrixSparse CMultigrid::freeMatrix(const CMatrixSparse& K,
+                                     const std::vector<int>& pos,
+                                     const unsigned nFree) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nDof = K.getRows();
+    unsigned* rowPtr = K.getRowPtrAddress();
+    unsigned* colIdx = K.getColIdxAddress();
+    double* KPtr = K.getMtxAddress();
+    std::vector<unsigned> ffRowPtr(nFree + 1, 0);
+    std::vector<unsigned> ffColIdx;
+    std::vector<unsigned> ffPos;
+
+    /*--- Keep the rows and columns of the DOF with known flux, which are in
+          the same order as the global DOF. ---*/
+    for (unsigned i = 0; i < nDof; i++) {
+        if (pos[i] < 0) continue;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (pos[colIdx[k]] >= 0) {
+                ffColIdx.push_back(pos[colIdx[k]]);
+                ffPos.push_back(k);
+            }
+        }
+        ffRowPtr[pos[i] + 1] = ffColIdx.size();
+    }
+
+    CMatrixSparse Kff(nFree, nFree, ffRowPtr.data(), ffColIdx.data(), 0.0);
+    double* KffPtr = Kff.getMtxAddress();
+    for (unsigned k = 0; k < ffPos.size(); k++) {
+        KffPtr[k] = KPtr[ffPos[k]];
+    }
+
+    return Kff;
+}
+
+CMatrixSparse CMultigrid::prolongationMtx(const CMesh& fine,
+                                          const CMesh& coarse,
+                                          const std::vector<int>& finePos,
+                                          const std::vector<int>& coarsePos,
+                                          const unsigned nFine,
+                                          const unsigned nCoarse) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned nXf = fine.getNXDirElem();
+    unsigned nYf = fine.getNYDirElem();
+    unsigned nXc = coarse.getNXDirElem();
+    unsigned nYc = coarse.getNYDirElem();
+    unsigned dfPerNod = fine.getDofPerNode();
+    const CMatrixIndex& fTopol = fine.getTopolMtx();
+    const CMatrixIndex& cTopol = coarse.getTopolMtx();
+    const CMatrixIndex& fGlDof = fine.getGlDofMtx();
+    const CMatrixIndex& cGlDof = coarse.getGlDofMtx();
+    std::vector<unsigned> rowPtr(nFine + 1, 0);
+    std::vector<unsigned> colIdx;
+    std::vector<double> vals;
+    unsigned xIdx[2], yIdx[2];
+    double xW[2], yW[2];
+    unsigned nXW, nYW;
+
+    /*--- Every fine node is interpolated from the coarse nodes of the coarse
+          element that contains it. With the parametric coordinate s = j/nXf,
+          the coarse column is floor(s*nXc) and the weight the remainder. ---*/
+    for (unsigned j = 0; j < nXf + 1; j++) {
+        unsigned num = j * nXc;
+        xIdx[0] = num / nXf;
+        xW[0] = 1.0;
+        nXW = 1;
+        if (num % nXf != 0) {
+            xW[1] = double(num % nXf) / nXf;
+            xW[0] = 1.0 - xW[1];
+            xIdx[1] = xIdx[0] + 1;
+            nXW = 2;
+        }
+        for (unsigned i = 0; i < nYf + 1; i++) {
+            int row = finePos[fGlDof(fTopol(i, j), dfPerNod)];
+            if (row < 0) continue;
+            num = i * nYc;
+            yIdx[0] = num / nYf;
+            yW[0] = 1.0;
+            nYW = 1;
+            if (num % nYf != 0) {
+                yW[1] = double(num % nYf) / nYf;
+                yW[0] = 1.0 - yW[1];
+                yIdx[1] = yIdx[0] + 1;
+                nYW = 2;
+            }
+
+            /*--- Coarse nodes are numbered by columns, so the columns of the
+                  row are already sorted. Coarse nodes with known temperature
+                  receive no correction. ---*/
+            for (unsigned b = 0; b < nXW; b++) {
+                for (unsigned a = 0; a < nYW; a++) {
+                    int col = coarsePos[cGlDof(cTopol(yIdx[a], xIdx[b]),
+                                               dfPerNod)];
+                    if (col < 0) continue;
+                    colIdx.push_back(col);
+                    vals.push_back(xW[b] * yW[a]);
+                }
+            }
+            rowPtr[row + 1] = colIdx.size();
+        }
+    }
+
+    /*--- Rows are visited in the order of the fine DOF, which increases from
+          bottom to top and left to right. ---*/
+    CMatrixSparse P(nFine, nCoarse, rowPtr.data(), colIdx.data(), 0.0);
+    double* PPtr = P.getMtxAddress();
+    for (unsigned k = 0; k < vals.size(); k++) {
+        PPtr[k] = vals[k];
+    }
+
+    return P;
+}
+
+void CMultigrid::smooth(const unsigned l, const double* b, double* x,
+                        const bool forward) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const CMatrixSparse& A = lhs[l];
+    unsigned n = A.getRows();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+
+    /*--- A forward sweep before and a backward sweep after the coarse
+          correction keep the cycle symmetric, as required by the CG method. ---*/
+    for (unsigned m = 0; m < n; m++) {
+        unsigned i = forward ? m : n - 1 - m;
+        double sum = b[i];
+        double diag = 0.0;
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (colIdx[k] == i) {
+                diag = APtr[k];
+            } else {
+                sum -= APtr[k] * x[colIdx[k]];
+            }
+        }
+        x[i] = sum / diag;
+    }
+}
+
+void CMultigrid::cycle(const unsigned l, const double* b, double* x) const {
+    unsigned n = lhs[l].getRows();
+
+    /*--- Exact solve on the coarsest level, or symmetric Gauss-Seidel sweeps
+          from zero if it was too large to factorize. ---*/
+    if (l == nLevels - 1 && n > maxDenseSize) {
+        std::fill(x, x + n, 0.0);
+        for (unsigned s = 0; s < 10; s++) {
+            smooth(l, b, x, true);
+            smooth(l, b, x, false);
+        }
+        return;
+    }
+    if (l == nLevels - 1) {
+        int info = 0;
+        F77NAME(dcopy)(n, b, 1, x, 1);
+        if (n > 0) {
+            F77NAME(dpotrs)('L', n, 1, coarseFactor.getMtxAddress(), n, x, n,
+                            info);
+        }
+        return;
+    }
+
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const CMatrixSparse& A = lhs[l];
+    const CMatrixSparse& P = prolong[l];
+    unsigned nc = P.getCols();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+    unsigned* pRowPtr = P.getRowPtrAddress();
+    unsigned* pColIdx = P.getColIdxAddress();
+    double* PPtr = P.getMtxAddress();
+    double* r = new double[n];
+    double* rc = new double[nc];
+    double* xc = new double[nc];
+
+    /*--- Pre-smoothing. ---*/
+    for (unsigned s = 0; s < nSmooth; s++) {
+        smooth(l, b, x, true);
+    }
+
+    /*--- Restriction of the residual, rc = P'*(b - A*x). ---*/
+    for (unsigned i = 0; i < n; i++) {
+        double sum = b[i];
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            sum -= APtr[k] * x[colIdx[k]];
+        }
+        r[i] = sum;
+    }
+    for (unsigned i = 0; i < nc; i++) {
+        rc[i] = 0.0;
+        xc[i] = 0.0;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = pRowPtr[i]; k < pRowPtr[i + 1]; k++) {
+            rc[pColIdx[k]] += PPtr[k] * r[i];
+        }
+    }
+
+    /*--- Coarse correction, once for a V-cycle and twice for a W-cycle. ---*/
+    for (unsigned v = 0; v < nCoarseVisits; v++) {
+        cycle(l + 1, rc, xc);
+    }
+
+    /*--- Prolongation of the correction, x = x + P*xc. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned k = pRowPtr[i]; k < pRowPtr[i + 1]; k++) {
+            x[i] += PPtr[k] * xc[pColIdx[k]];
+        }
+    }
+
+    /*--- Post-smoothing. ---*/
+    for (unsigned s = 0; s < nSmooth; s++) {
+        smooth(l, b, x, false);
+    }
+
+    /*--- Release allocated memory. ---*/
+    delete[] r;
+    delete[] rc;
+    delete[] xc;
+}
+
+void CMultigrid::apply(const double* r, double* z) const {
+    unsigned n = lhs[0].getRows();
+    for (unsigned i = 0; i < n; i++) {
+        z[i] = 0.0;
+    }
+    cycle(0, r, z);
+}
+
+CMatrix CMultigrid::solve(const CMatrix& b) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    const CMatrixSparse& A = lhs[0];
+    const unsigned n = A.getRows();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    double* APtr = A.getMtxAddress();
+    double* r = new double[n];
+    double* e = new double[n];
+    double eps;
+    double stop;
+    double floor;
+    double normA = 0.0;
+    double normX = 0.0;
+    unsigned k = 0;
+    CMatrix x = CMatrix(n, 1, 0.0);
+    double* xPtr = x.getMtxAddress();
+    double* bPtr = b.getMtxAddress();
+
+    /*--- Infinity norm of the matrix, which bounds the rounding error of the
+          residual computed as b - A*x. ---*/
+    for (unsigned i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (unsigned j = rowPtr[i]; j < rowPtr[i + 1]; j++) {
+            sum += std::fabs(APtr[j]);
+        }
+        normA = std::max(normA, sum);
+    }
+
+    /*--- Multigrid iterations, x = x + inv(M)*(b - A*x), with the same
+          stopping criterion as the CG method, a residual 1e-10 times the
+          norm of b. On ill-conditioned systems that residual is below the
+          rounding error of b - A*x, so the iterations also stop once the
+          residual reaches sqrt(n)*DBL_EPSILON*|A|*|x|. ---*/
+    F77NAME(dcopy)(n, bPtr, 1, r, 1);
+    eps = F77NAME(dnrm2)(n, r, 1);
+    stop = 1e-10 * eps;
+    floor = 0.0;
+    while (eps > std::max(stop, floor) && k < 5000 && std::isfinite(eps)) {
+        apply(r, e);
+        F77NAME(daxpy)(n, 1.0, e, 1, xPtr, 1);
+        k++;
+
+        CMatrix Ax = A * x;
+        F77NAME(dcopy)(n, bPtr, 1, r, 1);
+        F77NAME(daxpy)(n, -1.0, Ax.getMtxAddress(), 1, r, 1);
+        eps = F77NAME(dnrm2)(n, r, 1);
+        normX = 0.0;
+        for (unsigned i = 0; i < n; i++) {
+            normX = std::max(normX, std::fabs(xPtr[i]));
+        }
+        floor = std::sqrt(double(n)) * DBL_EPSILON * normA * normX;
+    }
+    nIterations = k;
+
+    /*--- Release allocated memory. ---*/
+    delete[] r;
+    delete[] e;
+
+    /*--- A diverged or stalled iteration is an error, not a solution. ---*/
+    if (!std::isfinite(eps) || eps > std::max(stop, floor))
+        throw std::runtime_error("Multigrid method did not converge");
+
+    return x;
+}
+
+#endif
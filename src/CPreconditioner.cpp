@@ -0,0 +1,204 @@
+/*!
+ * @file CPreconditioner.cpp
+ * @brief The main subroutines for preconditioning the CG method.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CPRECONDITIONER_CPP
+#define __CPRECONDITIONER_CPP
+
+#include <cmath>
+#include <stdexcept>
+
+#include "../include/CPreconditioner.hpp"
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+
+CPreconditioner::CPreconditioner() {}
+
+CPreconditioner::~CPreconditioner() {}
+
+CPreconditionerJacobi::CPreconditionerJacobi(const CMatrixSparseSymmetric& A) {
+    /*--- Initialize properties. ---*/
+    size = A.getRows();
+    invDiag = CMatrix(size, 1, 0.0);
+
+    /*--- Store the inverse of the diagonal. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        double d = A(i, i);
+        if (d == 0.0) throw std::runtime_error("Zero diagonal in Jacobi");
+        invDiag(i, 0) = 1.0 / d;
+    }
+}
+
+CPreconditionerJacobi::~CPreconditionerJacobi() {}
+
+void CPreconditionerJacobi::apply(const double* r, double* z) const {
+    for (unsigned i = 0; i < size; i++) {
+        z[i] = invDiag(i, 0) * r[i];
+    }
+}
+
+CPreconditionerSSOR::CPreconditionerSSOR(const CMatrixSparseSymmetric& lhs,
+                                         const double w) {
+    /*--- Initialize properties. ---*/
+    if (w <= 0.0 || w >= 2.0)
+        throw std::runtime_error("SSOR relaxation factor out of (0, 2)");
+    size = lhs.getRows();
+    omega = w;
+    A = lhs;
+    diag = CMatrix(size, 1, 0.0);
+
+    /*--- Store the diagonal. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        diag(i, 0) = A(i, i);
+        if (diag(i, 0) == 0.0) throw std::runtime_error("Zero diagonal in SSOR");
+    }
+}
+
+CPreconditionerSSOR::~CPreconditionerSSOR() {}
+
+void CPreconditionerSSOR::apply(const double* r, double* z) const {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    double* APtr = A.getMtxAddress();
+
+    /*--- Forward sweep, (D/w + L)*y = r. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        double sum = r[i];
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (colIdx[k] < i) sum -= APtr[k] * z[colIdx[k]];
+        }
+        z[i] = sum * omega / diag(i, 0);
+    }
+
+    /*--- Diagonal scaling, y = D/w*y. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        z[i] *= diag(i, 0) / omega;
+    }
+
+    /*--- Backward sweep, (D/w + L')*z = y. The rows of L are the columns of
+          L', so every solved entry is eliminated from the previous ones. ---*/
+    for (unsigned i = size; i-- > 0;) {
+        z[i] *= omega / diag(i, 0);
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            if (colIdx[k] < i) z[colIdx[k]] -= APtr[k] * z[i];
+        }
+    }
+
+    /*--- Scaling of the SSOR splitting. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        z[i] *= (2.0 - omega) / omega;
+    }
+}
+
+CPreconditionerIC0::CPreconditionerIC0(const CMatrixSparseSymmetric& A) {
+    /*--- Initialize properties. ---*/
+    size = A.getRows();
+    shift = 0.0;
+
+    /*--- If a pivot is not positive, the diagonal is shifted until the
+          incomplete factorization exists. ---*/
+    while (!factorize(A, shift)) {
+        shift = (shift == 0.0) ? 0.001 : 2.0 * shift;
+        if (shift > 1.0)
+            throw std::runtime_error("Incomplete Cholesky breakdown");
+    }
+}
+
+CPreconditionerIC0::~CPreconditionerIC0() {}
+
+double CPreconditionerIC0::getShift() const {
+    return shift;
+}
+
+bool CPreconditionerIC0::factorize(const CMatrixSparseSymmetric& A,
+                                   const double alpha) {
+    /*--- The factor keeps the pattern of the lower triangle of A. ---*/
+    L = A;
+    unsigned* rowPtr = L.getRowPtrAddress();
+    unsigned* colIdx = L.getColIdxAddress();
+    double* LPtr = L.getMtxAddress();
+
+    /*--- Row by row factorization. Entry (i, j) is reduced with the product of
+          rows i and j of L, visiting only the columns shared by both rows. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        if (rowPtr[i + 1] == rowPtr[i] || colIdx[rowPtr[i + 1] - 1] != i)
+            throw std::runtime_error("Missing diagonal in incomplete Cholesky");
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned j = colIdx[k];
+            double sum = LPtr[k];
+            if (j == i) sum *= 1.0 + alpha;
+            unsigned ki = rowPtr[i];
+            unsigned kj = rowPtr[j];
+            while (ki < k && kj < rowPtr[j + 1] && colIdx[kj] < j) {
+                if (colIdx[ki] == colIdx[kj]) {
+                    sum -= LPtr[ki] * LPtr[kj];
+                    ki++;
+                    kj++;
+                } else if (colIdx[ki] < colIdx[kj]) {
+                    ki++;
+                } else {
+                    kj++;
+                }
+            }
+            if (j == i) {
+                if (sum <= 0.0) return false;
+                LPtr[k] = sqrt(sum);
+            } else {
+                LPtr[k] = sum / LPtr[rowPtr[j + 1] - 1];
+            }
+        }
+    }
+
+    return true;
+}
+
+void CPreconditionerIC0::apply(const double* r, double* z) const {
+    /*--- Initialize variables to be used in the subroutine. The diagonal is the
+          last entry of every row. ---*/
+    unsigned* rowPtr = L.getRowPtrAddress();
+    unsigned* colIdx = L.getColIdxAddress();
+    double* LPtr = L.getMtxAddress();
+
+    /*--- Forward substitution, L*y = r. ---*/
+    for (unsigned i = 0; i < size; i++) {
+        double sum = r[i];
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1] - 1; k++) {
+            sum -= LPtr[k] * z[colIdx[k]];
+        }
+        z[i] = sum / LPtr[rowPtr[i + 1] - 1];
+    }
+
+    /*--- Backward substitution, L'*z = y. ---*/
+    for (unsigned i = size; i-- > 0;) {
+        z[i] /= LPtr[rowPtr[i + 1] - 1];
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1] - 1; k++) {
+            z[colIdx[k]] -= LPtr[k] * z[i];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*!
+ * @file CShapeFunctions.cpp
+ * @brief The main subroutines for tabulating the shape functions of the
+ *        reference elements at the Gauss points.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __CSHAPEFUNCTIONS_CPP
+#define __CSHAPEFUNCTIONS_CPP
+
+#include <cmath>
+#include <stdexcept>
+
+#include "../include/CShapeFunctions.hpp"
+#include "../include/CMatrix.hpp"
+
+/*--- Gauss-Legendre points and weights in [-1, 1], folded into constants by
+      the compiler. Order n starts at position n*(n-1)/2. ---*/
+static const double legendrePoints[] = {
+    0.0,
+    -1.0 / sqrt(3.0), 1.0 / sqrt(3.0),
+    -sqrt(3.0 / 5.0), 0.0, sqrt(3.0 / 5.0),
+    -sqrt(3.0 / 7.0 + 2.0 / 7.0 * sqrt(6.0 / 5.0)),
+    -sqrt(3.0 / 7.0 - 2.0 / 7.0 * sqrt(6.0 / 5.0)),
+    sqrt(3.0 / 7.0 - 2.0 / 7.0 * sqrt(6.0 / 5.0)),
+    sqrt(3.0 / 7.0 + 2.0 / 7.0 * sqrt(6.0 / 5.0)),
+    -sqrt(5.0 + 2.0 * sqrt(10.0 / 7.0)) / 3.0,
+    -sqrt(5.0 - 2.0 * sqrt(10.0 / 7.0)) / 3.0,
+    0.0,
+    sqrt(5.0 - 2.0 * sqrt(10.0 / 7.0)) / 3.0,
+    sqrt(5.0 + 2.0 * sqrt(10.0 / 7.0)) / 3.0
+};
+static const double legendreWeights[] = {
+    2.0,
+    1.0, 1.0,
+    5.0 / 9.0, 8.0 / 9.0, 5.0 / 9.0,
+    (18.0 - sqrt(30.0)) / 36.0, (18.0 + sqrt(30.0)) / 36.0,
+    (18.0 + sqrt(30.0)) / 36.0, (18.0 - sqrt(30.0)) / 36.0,
+    (322.0 - 13.0 * sqrt(70.0)) / 900.0, (322.0 + 13.0 * sqrt(70.0)) / 900.0,
+    128.0 / 225.0,
+    (322.0 + 13.0 * sqrt(70.0)) / 900.0, (322.0 - 13.0 * sqrt(70.0)) / 900.0
+};
+
+/*--- Reference coordinates of the nodes of the quadrilaterals: the corners
+      counterclockwise from (-1, -1), the midsides of the bottom, right, top and
+      left edges and the centre. ---*/
+static const double xiNode[] = {-1.0, 1.0, 1.0, -1.0, 0.0, 1.0, 0.0, -1.0, 0.0};
+static const double etaNode[] = {-1.0, -1.0, 1.0, 1.0, -1.0, 0.0, 1.0, 0.0, 0.0};
+
+/*--- Quadratic Lagrange polynomial in 1D of the node at xa, which is -1, 0 or
+      1, and its derivative. ---*/
+static double lagrange2(const double x, const double xa) {
+    if (xa == 0.0) return 1.0 - x * x;
+    return 0.5 * x * (x + xa);
+}
+
+static double lagrange2Der(const double x, const double xa) {
+    if (xa == 0.0) return -2.0 * x;
+    return x + 0.5 * xa;
+}
+
+CShapeFunctions::CShapeFunctions(const unsigned order, const unsigned nodes) {
+    /*--- Initialize properties. ---*/
+    gaussOrder = order;
+    nNodes = nodes;
+    nLineNodes = (nodes == 4) ? 2 : 3;
+    nQuadPoints = order * order;
+    gaussPoints = CMatrix(1, order, 0.0);
+    gaussWeights = CMatrix(1, order, 0.0);
+    lineN.resize(nLineNodes*order);
+    lineDN.resize(nLineNodes*order);
+    quadN.resize(nNodes*nQuadPoints);
+    quadDXi.resize(nNodes*nQuadPoints);
+    quadDEta.resize(nNodes*nQuadPoints);
+    quadW.resize(nQuadPoints);
+
+    /*--- Gauss points in 1D and line shape functions. The quadratic line has
+          the middle node between the end ones. ---*/
+    unsigned first = order * (order - 1) / 2;
+    for (unsigned i = 0; i < order; i++) {
+        double xi = legendrePoints[first+i];
+        gaussPoints(0, i) = xi;
+        gaussWeights(0, i) = legendreWeights[first+i];
+        double* N = &lineN[nLineNodes*i];
+        double* dN = &lineDN[nLineNodes*i];
+        if (nLineNodes == 2) {
+            N[0] = 0.5 * (1 - xi);
+            N[1] = 0.5 * (1 + xi);
+            dN[0] = -0.5;
+            dN[1] = 0.5;
+        } else {
+            for (unsigned a = 0; a < 3; a++) {
+                N[a] = lagrange2(xi, a - 1.0);
+                dN[a] = lagrange2Der(xi, a - 1.0);
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < order; i++) {
+        for (unsigned j = 0; j < order; j++) {
+            unsigned q = i * order + j;
+            double eta = gaussPoints(0, i);
+            double xi = gaussPoints(0, j);
+            double* N = &quadN[nNodes*q];
+            double* dXi = &quadDXi[nNodes*q];
+            double* dEta = &quadDEta[nNodes*q];
+
+            if (nNodes == 4) {
+                /*--- Bilinear quadrilateral. ---*/
+                N[0] = 0.25 * (1 - xi) * (1 - eta);
+                N[1] = 0.25 * (1 + xi) * (1 - eta);
+                N[2] = 0.25 * (1 + xi) * (1 + eta);
+                N[3] = 0.25 * (1 - xi) * (1 + eta);
+
+                dXi[0] = 0.25 * (-(1 - eta));
+                dXi[1] = 0.25 * (1 - eta);
+                dXi[2] = 0.25 * (1 + eta);
+                dXi[3] = 0.25 * (-(1 + eta));
+                dEta[0] = 0.25 * (-(1 - xi));
+                dEta[1] = 0.25 * (-(1 + xi));
+                dEta[2] = 0.25 * (1 + xi);
+                dEta[3] = 0.25 * (1 - xi);
+            } else if (nNodes == 8) {
+                /*--- Serendipity quadrilateral. ---*/
+                for (unsigned a = 0; a < 4; a++) {
+                    double xa = xiNode[a];
+                    double ea = etaNode[a];
+                    N[a] = 0.25 * (1 + xi*xa) * (1 + eta*ea) *
+                           (xi*xa + eta*ea - 1);
+                    dXi[a] = 0.25 * xa * (1 + eta*ea) * (2*xi*xa + eta*ea);
+                    dEta[a] = 0.25 * ea * (1 + xi*xa) * (xi*xa + 2*eta*ea);
+                }
+                for (unsigned a = 4; a < 8; a++) {
+                    double xa = xiNode[a];
+                    double ea = etaNode[a];
+                    if (xa == 0.0) {
+                        N[a] = 0.5 * (1 - xi*xi) * (1 + eta*ea);
+                        dXi[a] = -xi * (1 + eta*ea);
+                        dEta[a] = 0.5 * ea * (1 - xi*xi);
+                    } else {
+                        N[a] = 0.5 * (1 + xi*xa) * (1 - eta*eta);
+                        dXi[a] = 0.5 * xa * (1 - eta*eta);
+                        dEta[a] = -eta * (1 + xi*xa);
+                    }
+                }
+            } else {
+                /*--- Lagrange quadrilateral, product of the quadratic
+                      polynomials in every direction. ---*/
+                for (unsigned a = 0; a < 9; a++) {
+                    double Lx = lagrange2(xi, xiNode[a]);
+                    double Ly = lagrange2(eta, etaNode[a]);
+                    N[a] = Lx * Ly;
+                    dXi[a] = lagrange2Der(xi, xiNode[a]) * Ly;
+                    dEta[a] = Lx * lagrange2Der(eta, etaNode[a]);
+                }
+            }
+
+            quadW[q] = gaussWeights(0, i) * gaussWeights(0, j);
+        }
+    }
+}
+
+const CShapeFunctions& CShapeFunctions::getTable(const unsigned order,
+                                                 const unsigned nodes) {
+    if (order == 0 || order > maxGaussOrder)
+        throw std::runtime_error("Unsupported Gauss order");
+    if (nodes != 4 && nodes != 8 && nodes != 9)
+        throw std::runtime_error("Unsupported number of nodes per element");
+
+    /*--- Tables are built once, on the first request. ---*/
+    static const CShapeFunctions tables[3][maxGaussOrder] = {
+        {CShapeFunctions(1, 4), CShapeFunctions(2, 4), CShapeFunctions(3, 4),
+         CShapeFunctions(4, 4), CShapeFunctions(5, 4)},
+        {CShapeFunctions(1, 8), CShapeFunctions(2, 8), CShapeFunctions(3, 8),
+         CShapeFunctions(4, 8), CShapeFunctions(5, 8)},
+        {CShapeFunctions(1, 9), CShapeFunctions(2, 9), CShapeFunctions(3, 9),
+         CShapeFunctions(4, 9), CShapeFunctions(5, 9)}
+    };
+
+    return tables[(nodes == 4) ? 0 : nodes - 7][order-1];
+}
+
+unsigned CShapeFunctions::defaultGaussOrder(const unsigned nodes) {
+    return (nodes == 4) ? 2 : 3;
+}
+
+unsigned CShapeFunctions::getGaussOrder() const {
+    return gaussOrder;
+}
+
+unsigned CShapeFunctions::getNNodes() const {
+    return nNodes;
+}
+
+unsigned CShapeFunctions::getNLineNodes() const {
+    return nLineNodes;
+}
+
+unsigned CShapeFunctions::getNQuadPoints() const {
+    return nQuadPoints;
+}
+
+const CMatrix& CShapeFunctions::getGaussPoints() const {
+    return gaussPoints;
+}
+
+const CMatrix& CShapeFunctions::getGaussWeights() const {
+    return gaussWeights;
+}
+
+const double* CShapeFunctions::getLineN(const unsigned q) const {
+    return &lineN[nLineNodes*q];
+}
+
+const double* CShapeFunctions::getLineDN(const unsigned q) const {
+    return &lineDN[nLineNodes*q];
+}
+
+const double* CShapeFunctions::getQuadN(const unsigned q) const {
+    return &quadN[nNodes*q];
+}
+
+const double* CShapeFunctions::getQuadDXi(const unsigned q) const {
+    return &quadDXi[nNodes*q];
+}
+
+const double* CShapeFunctions::getQuadDEta(const unsigned q) const {
+    return &quadDEta[nNodes*q];
+}
+
+double CShapeFunctions::getQuadWeight(const unsigned q) const {
+    return quadW[q];
+}
+
+#endif
@@ -0,0 +1,426 @@
+/*!
+ * @file CSparseCholesky.cpp
+ * @brief The main subroutines for the sparse Cholesky factorization.
+ * @author S.Ramon (seraco)
+ * @version 0.0.1
+ *
+ * Copyright 2018 S.Ramon
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef __CSPARSECHOLESKY_CPP
+#define __CSPARSECHOLESKY_CPP
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/CSparseCholesky.hpp"
+#include "../include/CMatrix.hpp"
+#include "../include/CMatrixSparseSymmetric.hpp"
+
+template <typename P>
+CSparseCholesky<P>::CSparseCholesky() {
+    /*--- Initialize properties. ---*/
+    size = 0;
+    isAnalyzed = false;
+    nAnalyses = 0;
+}
+
+template <typename P>
+CSparseCholesky<P>::CSparseCholesky(const CMatrixSparseSymmetric& A,
+                                    const std::vector<unsigned>& order) {
+    /*--- Initialize properties. ---*/
+    size = 0;
+    isAnalyzed = false;
+    nAnalyses = 0;
+
+    /*--- Symbolic and numeric phases. ---*/
+    analyze(A, order);
+    factorize(A);
+}
+
+template <typename P>
+CSparseCholesky<P>::~CSparseCholesky() {}
+
+template <typename P>
+unsigned CSparseCholesky<P>::getSize() const {
+    return size;
+}
+
+template <typename P>
+unsigned CSparseCholesky<P>::getNNonZeroFactor() const {
+    return lRowIdx.size();
+}
+
+template <typename P>
+unsigned CSparseCholesky<P>::getNAnalyses() const {
+    return nAnalyses;
+}
+
+template <typename P>
+size_t CSparseCholesky<P>::getBytes() const {
+    size_t nIdx = perm.size() + aRowPtr.size() + aColIdx.size() +
+                  cRowPtr.size() + cColIdx.size() + cPos.size() +
+                  parent.size() + lColPtr.size() + lRowIdx.size();
+    return nIdx*sizeof(unsigned) + lVal.size()*sizeof(P);
+}
+
+template <typename P>
+template <typename V>
+void CSparseCholesky<P>::writeVector(std::ostream& out,
+                                     const std::vector<V>& vec) {
+    unsigned n = vec.size();
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char*>(vec.data()), n*sizeof(V));
+}
+
+template <typename P>
+template <typename V>
+void CSparseCholesky<P>::readVector(std::istream& in, std::vector<V>& vec) {
+    unsigned n = 0;
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    vec.resize(n);
+    in.read(reinterpret_cast<char*>(vec.data()), n*sizeof(V));
+}
+
+template <typename P>
+void CSparseCholesky<P>::write(std::ostream& out) const {
+    if (!isAnalyzed)
+        throw std::runtime_error("Sparse Cholesky without symbolic phase");
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    writeVector(out, perm);
+    writeVector(out, aRowPtr);
+    writeVector(out, aColIdx);
+    writeVector(out, cRowPtr);
+    writeVector(out, cColIdx);
+    writeVector(out, cPos);
+    writeVector(out, parent);
+    writeVector(out, lColPtr);
+    writeVector(out, lRowIdx);
+    writeVector(out, lVal);
+}
+
+template <typename P>
+void CSparseCholesky<P>::read(std::istream& in) {
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    readVector(in, perm);
+    readVector(in, aRowPtr);
+    readVector(in, aColIdx);
+    readVector(in, cRowPtr);
+    readVector(in, cColIdx);
+    readVector(in, cPos);
+    readVector(in, parent);
+    readVector(in, lColPtr);
+    readVector(in, lRowIdx);
+    readVector(in, lVal);
+    if (!in || !isConsistent()) {
+        isAnalyzed = false;
+        throw std::runtime_error("Corrupted sparse Cholesky factor");
+    }
+    isAnalyzed = true;
+}
+
+template <typename P>
+bool CSparseCholesky<P>::isConsistent() const {
+    /*--- Sizes of the vectors. ---*/
+    unsigned nnz = aColIdx.size();
+    size_t nPtr = size_t(size) + 1;
+    if (perm.size() != size || parent.size() != size ||
+        aRowPtr.size() != nPtr || cRowPtr.size() != nPtr ||
+        lColPtr.size() != nPtr || cColIdx.size() != nnz ||
+        cPos.size() != nnz || lVal.size() != lRowIdx.size())
+        return false;
+
+    /*--- Pointers from zero to the size of their index vectors. ---*/
+    if (aRowPtr[0] != 0 || cRowPtr[0] != 0 || lColPtr[0] != 0 ||
+        aRowPtr[size] != nnz || cRowPtr[size] != nnz ||
+        lColPtr[size] != lRowIdx.size())
+        return false;
+    for (unsigned i = 0; i < size; i++) {
+        if (aRowPtr[i] > aRowPtr[i + 1] || cRowPtr[i] > cRowPtr[i + 1] ||
+            lColPtr[i] >= lColPtr[i + 1])
+            return false;
+    }
+
+    /*--- Permutation and indices below their dimension, the pattern of C
+          in its lower triangle. ---*/
+    std::vector<bool> isUsed(size, false);
+    for (unsigned k = 0; k < size; k++) {
+        if (perm[k] >= size || isUsed[perm[k]]) return false;
+        isUsed[perm[k]] = true;
+    }
+    for (unsigned k = 0; k < nnz; k++) {
+        if (aColIdx[k] >= size || cPos[k] >= nnz) return false;
+    }
+    for (unsigned k = 0; k < size; k++) {
+        for (unsigned p = cRowPtr[k]; p < cRowPtr[k + 1]; p++) {
+            if (cColIdx[p] > k) return false;
+        }
+    }
+
+    /*--- The parent of every column is a later column, and the path from
+          every entry (k, i) of C climbs the tree up to k, as rowPattern
+          assumes. Every column of the path adds an entry to its column of
+          L, besides the diagonal. ---*/
+    std::vector<unsigned> mark(size, size);
+    std::vector<unsigned> count(size, 1);
+    for (unsigned k = 0; k < size; k++) {
+        if (parent[k] != -1 &&
+            (parent[k] <= int(k) || parent[k] >= int(size)))
+            return false;
+        mark[k] = k;
+        for (unsigned p = cRowPtr[k]; p < cRowPtr[k + 1]; p++) {
+            for (unsigned i = cColIdx[p]; mark[i] != k; i = parent[i]) {
+                if (parent[i] == -1 || parent[i] > int(k)) return false;
+                mark[i] = k;
+                count[i]++;
+            }
+        }
+    }
+
+    /*--- Columns of L with the diagonal first and the rows below it. ---*/
+    for (unsigned j = 0; j < size; j++) {
+        if (lColPtr[j + 1] - lColPtr[j] != count[j] ||
+            lRowIdx[lColPtr[j]] != j)
+            return false;
+        for (unsigned p = lColPtr[j] + 1; p < lColPtr[j + 1]; p++) {
+            if (lRowIdx[p] <= j || lRowIdx[p] >= size) return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename P>
+void CSparseCholesky<P>::analyze(const CMatrixSparseSymmetric& A,
+                                 const std::vector<unsigned>& order) {
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    size = A.getRows();
+    unsigned nnz = A.getNNonZero();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    std::vector<unsigned> pinv(size, size);
+    if (order.size() != size)
+        throw std::runtime_error("Ordering with a different size");
+    for (unsigned k = 0; k < size; k++) {
+        if (order[k] >= size || pinv[order[k]] != size)
+            throw std::runtime_error("Ordering is not a permutation");
+        pinv[order[k]] = k;
+    }
+    perm = order;
+    aRowPtr.assign(rowPtr, rowPtr + size + 1);
+    aColIdx.assign(colIdx, colIdx + nnz);
+
+    /*--- Lower triangle of C = P*A*P'. Entry (i, j) of A goes to row
+          max(pinv[i], pinv[j]) of C. ---*/
+    cRowPtr.assign(size + 1, 0);
+    cColIdx.assign(nnz, 0);
+    cPos.assign(nnz, 0);
+    for (unsigned i = 0; i < size; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned pi = pinv[i];
+            unsigned pj = pinv[colIdx[k]];
+            cRowPtr[(pi > pj ? pi : pj) + 1]++;
+        }
+    }
+    for (unsigned i = 0; i < size; i++) {
+        cRowPtr[i + 1] += cRowPtr[i];
+    }
+    std::vector<unsigned> fill(cRowPtr.begin(), cRowPtr.end() - 1);
+    for (unsigned i = 0; i < size; i++) {
+        for (unsigned k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            unsigned pi = pinv[i];
+            unsigned pj = pinv[colIdx[k]];
+            unsigned row = pi > pj ? pi : pj;
+            cPos[k] = fill[row]++;
+            cColIdx[cPos[k]] = pi > pj ? pj : pi;
+        }
+    }
+
+    /*--- Elimination tree, with path compression through the ancestors. ---*/
+    parent.assign(size, -1);
+    std::vector<int> ancestor(size, -1);
+    for (unsigned k = 0; k < size; k++) {
+        for (unsigned p = cRowPtr[k]; p < cRowPtr[k + 1]; p++) {
+            int i = cColIdx[p];
+            while (i != -1 && i < int(k)) {
+                int next = ancestor[i];
+                ancestor[i] = k;
+                if (next == -1) parent[i] = k;
+                i = next;
+            }
+        }
+    }
+
+    /*--- Column counts of L from the pattern of every row. ---*/
+    std::vector<unsigned> mark(size, size);
+    std::vector<unsigned> stack(size, 0);
+    std::vector<unsigned> count(size, 1);
+    for (unsigned k = 0; k < size; k++) {
+        for (unsigned top = rowPattern(k, mark, stack); top < size; top++) {
+            count[stack[top]]++;
+        }
+    }
+    lColPtr.assign(size + 1, 0);
+    for (unsigned j = 0; j < size; j++) {
+        lColPtr[j + 1] = lColPtr[j] + count[j];
+    }
+    lRowIdx.assign(lColPtr[size], 0);
+    lVal.assign(lColPtr[size], 0.0);
+
+    isAnalyzed = true;
+    nAnalyses++;
+}
+
+template <typename P>
+unsigned CSparseCholesky<P>::rowPattern(const unsigned k,
+                                        std::vector<unsigned>& mark,
+                                        std::vector<unsigned>& stack) const {
+    /*--- Every entry (k, i) of C reaches row k of L through the path from i to
+          k in the elimination tree. The paths are stacked so that every column
+          comes before its ancestors. ---*/
+    unsigned top = size;
+    unsigned len;
+    mark[k] = k;
+    for (unsigned p = cRowPtr[k]; p < cRowPtr[k + 1]; p++) {
+        unsigned i = cColIdx[p];
+        if (i >= k) continue;
+        for (len = 0; mark[i] != k; i = parent[i]) {
+            stack[len++] = i;
+            mark[i] = k;
+        }
+        while (len > 0) stack[--top] = stack[--len];
+    }
+
+    return top;
+}
+
+template <typename P>
+void CSparseCholesky<P>::factorize(const CMatrixSparseSymmetric& A) {
+    /*--- The symbolic phase is reused if the pattern has not changed. ---*/
+    unsigned nnz = A.getNNonZero();
+    unsigned* rowPtr = A.getRowPtrAddress();
+    unsigned* colIdx = A.getColIdxAddress();
+    bool isSamePattern = isAnalyzed && A.getRows() == size &&
+                         nnz == aColIdx.size();
+    for (unsigned i = 0; i < size + 1 && isSamePattern; i++) {
+        isSamePattern = rowPtr[i] == aRowPtr[i];
+    }
+    for (unsigned k = 0; k < nnz && isSamePattern; k++) {
+        isSamePattern = colIdx[k] == aColIdx[k];
+    }
+    if (!isSamePattern)
+        throw std::runtime_error("Pattern differs from the symbolic analysis");
+
+    /*--- Initialize variables to be used in the subroutine. ---*/
+    double* APtr = A.getMtxAddress();
+    std::vector<double> cVal(nnz, 0.0);
+    std::vector<double> x(size, 0.0);
+    std::vector<unsigned> mark(size, size);
+    std::vector<unsigned> stack(size, 0);
+    std::vector<unsigned> next(lColPtr.begin(), lColPtr.end() - 1);
+    for (unsigned k = 0; k < nnz; k++) {
+        cVal[cPos[k]] = APtr[k];
+    }
+
+    /*--- Up-looking factorization. Row k of L solves a triangular system with
+          the rows of L already computed, L(0:k-1,0:k-1)*L(k,0:k-1)' = C(0:k-1,k),
+          and the diagonal is the square root of what is left of C(k,k). The
+          row is accumulated in double precision and stored in the precision
+          of the factor. ---*/
+    for (unsigned k = 0; k < size; k++) {
+        unsigned top = rowPattern(k, mark, stack);
+        for (unsigned p = cRowPtr[k]; p < cRowPtr[k + 1]; p++) {
+            x[cColIdx[p]] += cVal[p];
+        }
+        double d = x[k];
+        x[k] = 0.0;
+        for (; top < size; top++) {
+            unsigned i = stack[top];
+            double lki = x[i] / lVal[lColPtr[i]];
+            x[i] = 0.0;
+            for (unsigned p = lColPtr[i] + 1; p < next[i]; p++) {
+                x[lRowIdx[p]] -= lVal[p] * lki;
+            }
+            d -= lki * lki;
+            unsigned p = next[i]++;
+            lRowIdx[p] = k;
+            lVal[p] = lki;
+        }
+        if (d <= 0.0)
+            throw std::runtime_error("Matrix not positive definite");
+        unsigned p = next[k]++;
+        lRowIdx[p] = k;
+        lVal[p] = sqrt(d);
+    }
+}
+
+template <typename P>
+CMatrix CSparseCholesky<P>::solve(const CMatrix& b) const {
+    unsigned nRhs = b.getCols();
+    CMatrix x = CMatrix(size, nRhs, 0.0);
+    std::vector<double> y(size*nRhs, 0.0);
+
+    /*--- Permute, forward substitution L*z = P*b, backward substitution
+          L'*y = z and permute back. The substitutions accumulate in double
+          precision, and every entry of L is applied to all the RHS vectors
+          at once. ---*/
+    for (unsigned c = 0; c < nRhs; c++) {
+        for (unsigned k = 0; k < size; k++) {
+            y[k*nRhs+c] = b(perm[k], c);
+        }
+    }
+    for (unsigned j = 0; j < size; j++) {
+        double* yj = &y[j*nRhs];
+        for (unsigned c = 0; c < nRhs; c++) {
+            yj[c] /= lVal[lColPtr[j]];
+        }
+        for (unsigned p = lColPtr[j] + 1; p < lColPtr[j + 1]; p++) {
+            double* yi = &y[lRowIdx[p]*nRhs];
+            for (unsigned c = 0; c < nRhs; c++) {
+                yi[c] -= lVal[p] * yj[c];
+            }
+        }
+    }
+    for (unsigned j = size; j-- > 0;) {
+        double* yj = &y[j*nRhs];
+        for (unsigned p = lColPtr[j] + 1; p < lColPtr[j + 1]; p++) {
+            double* yi = &y[lRowIdx[p]*nRhs];
+            for (unsigned c = 0; c < nRhs; c++) {
+                yj[c] -= lVal[p] * yi[c];
+            }
+        }
+        for (unsigned c = 0; c < nRhs; c++) {
+            yj[c] /= lVal[lColPtr[j]];
+        }
+    }
+    for (unsigned c = 0; c < nRhs; c++) {
+        for (unsigned k = 0; k < size; k++) {
+            x(perm[k], c) = y[k*nRhs+c];
+        }
+    }
+
+    return x;
+}
+
+#endif
@@ -43,9 +43,9 @@ void writeVTK(std::string fname, const CMesh& msh, const CHeatConduction& heat)
     unsigned nNod = msh.getNNode();
     unsigned nEle = msh.getNElem();
     unsigned nNodPerEle = msh.getNNodePerElem();
-    CMatrix coor = msh.getCoorMtx();
-    CMatrix conn = msh.getConnMtx();
-    CMatrix temp = heat.getTemp();
+    const CMatrix& coor = msh.getCoorMtx();
+    const CMatrixIndex& conn = msh.getConnMtx();
+    const CMatrix& temp = heat.getTemp();
     double zero = 0.0;
 
     /*--- Open file for writing results. ---*/
@@ -75,10 +75,13 @@ void writeVTK(std::string fname, const CMesh& msh, const CHeatConduction& heat)
             vtk << "\n";
         }
 
-        /*--- Write the type of elements. Quads (9) in this case. ---*/
+        /*--- Write the type of elements: quads (9), quadratic quads (23) or
+              biquadratic quads (28). The nodes of the mesh follow the VTK
+              order. ---*/
+        unsigned cellType = (nNodPerEle == 8) ? 23 : (nNodPerEle == 9) ? 28 : 9;
         vtk << "CELL_TYPES " << nEle << "\n";
         for (unsigned int i = 0; i < nEle; i++) {
-            vtk << 9 << "\n";
+            vtk << cellType << "\n";
         }
 
         /*--- Write temperature results. ---*/
@@ -1,5 +1,7 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <stdexcept>
 #include <mpi.h>
 
@@ -10,6 +12,7 @@
 #include "../include/CConductance.hpp"
 #include "../include/CBoundaryConditions.hpp"
 #include "../include/CHeatConduction.hpp"
+#include "../include/CFactorCache.hpp"
 #include "../include/WriteVTK.hpp"
 #include "../include/Analytical.hpp"
 
@@ -41,15 +44,75 @@ int main(int argc, char *argv[]) {
         double flVal = cmd.getFluxValue();
         std::string tpLoc = cmd.getTempLocation();
         double tpVal = cmd.getTempValue();
+        std::string precond = cmd.getPreconditioner();
+        std::string solver = cmd.getSolver();
+        std::string cycle = cmd.getMgCycle();
+        std::string method = cmd.getCgMethod();
+        unsigned sStep = cmd.getSStep();
+        std::string sBasis = cmd.getSBasis();
+        unsigned nNodPerEl = cmd.getNNodePerElem();
+        unsigned order = cmd.getGaussOrder();
+        std::string cacheDir = cmd.getCacheDir();
+        size_t cacheSize = cmd.getCacheSize();
 
+        double wallTime = MPI_Wtime();
         CMaterial mat = CMaterial(kXX, kXY, kYY);
         CGeometry geo = CGeometry(a, h1, h2, L, th);
-        CMesh msh = CMesh(Nx, Ny, geo);
+        CMesh msh = CMesh(Nx, Ny, geo, nNodPerEl);
 
-        CConductance con = CConductance(geo, mat, msh);
-        CBoundaryConditions bnd = CBoundaryConditions(flLoc, flVal,
-                                                      tpLoc, tpVal, msh, geo);
-        CHeatConduction heat = CHeatConduction(bnd, con, msh);
+        CBoundaryConditions bnd = CBoundaryConditions(flLoc, flVal, tpLoc,
+                                                      tpVal, msh, geo, order);
+
+        /*--- The cache keeps the submatrices and the factor, so the solvers
+              that need the whole conductance do not use it. The entry is
+              loaded before deciding, and on a hit in every rank the
+              conductance is not assembled. ---*/
+        bool useCache = !cacheDir.empty() && solver != "matrix-free" &&
+                        solver != "multigrid" && precond != "multigrid";
+        CFactorCache cache = CFactorCache(cacheSize*1024*1024, cacheDir);
+        std::string key = useCache ?
+                          CFactorCache::computeKey(geo, mat, msh, bnd) : "";
+        bool isCached = useCache && cache.find(key);
+
+        /*--- The distributed solver only needs the rows of Kff of every
+              rank, unless they are kept by the cache. ---*/
+        bool distribute = solver == "distributed" && !useCache;
+        CConductance con = (solver == "matrix-free") ?
+                           CConductance(geo, mat, msh, false, order) :
+                           isCached ? CConductance() :
+                           CConductance(geo, mat, msh, bnd, order, distribute);
+        CHeatConduction heat = CHeatConduction(bnd, con, msh, precond,
+                                               solver, cycle, method,
+                                               sStep, sBasis,
+                                               useCache ? &cache : nullptr,
+                                               key);
+        wallTime = MPI_Wtime() - wallTime;
+        if (rank == 0 && solver != "direct" && solver != "cholesky") {
+            std::cout << "Solver iterations: " << heat.getNIterations() << "\n";
+        }
+        const std::vector<double>& iterTime = heat.getIterationTimes();
+        if (rank == 0 && !iterTime.empty()) {
+            std::cout << "Time per iteration (s): product " << iterTime[0]
+                      << ", preconditioner " << iterTime[1]
+                      << ", reductions " << iterTime[2]
+                      << ", vectors " << iterTime[3] << "\n";
+        }
+        if (rank == 0 && useCache) {
+            std::cout << "Cache hits: " << cache.getNHits()
+                      << ", misses: " << cache.getNMisses() << "\n";
+        }
+        if (rank == 0) {
+            std::cout << "Number of DOF: " << msh.getNDofTotal() << "\n";
+            std::cout << "Wall time (s): " << wallTime << "\n";
+            const CMatrix& temp = heat.getTemp();
+            double maxTemp = temp(0, 0);
+            for (unsigned i = 1; i < temp.getRows(); i++) {
+                maxTemp = std::max(maxTemp, temp(i, 0));
+            }
+            std::streamsize precision = std::cout.precision(15);
+            std::cout << "Maximum temperature: " << maxTemp << "\n";
+            std::cout.precision(precision);
+        }
 
         solveAnalytical(msh, bnd, mat, heat.getTemp());
 
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrixBanded.hpp"
+
+namespace {
+    class CMatrixBandedTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                A = new CMatrixBanded(size, 1, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    (*A)(i, i) = 2.0;
+                    if (i > 0) (*A)(i, i - 1) = -1.0;
+                }
+            }
+            virtual void TearDown() {
+                delete A;
+            }
+
+            CMatrixBanded* A;
+    };
+
+    TEST_F(CMatrixBandedTest, DefaultConstructor) {
+        CMatrixBanded mat;
+        EXPECT_EQ(0, mat.getRows());
+        EXPECT_EQ(0, mat.getCols());
+        EXPECT_EQ(0, mat.getNBands());
+    }
+
+    TEST_F(CMatrixBandedTest, CustomConstructor) {
+        CMatrixBanded mat = CMatrixBanded(5, 2, 1.0);
+        EXPECT_EQ(5, mat.getRows());
+        EXPECT_EQ(5, mat.getCols());
+        EXPECT_EQ(2, mat.getNBands());
+        EXPECT_EQ(1.0, mat(4, 2));
+        EXPECT_EQ(1.0, mat(2, 4));
+    }
+
+    TEST_F(CMatrixBandedTest, Access) {
+        const CMatrixBanded& mat = *A;
+        EXPECT_EQ(-1.0, mat(1, 2));
+        EXPECT_EQ(-1.0, mat(2, 1));
+        EXPECT_EQ(0.0, mat(0, 3));
+        EXPECT_EQ(-1.0, A->getMtxAddress()[1]);
+        EXPECT_THROW((*A)(3, 0) = 1.0, std::runtime_error);
+    }
+
+    TEST_F(CMatrixBandedTest, CopyAndAssignment) {
+        const CMatrixBanded copy = CMatrixBanded(*A);
+        CMatrixBanded assigned;
+        assigned = copy;
+        const CMatrixBanded& mat = *A;
+        const CMatrixBanded& res = assigned;
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            for (unsigned j = 0; j < A->getCols(); j++) {
+                EXPECT_EQ(mat(i, j), copy(i, j));
+                EXPECT_EQ(mat(i, j), res(i, j));
+            }
+        }
+    }
+}
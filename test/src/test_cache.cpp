@@ -0,0 +1,226 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unistd.h>
+#include <dirent.h>
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+#include "../../include/CFactorCache.hpp"
+#include "../../include/CHeatConduction.hpp"
+
+namespace {
+    class CFactorCacheTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+                mat = new CMaterial(250.0, 0.0, 250.0);
+                geo = new CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+                msh = new CMesh(6, 4, *geo);
+                con = new CConductance(*geo, *mat, *msh);
+                bnd = new CBoundaryConditions("bottom", -5000.0, "left", -20.0,
+                                              *msh, *geo);
+                heat = new CHeatConduction(*bnd, *con, *msh);
+            }
+            virtual void TearDown() {
+                delete heat;
+                delete bnd;
+                delete con;
+                delete msh;
+                delete geo;
+                delete mat;
+            }
+
+            /*--- Temporary directory created by rank 0 and shared by all
+                  the ranks, since only rank 0 writes the files of the
+                  cache. ---*/
+            std::string makeDir() {
+                char dir[] = "/tmp/heatcacheXXXXXX";
+                if (rank == 0 && mkdtemp(dir) == nullptr) dir[0] = '\0';
+                MPI_Bcast(dir, sizeof(dir), MPI_CHAR, 0, MPI_COMM_WORLD);
+                return dir;
+            }
+
+            /*--- Remove the directory and its files once every rank is
+                  done with them. ---*/
+            void removeDir(const std::string& dir) {
+                MPI_Barrier(MPI_COMM_WORLD);
+                if (rank == 0) {
+                    DIR* handle = opendir(dir.c_str());
+                    while (dirent* file = readdir(handle)) {
+                        std::string name = file->d_name;
+                        if (name != "." && name != "..")
+                            std::remove((dir + "/" + name).c_str());
+                    }
+                    closedir(handle);
+                    rmdir(dir.c_str());
+                }
+            }
+
+            int rank;
+            CMaterial* mat;
+            CGeometry* geo;
+            CMesh* msh;
+            CConductance* con;
+            CBoundaryConditions* bnd;
+            CHeatConduction* heat;
+    };
+
+    TEST_F(CFactorCacheTest, ComputeKey) {
+        std::string key = CFactorCache::computeKey(*geo, *mat, *msh, *bnd);
+        EXPECT_EQ(16, key.size());
+        CBoundaryConditions values = CBoundaryConditions("top", 100.0, "left",
+                                                         30.0, *msh, *geo);
+        EXPECT_EQ(key, CFactorCache::computeKey(*geo, *mat, *msh, values));
+        CBoundaryConditions location = CBoundaryConditions("bottom", -5000.0,
+                                                           "right", -20.0,
+                                                           *msh, *geo);
+        EXPECT_NE(key, CFactorCache::computeKey(*geo, *mat, *msh, location));
+        CMaterial other = CMaterial(250.0, 10.0, 250.0);
+        EXPECT_NE(key, CFactorCache::computeKey(*geo, other, *msh, *bnd));
+    }
+
+    TEST_F(CFactorCacheTest, HitsAndMisses) {
+        CFactorCache cache;
+        EXPECT_FALSE(cache.find("a"));
+        EXPECT_THROW(cache.getKff("a"), std::runtime_error);
+        cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        EXPECT_TRUE(cache.contains("a"));
+        EXPECT_TRUE(cache.find("a"));
+        EXPECT_EQ(1, cache.getNHits());
+        EXPECT_EQ(1, cache.getNMisses());
+        EXPECT_FALSE(cache.isFactored("a"));
+        EXPECT_THROW(cache.getFactor("a"), std::runtime_error);
+        EXPECT_EQ(heat->getKff().getNNonZero(),
+                  cache.getKff("a").getNNonZero());
+        EXPECT_EQ(heat->getKee()(1, 0), cache.getKee("a")(1, 0));
+    }
+
+    TEST_F(CFactorCacheTest, Eviction) {
+        CFactorCache unbounded;
+        unbounded.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        size_t bytes = unbounded.getUsedBytes();
+
+        /*--- Room for a single entry, the least recently used is evicted. ---*/
+        CFactorCache cache = CFactorCache(bytes + bytes/2);
+        cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        cache.insert("b", heat->getKee(), heat->getKef(), heat->getKff());
+        EXPECT_EQ(1, cache.getNEntries());
+        EXPECT_EQ(1, cache.getNEvictions());
+        EXPECT_EQ(bytes, cache.getUsedBytes());
+        EXPECT_FALSE(cache.contains("a"));
+        EXPECT_TRUE(cache.find("b"));
+
+        /*--- The factor grows the entry, which is kept above the maximum. ---*/
+        std::vector<unsigned> order(heat->getKff().getRows());
+        for (unsigned i = 0; i < order.size(); i++) order[i] = i;
+        cache.insertFactor("b", CSparseCholesky<double>(heat->getKff(), order));
+        EXPECT_TRUE(cache.isFactored("b"));
+        EXPECT_GT(cache.getUsedBytes(), bytes);
+        EXPECT_EQ(1, cache.getNEntries());
+    }
+
+    TEST_F(CFactorCacheTest, DiskStorage) {
+        std::string dir = makeDir();
+        ASSERT_FALSE(dir.empty());
+        std::vector<unsigned> order(heat->getKff().getRows());
+        for (unsigned i = 0; i < order.size(); i++) order[i] = order.size() - 1 - i;
+        CSparseCholesky<double> chol = CSparseCholesky<double>(heat->getKff(),
+                                                               order);
+        {
+            CFactorCache cache = CFactorCache(1 << 20, dir);
+            cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+            cache.insertFactor("a", chol);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        /*--- A new cache finds the entry on disk. ---*/
+        CFactorCache cache = CFactorCache(1 << 20, dir);
+        EXPECT_FALSE(cache.contains("a"));
+        EXPECT_EQ(0, cache.getNEntries());
+        EXPECT_TRUE(cache.find("a"));
+        EXPECT_TRUE(cache.contains("a"));
+        EXPECT_EQ(1, cache.getNHits());
+        EXPECT_TRUE(cache.isFactored("a"));
+        const CMatrixSparse& Kef = cache.getKef("a");
+        EXPECT_EQ(heat->getKef().getNNonZero(), Kef.getNNonZero());
+        EXPECT_EQ(heat->getKef()(0, 1), Kef(0, 1));
+        CMatrix x = chol.solve(heat->getFf());
+        CMatrix y = cache.getFactor("a").solve(heat->getFf());
+        for (unsigned i = 0; i < x.getRows(); i++) {
+            EXPECT_EQ(x(i, 0), y(i, 0));
+        }
+        EXPECT_FALSE(cache.find("b"));
+
+        removeDir(dir);
+    }
+
+    TEST_F(CFactorCacheTest, CorruptedEntry) {
+        std::string dir = makeDir();
+        ASSERT_FALSE(dir.empty());
+        std::string path = dir + "/a.mtx";
+        {
+            CFactorCache cache = CFactorCache(1 << 20, dir);
+            cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        }
+
+        /*--- A truncated entry is a miss, and it is removed from disk. ---*/
+        if (rank == 0) {
+            EXPECT_EQ(0, truncate(path.c_str(), 16));
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        CFactorCache cache = CFactorCache(1 << 20, dir);
+        EXPECT_FALSE(cache.find("a"));
+        EXPECT_EQ(1, cache.getNMisses());
+        EXPECT_EQ(0, cache.getNEntries());
+        EXPECT_FALSE(std::ifstream(path.c_str()).good());
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        /*--- A column of Kef out of range is also a miss. ---*/
+        cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        if (rank == 0) {
+            unsigned nE = heat->getKee().getRows();
+            std::fstream file(path.c_str(), std::ios::in | std::ios::out |
+                                            std::ios::binary);
+            file.seekp(2*sizeof(unsigned) + nE*nE*sizeof(double) +
+                       (3 + nE + 1)*sizeof(unsigned));
+            unsigned col = 1000;
+            file.write(reinterpret_cast<const char*>(&col), sizeof(col));
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        CFactorCache other = CFactorCache(1 << 20, dir);
+        EXPECT_FALSE(other.find("a"));
+        EXPECT_FALSE(std::ifstream(path.c_str()).good());
+
+        removeDir(dir);
+    }
+
+    TEST_F(CFactorCacheTest, DiskEviction) {
+        std::string dir = makeDir();
+        ASSERT_FALSE(dir.empty());
+        std::string pathA = dir + "/a.mtx";
+        std::string pathB = dir + "/b.mtx";
+        {
+            CFactorCache cache = CFactorCache(1 << 20, dir);
+            cache.insert("a", heat->getKee(), heat->getKef(), heat->getKff());
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        std::ifstream fileA(pathA.c_str(), std::ios::binary | std::ios::ate);
+        size_t bytes = fileA.tellg();
+        fileA.close();
+
+        /*--- The directory only fits one entry, so the oldest one goes. The
+              files are removed by the rank that writes them. ---*/
+        CFactorCache cache = CFactorCache(bytes + bytes/2, dir);
+        cache.insert("b", heat->getKee(), heat->getKef(), heat->getKff());
+        MPI_Barrier(MPI_COMM_WORLD);
+        EXPECT_EQ(rank == 0 ? 1 : 0, cache.getNDiskEvictions());
+        EXPECT_FALSE(std::ifstream(pathA.c_str()).good());
+        EXPECT_TRUE(std::ifstream(pathB.c_str()).good());
+
+        removeDir(dir);
+    }
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixSparse.hpp"
+#include "../../include/CMatrixSparseSymmetric.hpp"
+#include "../../include/CSparseCholesky.hpp"
+#include "../../include/CLinearSystem.hpp"
+#include "../../include/CHeatConduction.hpp"
+
+namespace {
+    class CSparseCholeskyTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                CMatrixSparse K(size, size, rowPtr, colIdx, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    K.addEntry(i, i, 2.0);
+                    if (i > 0) K.addEntry(i, i - 1, 1.0);
+                    if (i < size - 1) K.addEntry(i, i + 1, 1.0);
+                }
+                A = new CMatrixSparseSymmetric(K.toSymmetricStorage());
+                b = new CMatrix(size, 1, 1.0);
+                order = std::vector<unsigned>({3, 0, 2, 1});
+            }
+            virtual void TearDown() {
+                delete A;
+                delete b;
+            }
+
+            CMatrixSparseSymmetric* A;
+            CMatrix* b;
+            std::vector<unsigned> order;
+    };
+
+    TEST_F(CSparseCholeskyTest, Solve) {
+        CSparseCholesky<double> chol = CSparseCholesky<double>(*A, order);
+        CMatrix x = chol.solve(*b);
+        EXPECT_NEAR(0.4, x(0, 0), 1e-12);
+        EXPECT_NEAR(0.2, x(1, 0), 1e-12);
+        EXPECT_NEAR(0.2, x(2, 0), 1e-12);
+        EXPECT_NEAR(0.4, x(3, 0), 1e-12);
+        CMatrix B = CMatrix(4, 2, 1.0);
+        B(0, 1) = 2.0;
+        CMatrix X = chol.solve(B);
+        EXPECT_NEAR(0.4, X(0, 0), 1e-12);
+        EXPECT_NEAR(0.2, X(1, 0), 1e-12);
+        EXPECT_NEAR(1.2, X(0, 1), 1e-12);
+        EXPECT_NEAR(-0.4, X(1, 1), 1e-12);
+        EXPECT_THROW(CSparseCholesky<double>(*A, std::vector<unsigned>({0, 0, 1, 2})),
+                     std::runtime_error);
+    }
+
+    TEST_F(CSparseCholeskyTest, SinglePrecisionRefinement) {
+        CSparseCholesky<float> chol = CSparseCholesky<float>(*A, order);
+        CMatrix x = chol.solve(*b);
+        EXPECT_NEAR(0.4, x(0, 0), 1e-6);
+        EXPECT_NEAR(0.2, x(1, 0), 1e-6);
+
+        /*--- The residual in double precision recovers the accuracy. ---*/
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(*A, *b);
+        x = sys.refinementSolve(chol);
+        EXPECT_NEAR(0.4, x(0, 0), 1e-12);
+        EXPECT_NEAR(0.2, x(1, 0), 1e-12);
+        EXPECT_NEAR(0.2, x(2, 0), 1e-12);
+        EXPECT_NEAR(0.4, x(3, 0), 1e-12);
+        EXPECT_LE(sys.getNIterations(), 3);
+    }
+
+    TEST_F(CSparseCholeskyTest, SymbolicReuse) {
+        CSparseCholesky<double> chol = CSparseCholesky<double>(*A, order);
+
+        /*--- New values with the same pattern reuse the symbolic phase. ---*/
+        CMatrixSparseSymmetric A2 = *A;
+        double* APtr = A2.getMtxAddress();
+        for (unsigned k = 0; k < A2.getNNonZero(); k++) {
+            APtr[k] *= 2.0;
+        }
+        chol.factorize(A2);
+        EXPECT_EQ(1, chol.getNAnalyses());
+        CMatrix x = chol.solve(*b);
+        EXPECT_NEAR(0.2, x(0, 0), 1e-12);
+        EXPECT_NEAR(0.1, x(1, 0), 1e-12);
+
+        CMatrixSparseSymmetric other;
+        EXPECT_THROW(chol.factorize(other), std::runtime_error);
+    }
+
+    TEST_F(CSparseCholeskyTest, DamagedStream) {
+        CSparseCholesky<double> chol = CSparseCholesky<double>(*A, order);
+        std::ostringstream out;
+        chol.write(out);
+        std::string data = out.str();
+        std::istringstream in(data);
+        CSparseCholesky<double> copy;
+        copy.read(in);
+        EXPECT_NEAR(0.4, copy.solve(*b)(0, 0), 1e-12);
+
+        /*--- Any size, pointer or index out of its range is rejected. Only
+              the entries of L, at the end of the stream, are not checked. ---*/
+        unsigned nWords = (data.size() -
+                           chol.getNNonZeroFactor()*sizeof(double)) /
+                          sizeof(unsigned);
+        for (unsigned w = 0; w < nWords; w++) {
+            std::string damaged = data;
+            unsigned value = 1000;
+            damaged.replace(w*sizeof(unsigned), sizeof(unsigned),
+                            reinterpret_cast<const char*>(&value),
+                            sizeof(unsigned));
+            std::istringstream damagedIn(damaged);
+            EXPECT_THROW(copy.read(damagedIn), std::runtime_error) << w;
+        }
+        std::istringstream truncated(data.substr(0, data.size() - 1));
+        EXPECT_THROW(copy.read(truncated), std::runtime_error);
+    }
+
+    TEST_F(CSparseCholeskyTest, NestedDissection) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(30, 30, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction cg = CHeatConduction(bnd, con, msh, "ic0");
+        CHeatConduction heat = CHeatConduction(bnd, con, msh, "none",
+                                               "cholesky");
+        CMatrix Tcg = cg.getTemp();
+        CMatrix T = heat.getTemp();
+        for (unsigned i = 0; i < T.getRows(); i++) {
+            EXPECT_NEAR(Tcg(i, 0), T(i, 0), 1e-8);
+        }
+
+        /*--- Nested dissection of the nodes is a permutation with less fill
+              than the numbering of the mesh. ---*/
+        std::vector<unsigned> nodes = msh.nestedDissection();
+        std::vector<bool> found(msh.getNNode(), false);
+        for (unsigned k = 0; k < nodes.size(); k++) {
+            found[nodes[k]] = true;
+        }
+        EXPECT_EQ(msh.getNNode(), nodes.size());
+        EXPECT_EQ(std::vector<bool>(msh.getNNode(), true), found);
+
+        CMatrixSparseSymmetric K = con.getConducMtx().toSymmetricStorage();
+        std::vector<unsigned> natural(msh.getNNode());
+        for (unsigned k = 0; k < natural.size(); k++) {
+            natural[k] = k;
+        }
+        CSparseCholesky<double> nd = CSparseCholesky<double>();
+        CSparseCholesky<double> band = CSparseCholesky<double>();
+        nd.analyze(K, nodes);
+        band.analyze(K, natural);
+        EXPECT_LT(nd.getNNonZeroFactor(), band.getNNonZeroFactor());
+    }
+}
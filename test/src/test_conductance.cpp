@@ -1,8 +1,14 @@
 #include <cmath>
+#include <string>
+#include <vector>
+#include <stdexcept>
 
 #include "gtest/gtest.h"
 #include "../../include/CConductance.hpp"
+#include "../../include/CConductanceKernel.hpp"
+#include "../../include/CMatrixFixed.hpp"
 #include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixSparse.hpp"
 
 namespace {
     class CConductanceTest : public ::testing::Test {};
@@ -37,7 +43,8 @@ namespace {
         CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
         CMesh msh = CMesh(2, 1, geo);
         CConductance con = CConductance(geo, mat, msh);
-        CMatrix K = con.getConducMtx();
+        CMatrixSparse K = con.getConducMtx();
+        EXPECT_EQ(28, K.getNNonZero());
         EXPECT_NEAR(35.8853, K(0, 0), 0.0001);
         EXPECT_NEAR(-22.6561, K(0, 1), 0.0001);
         EXPECT_NEAR(7.3927, K(0, 2), 0.0001);
@@ -60,4 +67,133 @@ namespace {
         EXPECT_NEAR(-15.7639, K(4, 5), 0.0001);
         EXPECT_NEAR(31.4931, K(5, 5), 0.0001);
     }
+
+    TEST_F(CConductanceTest, BatchedKernel) {
+        CConductance con;
+        const CShapeFunctions& shape = CShapeFunctions::getTable(2);
+        const unsigned S = CConductanceKernel::batchSize;
+        CMatrixFixed<2, 2> D;
+        D(0, 0) = 250.0;
+        D(0, 1) = 20.0;
+        D(1, 0) = 20.0;
+        D(1, 1) = 180.0;
+
+        /*--- Distorted quadrilaterals, different in every lane. ---*/
+        std::vector<double> eCoord(8*S);
+        std::vector<CMatrixFixed<4, 2> > coords(S);
+        for (unsigned l = 0; l < S; l++) {
+            double xs[4] = {0.0, 1.0 + 0.1*l, 1.2, -0.1*l};
+            double ys[4] = {0.0, 0.05*l, 0.9 + 0.02*l, 1.0};
+            for (unsigned a = 0; a < 4; a++) {
+                coords[l](a, 0) = xs[a];
+                coords[l](a, 1) = ys[a];
+                eCoord[a*S+l] = xs[a];
+                eCoord[(4+a)*S+l] = ys[a];
+            }
+        }
+
+        std::string best = CConductanceKernel::getInstructionSet();
+        const char* isas[3] = {"scalar", "avx2", "avx512"};
+        for (unsigned n = 0; n < 3; n++) {
+            if (!CConductanceKernel::isSupported(isas[n])) continue;
+            CConductanceKernel::setInstructionSet(isas[n]);
+            std::vector<double> Ke(16*S, 0.0);
+            CConductanceKernel::compute(shape, eCoord.data(), D, 0.2, Ke.data());
+            for (unsigned l = 0; l < S; l++) {
+                CMatrixFixed<4, 4> KeRef;
+                con.elementConductance(coords[l], D, 0.2, KeRef);
+                for (unsigned j = 0; j < 4; j++) {
+                    for (unsigned i = 0; i < 4; i++) {
+                        EXPECT_NEAR(KeRef(i, j), Ke[(j*4+i)*S+l], 1e-10);
+                    }
+                }
+            }
+        }
+        CConductanceKernel::setInstructionSet(best);
+        EXPECT_THROW(CConductanceKernel::setInstructionSet("sse"),
+                     std::runtime_error);
+    }
+
+    TEST_F(CConductanceTest, ElementClasses) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry rect = CGeometry(0.0, 1.0, 1.0, 2.0, 0.2);
+        CMesh rectMsh = CMesh(12, 6, rect);
+        CConductance rectCon = CConductance(rect, mat, rectMsh);
+        EXPECT_EQ(1, rectCon.getNElemClasses());
+
+        /*--- In a tapered plate the elements of a column are sheared
+              differently, so every element has its own geometry. ---*/
+        CGeometry taper = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh taperMsh = CMesh(5, 4, taper);
+        CConductance taperCon = CConductance(taper, mat, taperMsh);
+        EXPECT_EQ(20, taperCon.getNElemClasses());
+    }
+
+    TEST_F(CConductanceTest, QuadraticElements) {
+        CMaterial mat = CMaterial(250.0, 20.0, 180.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMatrixFixed<2, 2> D;
+        D(0, 0) = 250.0;
+        D(0, 1) = 20.0;
+        D(1, 0) = 20.0;
+        D(1, 1) = 180.0;
+        unsigned nodes[2] = {8, 9};
+        for (unsigned m = 0; m < 2; m++) {
+            CMesh msh = CMesh(3, 2, geo, nodes[m]);
+            CConductance con = CConductance(geo, mat, msh);
+            EXPECT_EQ(3, con.getGaussOrder());
+            EXPECT_EQ(4, CConductance(geo, mat, msh, false, 4).getGaussOrder());
+            const CMatrixSparse& K = con.getConducMtx();
+            const CMatrixIndex& conn = msh.getConnMtx();
+            const CMatrix& coor = msh.getCoorMtx();
+
+            /*--- Assembly of the scalar elemental matrices, which has to
+                  match the batched kernel. ---*/
+            CMatrix KRef = CMatrix(msh.getNNode(), msh.getNNode(), 0.0);
+            for (unsigned e = 0; e < msh.getNElem(); e++) {
+                if (nodes[m] == 8) {
+                    CMatrixFixed<8, 2> eCoord;
+                    CMatrixFixed<8, 8> Ke;
+                    for (unsigned a = 0; a < 8; a++) {
+                        eCoord(a, 0) = coor(conn(e, a + 1), 0);
+                        eCoord(a, 1) = coor(conn(e, a + 1), 1);
+                    }
+                    con.elementConductance(eCoord, D, 0.2, Ke);
+                    for (unsigned a = 0; a < 8; a++) {
+                        for (unsigned b = 0; b < 8; b++) {
+                            KRef(conn(e, a + 1), conn(e, b + 1)) += Ke(a, b);
+                        }
+                    }
+                } else {
+                    CMatrixFixed<9, 2> eCoord;
+                    CMatrixFixed<9, 9> Ke;
+                    for (unsigned a = 0; a < 9; a++) {
+                        eCoord(a, 0) = coor(conn(e, a + 1), 0);
+                        eCoord(a, 1) = coor(conn(e, a + 1), 1);
+                    }
+                    con.elementConductance(eCoord, D, 0.2, Ke);
+                    for (unsigned a = 0; a < 9; a++) {
+                        for (unsigned b = 0; b < 9; b++) {
+                            KRef(conn(e, a + 1), conn(e, b + 1)) += Ke(a, b);
+                        }
+                    }
+                }
+            }
+            for (unsigned i = 0; i < msh.getNNode(); i++) {
+                double rowSum = 0.0;
+                for (unsigned j = 0; j < msh.getNNode(); j++) {
+                    EXPECT_NEAR(KRef(i, j), K(i, j), 1e-9);
+                    rowSum += K(i, j);
+                }
+                EXPECT_NEAR(0.0, rowSum, 1e-9);
+            }
+        }
+
+        CMatrixFixed<4, 2> eCoord;
+        CMatrixFixed<4, 4> Ke;
+        CMesh q9 = CMesh(1, 1, geo, 9);
+        EXPECT_THROW(CConductance(geo, mat, q9).elementConductance(eCoord, D,
+                                                                   0.2, Ke),
+                     std::runtime_error);
+    }
 }
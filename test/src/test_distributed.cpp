@@ -0,0 +1,137 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <mpi.h>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixSparse.hpp"
+#include "../../include/CMatrixSparseSymmetric.hpp"
+#include "../../include/CMatrixDistributed.hpp"
+
+namespace {
+    class CMatrixDistributedTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                CMatrixSparse A(size, size, rowPtr, colIdx, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    A.addEntry(i, i, 2.0 + i);
+                    if (i > 0) A.addEntry(i, i - 1, -1.0);
+                    if (i < size - 1) A.addEntry(i, i + 1, -1.0);
+                }
+                ASym = new CMatrixSparseSymmetric(A.toSymmetricStorage());
+                x = new CMatrix(size, 1, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    (*x)(i, 0) = 1.0 + i;
+                }
+            }
+            virtual void TearDown() {
+                delete ASym;
+                delete x;
+            }
+
+            CMatrixSparseSymmetric* ASym;
+            CMatrix* x;
+    };
+
+    TEST_F(CMatrixDistributedTest, DefaultConstructor) {
+        CMatrixDistributed mat;
+        EXPECT_EQ(0, mat.getRows());
+        EXPECT_EQ(0, mat.getGlobalRows());
+        EXPECT_EQ(0, mat.getNGhosts());
+    }
+
+    TEST_F(CMatrixDistributedTest, SingleRank) {
+        CMatrixDistributed A(*ASym);
+        EXPECT_EQ(4, A.getRows());
+        EXPECT_EQ(4, A.getCols());
+        EXPECT_EQ(4, A.getGlobalRows());
+        EXPECT_EQ(0, A.getFirstRow());
+        EXPECT_EQ(0, A.getNGhosts());
+        EXPECT_EQ(0, A.getNNeighbours());
+
+        CMatrixSparseSymmetric D = A.getDiagonalBlock();
+        EXPECT_EQ(ASym->getNNonZero(), D.getNNonZero());
+        EXPECT_EQ(4.0, D(2, 2));
+        EXPECT_EQ(-1.0, D(2, 3));
+    }
+
+    TEST_F(CMatrixDistributedTest, Product) {
+        CMatrixDistributed A(*ASym);
+        CMatrix xLoc = A.getLocalVector(*x);
+        CMatrix yLoc = CMatrix(A.getRows(), 1, 1.0);
+        A.multiply(xLoc.getMtxAddress(), yLoc.getMtxAddress(), 2.0, 1.0);
+        CMatrix y = A.gatherVector(yLoc);
+        EXPECT_EQ(2.0*0.0 + 1.0, y(0, 0));
+        EXPECT_EQ(2.0*2.0 + 1.0, y(1, 0));
+        EXPECT_EQ(2.0*6.0 + 1.0, y(2, 0));
+        EXPECT_EQ(2.0*17.0 + 1.0, y(3, 0));
+    }
+
+    TEST_F(CMatrixDistributedTest, GivenOffsets) {
+        /*--- One row for every rank but the last one, which takes the
+              rest. ---*/
+        int rank;
+        int nRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+        std::vector<unsigned> offsets(nRanks + 1, 4);
+        for (int r = 0; r < nRanks; r++) {
+            offsets[r] = std::min(r, 4);
+        }
+        CMatrixDistributed A(*ASym, offsets);
+        EXPECT_EQ(offsets[rank + 1] - offsets[rank], A.getRows());
+        EXPECT_EQ(offsets[rank], A.getFirstRow());
+        CMatrix xLoc = A.getLocalVector(*x);
+        CMatrix yLoc = CMatrix(A.getRows(), 1, 0.0);
+        A.multiply(xLoc.getMtxAddress(), yLoc.getMtxAddress(), 1.0, 0.0);
+        CMatrix y = A.gatherVector(yLoc);
+        EXPECT_EQ(0.0, y(0, 0));
+        EXPECT_EQ(2.0, y(1, 0));
+        EXPECT_EQ(6.0, y(2, 0));
+        EXPECT_EQ(17.0, y(3, 0));
+    }
+
+    TEST_F(CMatrixDistributedTest, OwnedRows) {
+        /*--- Every rank only gives the lower triangle of its rows. ---*/
+        int rank;
+        int nRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+        std::vector<unsigned> offsets(nRanks + 1);
+        for (int r = 0; r <= nRanks; r++) {
+            offsets[r] = 4 * r / nRanks;
+        }
+        unsigned first = offsets[rank];
+        unsigned nRows = offsets[rank + 1] - first;
+        unsigned* aRowPtr = ASym->getRowPtrAddress();
+        std::vector<unsigned> rowPtr(nRows + 1, 0);
+        for (unsigned i = 0; i < nRows; i++) {
+            rowPtr[i + 1] = aRowPtr[first + i + 1] - aRowPtr[first];
+        }
+        CMatrixSparse lower(nRows, 4, rowPtr.data(),
+                            ASym->getColIdxAddress() + aRowPtr[first], 0.0);
+        for (unsigned i = 0; i < nRows; i++) {
+            for (unsigned j = 0; j <= first + i; j++) {
+                if ((*ASym)(first + i, j) != 0.0)
+                    lower.addEntry(i, j, (*ASym)(first + i, j));
+            }
+        }
+
+        CMatrixDistributed A(lower, offsets);
+        CMatrixDistributed B(*ASym, offsets);
+        EXPECT_EQ(B.getNGhosts(), A.getNGhosts());
+        EXPECT_EQ(B.getNNeighbours(), A.getNNeighbours());
+        CMatrix xLoc = A.getLocalVector(*x);
+        CMatrix yLoc = CMatrix(A.getRows(), 1, 0.0);
+        A.multiply(xLoc.getMtxAddress(), yLoc.getMtxAddress(), 1.0, 0.0);
+        CMatrix y = A.gatherVector(yLoc);
+        EXPECT_EQ(0.0, y(0, 0));
+        EXPECT_EQ(2.0, y(1, 0));
+        EXPECT_EQ(6.0, y(2, 0));
+        EXPECT_EQ(17.0, y(3, 0));
+    }
+}
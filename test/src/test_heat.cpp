@@ -1,4 +1,7 @@
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <mpi.h>
 
 #include "gtest/gtest.h"
 #include "../../include/CHeatConduction.hpp"
@@ -41,7 +44,7 @@ namespace {
         EXPECT_NEAR(-22.6561, Kee(1, 0), 0.0001);
         EXPECT_NEAR(35.8853, Kee(1, 1), 0.0001);
 
-        CMatrix Kff = heat.getKff();
+        CMatrixSparseSymmetric Kff = heat.getKff();
         EXPECT_NEAR(92.7492, Kff(0, 0), 0.0001);
         EXPECT_NEAR(-63.7909, Kff(0, 1), 0.0001);
         EXPECT_NEAR(3.6809, Kff(0, 2), 0.0001);
@@ -59,7 +62,7 @@ namespace {
         EXPECT_NEAR(-15.7639, Kff(3, 2), 0.0001);
         EXPECT_NEAR(31.4931, Kff(3, 3), 0.0001);
 
-        CMatrix Kef = heat.getKef();
+        CMatrixSparse Kef = heat.getKef();
         EXPECT_NEAR(7.3927, Kef(0, 0), 0.0001);
         EXPECT_NEAR(-20.6219, Kef(0, 1), 0.0001);
         EXPECT_NEAR(0.0, Kef(0, 2), 0.0001);
@@ -105,4 +108,309 @@ namespace {
         EXPECT_NEAR(770.8622, F(4, 0), 0.0001);
         EXPECT_NEAR(0.0, F(5, 0), 0.0001);
     }
+
+    TEST_F(CHeatConductionTest, DirectSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        unsigned nX[2] = {12, 3};
+        unsigned nY[2] = {4, 10};
+        for (unsigned m = 0; m < 2; m++) {
+            CMesh msh = CMesh(nX[m], nY[m], geo);
+            CConductance con = CConductance(geo, mat, msh);
+            CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                          "left", -20.0,
+                                                          msh, geo);
+            CHeatConduction cg = CHeatConduction(bnd, con, msh, "ic0");
+            CHeatConduction direct = CHeatConduction(bnd, con, msh, "none",
+                                                     "direct");
+
+            /*--- The band follows the shorter side of the mesh. ---*/
+            EXPECT_LE(direct.getHalfBandwidth(), std::min(nX[m], nY[m]) + 2);
+            CMatrix Tcg = cg.getTemp();
+            CMatrix T = direct.getTemp();
+            for (unsigned i = 0; i < T.getRows(); i++) {
+                EXPECT_NEAR(Tcg(i, 0), T(i, 0), 1e-8);
+            }
+        }
+    }
+
+    TEST_F(CHeatConductionTest, MixedPrecisionSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction chol = CHeatConduction(bnd, con, msh, "none",
+                                               "cholesky");
+        CHeatConduction mixed = CHeatConduction(bnd, con, msh, "none",
+                                                "mixed");
+        EXPECT_GE(mixed.getNIterations(), 1);
+        EXPECT_LE(mixed.getNIterations(), 5);
+        for (unsigned i = 0; i < chol.getTemp().getRows(); i++) {
+            EXPECT_NEAR(chol.getTemp()(i, 0), mixed.getTemp()(i, 0), 1e-8);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, MatrixFreeSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CConductance conFree = CConductance(geo, mat, msh, false);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction cg = CHeatConduction(bnd, con, msh);
+        CHeatConduction free = CHeatConduction(bnd, conFree, msh, "none",
+                                               "matrix-free");
+        EXPECT_EQ(0, conFree.getConducMtx().getNNonZero());
+        EXPECT_EQ(cg.getNIterations(), free.getNIterations());
+        CMatrix T = cg.getTemp();
+        CMatrix TFree = free.getTemp();
+        CMatrix F = cg.getFlux();
+        CMatrix FFree = free.getFlux();
+        for (unsigned i = 0; i < T.getRows(); i++) {
+            EXPECT_NEAR(T(i, 0), TFree(i, 0), 1e-8);
+            EXPECT_NEAR(F(i, 0), FFree(i, 0), 1e-6);
+        }
+        EXPECT_THROW(CHeatConduction(bnd, conFree, msh, "jacobi", "matrix-free"),
+                     std::runtime_error);
+    }
+
+    TEST_F(CHeatConductionTest, DistributedSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        std::string precond[2] = {"none", "jacobi"};
+        for (unsigned m = 0; m < 2; m++) {
+            CHeatConduction cg = CHeatConduction(bnd, con, msh, precond[m]);
+            CHeatConduction dist = CHeatConduction(bnd, con, msh, precond[m],
+                                                   "distributed");
+            EXPECT_EQ(cg.getNIterations(), dist.getNIterations());
+            for (unsigned i = 0; i < cg.getTemp().getRows(); i++) {
+                EXPECT_NEAR(cg.getTemp()(i, 0), dist.getTemp()(i, 0), 1e-8);
+            }
+        }
+        EXPECT_THROW(CHeatConduction(bnd, con, msh, "amg", "distributed"),
+                     std::runtime_error);
+    }
+
+    TEST_F(CHeatConductionTest, PipelinedSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction cg = CHeatConduction(bnd, con, msh, "ic0");
+        CHeatConduction pipe = CHeatConduction(bnd, con, msh, "ic0", "cg", "V",
+                                               "pipelined");
+        EXPECT_NEAR(cg.getNIterations(), pipe.getNIterations(), 1);
+        EXPECT_EQ(4, pipe.getIterationTimes().size());
+        for (unsigned i = 0; i < cg.getTemp().getRows(); i++) {
+            EXPECT_NEAR(cg.getTemp()(i, 0), pipe.getTemp()(i, 0), 1e-8);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, PipelinedIterations) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(80, 40, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+
+        /*--- The residual replacement keeps the convergence of the classic
+              variant. ---*/
+        std::string precond[2] = {"none", "ic0"};
+        for (unsigned m = 0; m < 2; m++) {
+            CHeatConduction cg = CHeatConduction(bnd, con, msh, precond[m]);
+            CHeatConduction pipe = CHeatConduction(bnd, con, msh, precond[m],
+                                                   "cg", "V", "pipelined");
+            EXPECT_LE(pipe.getNIterations(), cg.getNIterations() + 10);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, SStepSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction cg = CHeatConduction(bnd, con, msh, "ic0");
+        CHeatConduction sStep = CHeatConduction(bnd, con, msh, "ic0", "cg",
+                                                "V", "s-step", 4, "newton");
+        EXPECT_LE(sStep.getNIterations(), 2*cg.getNIterations());
+        EXPECT_EQ(4, sStep.getIterationTimes().size());
+        for (unsigned i = 0; i < cg.getTemp().getRows(); i++) {
+            EXPECT_NEAR(cg.getTemp()(i, 0), sStep.getTemp()(i, 0), 1e-6);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, CachedSolution) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(12, 8, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CBoundaryConditions other = CBoundaryConditions("bottom", -2500.0,
+                                                        "left", 40.0, msh, geo);
+        CFactorCache cache;
+        std::string key = CFactorCache::computeKey(geo, mat, msh, bnd);
+        EXPECT_FALSE(cache.find(key));
+        CHeatConduction first = CHeatConduction(bnd, con, msh, "none",
+                                                "cholesky", "V", "classic", 4,
+                                                "newton", &cache, key);
+        EXPECT_EQ(0, cache.getNHits());
+        EXPECT_TRUE(cache.isFactored(key));
+
+        /*--- Only the BC values change, so nothing is assembled. ---*/
+        EXPECT_TRUE(cache.find(key));
+        CHeatConduction second = CHeatConduction(other, CConductance(), msh,
+                                                 "none", "cholesky", "V",
+                                                 "classic", 4, "newton",
+                                                 &cache, key);
+        CHeatConduction ref = CHeatConduction(other, con, msh, "none",
+                                              "cholesky");
+        EXPECT_EQ(1, cache.getNHits());
+        EXPECT_EQ(1, cache.getNMisses());
+        for (unsigned i = 0; i < ref.getTemp().getRows(); i++) {
+            EXPECT_NEAR(ref.getTemp()(i, 0), second.getTemp()(i, 0), 1e-10);
+            EXPECT_NEAR(ref.getFlux()(i, 0), second.getFlux()(i, 0), 1e-8);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, SStepIterations) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(80, 40, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        std::string precond[2] = {"none", "ic0"};
+        for (unsigned m = 0; m < 2; m++) {
+            CHeatConduction cg = CHeatConduction(bnd, con, msh, precond[m]);
+            CHeatConduction sStep = CHeatConduction(bnd, con, msh, precond[m],
+                                                    "cg", "V", "s-step", 4,
+                                                    "newton");
+            EXPECT_LE(sStep.getNIterations(), cg.getNIterations() + 10);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, ReducedAssembly) {
+        CMaterial mat = CMaterial(250.0, 30.0, 180.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(9, 6, geo);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CConductance conRed = CConductance(geo, mat, msh, bnd);
+        EXPECT_FALSE(con.isReduced());
+        EXPECT_TRUE(conRed.isReduced());
+        EXPECT_EQ(0, conRed.getConducMtx().getNNonZero());
+        EXPECT_FALSE(conRed.isDistributed());
+
+        /*--- Every rank only keeps its owned rows of Kff, which are the
+              same as in the gathered Kff. ---*/
+        int rank;
+        int nRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+        CConductance conDist = CConductance(geo, mat, msh, bnd, 0, true);
+        EXPECT_TRUE(conDist.isDistributed());
+        EXPECT_EQ(0, conDist.getConducFF().getNNonZero());
+        const std::vector<unsigned>& offsets = conDist.getConducFFOffsets();
+        ASSERT_EQ(nRanks + 1, offsets.size());
+        EXPECT_EQ(0, offsets[0]);
+        EXPECT_EQ(bnd.getNReducedDof(), offsets[nRanks]);
+        const CMatrixSparse& rows = conDist.getConducFFRows();
+        const CMatrixSparseSymmetric& KffAll = conRed.getConducFF();
+        ASSERT_EQ(offsets[rank + 1] - offsets[rank], rows.getRows());
+        for (unsigned i = 0; i < rows.getRows(); i++) {
+            unsigned row = offsets[rank] + i;
+            EXPECT_EQ(KffAll.getRowPtrAddress()[row + 1] -
+                      KffAll.getRowPtrAddress()[row],
+                      rows.getRowPtrAddress()[i + 1] -
+                      rows.getRowPtrAddress()[i]);
+            for (unsigned j = 0; j <= row; j++) {
+                EXPECT_NEAR(KffAll(row, j), rows(i, j), 1e-10);
+            }
+        }
+
+        CHeatConduction heat = CHeatConduction(bnd, con, msh);
+        CHeatConduction heatRed = CHeatConduction(bnd, conRed, msh);
+        const CMatrixSparseSymmetric& Kff = heat.getKff();
+        const CMatrixSparseSymmetric& KffRed = heatRed.getKff();
+        const CMatrixSparse& Kef = heat.getKef();
+        const CMatrixSparse& KefRed = heatRed.getKef();
+        ASSERT_EQ(Kff.getNNonZero(), KffRed.getNNonZero());
+        ASSERT_EQ(Kef.getNNonZero(), KefRed.getNNonZero());
+        for (unsigned i = 0; i < Kff.getRows(); i++) {
+            for (unsigned j = 0; j <= i; j++) {
+                EXPECT_NEAR(Kff(i, j), KffRed(i, j), 1e-10);
+            }
+        }
+        for (unsigned i = 0; i < Kef.getRows(); i++) {
+            for (unsigned j = 0; j < Kef.getCols(); j++) {
+                EXPECT_NEAR(Kef(i, j), KefRed(i, j), 1e-10);
+            }
+            for (unsigned j = 0; j < Kef.getRows(); j++) {
+                EXPECT_NEAR(heat.getKee()(i, j), heatRed.getKee()(i, j), 1e-10);
+            }
+        }
+        EXPECT_EQ(heat.getNIterations(), heatRed.getNIterations());
+        for (unsigned i = 0; i < heat.getTemp().getRows(); i++) {
+            EXPECT_NEAR(heat.getTemp()(i, 0), heatRed.getTemp()(i, 0), 1e-8);
+        }
+    }
+
+    TEST_F(CHeatConductionTest, QuadraticElements) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.0, 1.0, 1.0, 2.0, 0.2);
+        CGeometry taper = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        unsigned nodes[2] = {8, 9};
+        for (unsigned m = 0; m < 2; m++) {
+            /*--- The temperature is linear in x, which both elements
+                  reproduce exactly. ---*/
+            CMesh msh = CMesh(6, 3, geo, nodes[m]);
+            CConductance con = CConductance(geo, mat, msh);
+            CBoundaryConditions bnd = CBoundaryConditions("right", 2500.0,
+                                                          "left", 10.0,
+                                                          msh, geo);
+            CHeatConduction heat = CHeatConduction(bnd, con, msh, "ic0");
+            const CMatrix& coor = msh.getCoorMtx();
+            for (unsigned i = 0; i < msh.getNNode(); i++) {
+                EXPECT_NEAR(-2500.0 * coor(i, 0) / 250.0 + 10.0,
+                            heat.getTemp()(i, 0), 1e-8);
+            }
+
+            /*--- On a tapered plate the curved edges give the same solution
+                  with every solver. ---*/
+            CMesh tMsh = CMesh(6, 4, taper, nodes[m]);
+            CBoundaryConditions tBnd = CBoundaryConditions("bottom", -5000.0,
+                                                           "left", -20.0,
+                                                           tMsh, taper);
+            CConductance tCon = CConductance(taper, mat, tMsh, tBnd);
+            CConductance tFree = CConductance(taper, mat, tMsh, false);
+            CHeatConduction cg = CHeatConduction(tBnd, tCon, tMsh, "ic0");
+            CHeatConduction chol = CHeatConduction(tBnd, tCon, tMsh, "none",
+                                                   "cholesky");
+            CHeatConduction direct = CHeatConduction(tBnd, tCon, tMsh, "none",
+                                                     "direct");
+            CHeatConduction free = CHeatConduction(tBnd, tFree, tMsh, "none",
+                                                   "matrix-free");
+            for (unsigned i = 0; i < tMsh.getNNode(); i++) {
+                EXPECT_NEAR(chol.getTemp()(i, 0), cg.getTemp()(i, 0), 1e-8);
+                EXPECT_NEAR(chol.getTemp()(i, 0), direct.getTemp()(i, 0), 1e-8);
+                EXPECT_NEAR(chol.getTemp()(i, 0), free.getTemp()(i, 0), 1e-8);
+            }
+            EXPECT_THROW(CHeatConduction(tBnd, tCon, tMsh, "multigrid"),
+                         std::runtime_error);
+        }
+    }
 }
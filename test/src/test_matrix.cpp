@@ -1,4 +1,5 @@
 #include <iostream>
+#include <utility>
 
 #include "gtest/gtest.h"
 #include "../../include/CMatrix.hpp"
@@ -82,6 +83,56 @@ namespace {
         }
     }
 
+    TEST_F(CMatrixTest, MoveOperators) {
+        CMatrix matOne(*B);
+        double* entries = matOne.getMtxAddress();
+        CMatrix matTwo(std::move(matOne));
+        EXPECT_EQ(entries, matTwo.getMtxAddress());
+        EXPECT_EQ(0, matOne.getRows());
+        EXPECT_EQ(0, matOne.getCols());
+        CMatrix matThree;
+        matThree = std::move(matTwo);
+        EXPECT_EQ(entries, matThree.getMtxAddress());
+        EXPECT_EQ(4, matThree.getRows());
+        EXPECT_EQ(1.0, matThree(3, 3));
+
+        /*--- Copies between matrices of the same size reuse the memory. ---*/
+        matThree = (*C);
+        EXPECT_EQ(entries, matThree.getMtxAddress());
+        EXPECT_EQ(3.0, matThree(2, 1));
+    }
+
+    TEST_F(CMatrixTest, InPlaceOperators) {
+        double* entries = A->getMtxAddress();
+        (*A) += (*B);
+        (*A) -= (*C);
+        (*A) *= 2.0;
+        EXPECT_EQ(entries, A->getMtxAddress());
+        EXPECT_EQ(0.0, (*A)(1, 2));
+
+        CMatrix mat(4, 1, 0.0);
+        entries = mat.getMtxAddress();
+        mat.setProduct(*B, *F, 0.5);
+        EXPECT_EQ(entries, mat.getMtxAddress());
+        EXPECT_EQ(8.0, mat(3, 0));
+        mat.setProduct(*B, mat);
+        EXPECT_EQ(32.0, mat(0, 0));
+
+        CMatrix prod(1, 1, 1.0);
+        prod.addTransposeProduct(*E, *F, 2.0);
+        EXPECT_EQ(33.0, prod(0, 0));
+
+        CMatrix J(2, 2, 0.0);
+        CMatrix inv(2, 2, 0.0);
+        J(0, 0) = 2.0;
+        J(1, 1) = 4.0;
+        entries = inv.getMtxAddress();
+        J.inverse(inv);
+        EXPECT_EQ(entries, inv.getMtxAddress());
+        EXPECT_NEAR(0.5, inv(0, 0), 1e-12);
+        EXPECT_NEAR(0.25, inv(1, 1), 1e-12);
+    }
+
     TEST_F(CMatrixTest, Transpose) {
         unsigned size = 4;
         CMatrix mat(size, size, 0.0);
@@ -135,6 +186,23 @@ namespace {
     // //     EXPECT_TRUE(matDbl.isLowerTriangular());
     // // }
 
+    TEST_F(CMatrixTest, ToSymmetricStorage) {
+        unsigned size = 4;
+        CMatrix mat(size, size, 0.0);
+        for (unsigned j = 0; j < size; j++) {
+            for (unsigned i = 0; i < size; i++) {
+                mat(i, j) = double(i + j + i*j);
+            }
+        }
+        CMatrixSymmetric sym = mat.toSymmetricStorage();
+        EXPECT_EQ(10, sym.getNEntries());
+        for (unsigned j = 0; j < size; j++) {
+            for (unsigned i = 0; i < size; i++) {
+                EXPECT_EQ(mat(i, j), sym(i, j));
+            }
+        }
+    }
+
     TEST_F(CMatrixTest, AccessOperator) {
         unsigned size = 4;
         CMatrix mat = CMatrix(size, size, 0.0);
@@ -0,0 +1,77 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrixFixed.hpp"
+
+namespace {
+    class CMatrixFixedTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                A(0, 0) = 4.0;
+                A(0, 1) = 7.0;
+                A(1, 0) = 2.0;
+                A(1, 1) = 6.0;
+                B(0, 0) = 2.0;
+                B(0, 1) = 0.0;
+                B(0, 2) = 1.0;
+                B(1, 0) = 1.0;
+                B(1, 1) = 3.0;
+                B(1, 2) = 0.0;
+                B(2, 0) = 0.0;
+                B(2, 1) = 1.0;
+                B(2, 2) = 4.0;
+            }
+
+            CMatrixFixed<2, 2> A;
+            CMatrixFixed<3, 3> B;
+    };
+
+    TEST_F(CMatrixFixedTest, Constructors) {
+        CMatrixFixed<2, 3> zero;
+        CMatrixFixed<2, 3> ones(1.0);
+        EXPECT_EQ(2, zero.getRows());
+        EXPECT_EQ(3, zero.getCols());
+        EXPECT_EQ(0.0, zero(1, 2));
+        EXPECT_EQ(1.0, ones(1, 2));
+        EXPECT_EQ(&ones(0, 0), ones.getMtxAddress());
+        EXPECT_EQ(&ones(1, 0), ones.getMtxAddress() + 1);
+    }
+
+    TEST_F(CMatrixFixedTest, Arithmetic) {
+        CMatrixFixed<2, 2> C = A + A;
+        EXPECT_EQ(8.0, C(0, 0));
+        C = C - A;
+        EXPECT_EQ(7.0, C(0, 1));
+        C += A;
+        C *= 0.5;
+        EXPECT_EQ(6.0, C(1, 1));
+        C = A * 2.0;
+        EXPECT_EQ(4.0, C(1, 0));
+        CMatrixFixed<3, 2> T = B.transpose() * CMatrixFixed<3, 2>(1.0);
+        EXPECT_EQ(3.0, T(0, 0));
+        EXPECT_EQ(4.0, T(1, 1));
+        EXPECT_EQ(5.0, T(2, 0));
+        CMatrixFixed<2, 1> x(1.0);
+        CMatrixFixed<2, 1> y = A * x;
+        EXPECT_EQ(11.0, y(0, 0));
+        EXPECT_EQ(8.0, y(1, 0));
+    }
+
+    TEST_F(CMatrixFixedTest, DeterminantAndInverse) {
+        EXPECT_EQ(10.0, A.determinant());
+        EXPECT_EQ(25.0, B.determinant());
+        EXPECT_EQ(0.5, (CMatrixFixed<1, 1>(2.0).inverse()(0, 0)));
+        CMatrixFixed<2, 2> IA = A * A.inverse();
+        CMatrixFixed<3, 3> IB = B.inverse() * B;
+        for (unsigned i = 0; i < 2; i++) {
+            for (unsigned j = 0; j < 2; j++) {
+                EXPECT_NEAR(i == j ? 1.0 : 0.0, IA(i, j), 1e-15);
+            }
+        }
+        for (unsigned i = 0; i < 3; i++) {
+            for (unsigned j = 0; j < 3; j++) {
+                EXPECT_NEAR(i == j ? 1.0 : 0.0, IB(i, j), 1e-15);
+            }
+        }
+    }
+}
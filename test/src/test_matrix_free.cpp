@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixFree.hpp"
+#include "../../include/CHeatConduction.hpp"
+
+namespace {
+    class CMatrixFreeTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                mat = new CMaterial(250.0, 20.0, 150.0);
+                geo = new CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+                msh = new CMesh(6, 4, *geo);
+                con = new CConductance(*geo, *mat, *msh);
+                bnd = new CBoundaryConditions("bottom", -5000.0, "left", -20.0,
+                                              *msh, *geo);
+            }
+            virtual void TearDown() {
+                delete mat;
+                delete geo;
+                delete msh;
+                delete con;
+                delete bnd;
+            }
+
+            CMaterial* mat;
+            CGeometry* geo;
+            CMesh* msh;
+            CConductance* con;
+            CBoundaryConditions* bnd;
+    };
+
+    TEST_F(CMatrixFreeTest, GlobalProduct) {
+        CMatrixFree A = CMatrixFree(*con, *msh, *bnd);
+        unsigned nDof = msh->getNDofTotal();
+        CMatrix T = CMatrix(nDof, 1, 0.0);
+        for (unsigned i = 0; i < nDof; i++) {
+            T(i, 0) = sin(double(i));
+        }
+        CMatrix KT = con->getConducMtx() * T;
+        CMatrix res = A.globalProduct(T);
+        for (unsigned i = 0; i < nDof; i++) {
+            EXPECT_NEAR(KT(i, 0), res(i, 0), 1e-10);
+        }
+    }
+
+    TEST_F(CMatrixFreeTest, ReducedProduct) {
+        CMatrixFree A = CMatrixFree(*con, *msh, *bnd);
+        CHeatConduction heat = CHeatConduction(*bnd, *con, *msh);
+        const CMatrixSparseSymmetric& Kff = heat.getKff();
+        unsigned n = A.getRows();
+        EXPECT_EQ(Kff.getRows(), n);
+        EXPECT_EQ(n, A.getCols());
+
+        /*--- y = 2*Kff*x + y with y initialized to ones. ---*/
+        CMatrix x = CMatrix(n, 1, 0.0);
+        CMatrix y = CMatrix(n, 1, 1.0);
+        for (unsigned i = 0; i < n; i++) {
+            x(i, 0) = cos(double(i));
+        }
+        A.multiply(x.getMtxAddress(), y.getMtxAddress(), 2.0, 1.0);
+        for (unsigned i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (unsigned j = 0; j < n; j++) {
+                sum += Kff(i, j) * x(j, 0);
+            }
+            EXPECT_NEAR(2.0 * sum + 1.0, y(i, 0), 1e-10);
+        }
+    }
+
+    TEST_F(CMatrixFreeTest, QuadraticElements) {
+        CMesh q9 = CMesh(6, 4, *geo, 9);
+        CConductance conQ9 = CConductance(*geo, *mat, q9);
+        CBoundaryConditions bndQ9 = CBoundaryConditions("bottom", -5000.0,
+                                                        "left", -20.0, q9,
+                                                        *geo);
+        CMatrixFree A = CMatrixFree(conQ9, q9, bndQ9);
+        unsigned nDof = q9.getNDofTotal();
+        CMatrix T = CMatrix(nDof, 1, 0.0);
+        for (unsigned i = 0; i < nDof; i++) {
+            T(i, 0) = sin(double(i));
+        }
+        CMatrix KT = conQ9.getConducMtx() * T;
+        CMatrix res = A.globalProduct(T);
+        for (unsigned i = 0; i < nDof; i++) {
+            EXPECT_NEAR(KT(i, 0), res(i, 0), 1e-10);
+        }
+    }
+}
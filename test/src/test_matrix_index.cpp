@@ -0,0 +1,46 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrixIndex.hpp"
+
+namespace {
+    class CMatrixIndexTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                idx = new CMatrixIndex(3, 4, 0);
+                for (unsigned i = 0; i < 3; i++) {
+                    for (unsigned j = 0; j < 4; j++) {
+                        (*idx)(i, j) = 4*i + j;
+                    }
+                }
+            }
+            virtual void TearDown() {
+                delete idx;
+            }
+
+            CMatrixIndex* idx;
+    };
+
+    TEST_F(CMatrixIndexTest, DefaultConstructor) {
+        CMatrixIndex mat;
+        EXPECT_EQ(0, mat.getRows());
+        EXPECT_EQ(0, mat.getCols());
+    }
+
+    TEST_F(CMatrixIndexTest, CustomConstructor) {
+        CMatrixIndex mat(2, 3, 7);
+        EXPECT_EQ(2, mat.getRows());
+        EXPECT_EQ(3, mat.getCols());
+        EXPECT_EQ(7, mat(1, 2));
+    }
+
+    TEST_F(CMatrixIndexTest, RowMajorStorage) {
+        const unsigned* row = idx->getRowAddress(1);
+        EXPECT_EQ(4, row[0]);
+        EXPECT_EQ(7, row[3]);
+        EXPECT_EQ(8, row[4]);
+        CMatrixIndex copy = (*idx);
+        copy(2, 3) = 0;
+        EXPECT_EQ(11, (*idx)(2, 3));
+    }
+}
@@ -1,3 +1,7 @@
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
 #include "gtest/gtest.h"
 #include "../../include/CMatrix.hpp"
 #include "../../include/CGeometry.hpp"
@@ -66,7 +70,7 @@ namespace {
     TEST_F(CMeshTest, TopologyMatrix) {
         CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
         CMesh msh = CMesh(2, 1, geo);
-        CMatrix topol = msh.getTopolMtx();
+        CMatrixIndex topol = msh.getTopolMtx();
         EXPECT_EQ(0, topol(0, 0));
         EXPECT_EQ(1, topol(1, 0));
         EXPECT_EQ(2, topol(0, 1));
@@ -78,7 +82,7 @@ namespace {
     TEST_F(CMeshTest, ConnectivityMatrix) {
         CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
         CMesh msh = CMesh(2, 1, geo);
-        CMatrix conn = msh.getConnMtx();
+        CMatrixIndex conn = msh.getConnMtx();
         EXPECT_EQ(0, conn(0, 0));
         EXPECT_EQ(0, conn(0, 1));
         EXPECT_EQ(2, conn(0, 2));
@@ -94,7 +98,7 @@ namespace {
     TEST_F(CMeshTest, GlobalDofMatrix) {
         CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
         CMesh msh = CMesh(2, 1, geo);
-        CMatrix glDof = msh.getGlDofMtx();
+        CMatrixIndex glDof = msh.getGlDofMtx();
         EXPECT_EQ(1, glDof(0, 0));
         EXPECT_EQ(1, glDof(1, 0));
         EXPECT_EQ(1, glDof(2, 0));
@@ -109,4 +113,62 @@ namespace {
         EXPECT_EQ(5, glDof(5, 1));
         EXPECT_EQ(6, msh.getNDofTotal());
     }
+
+    TEST_F(CMeshTest, ElementColors) {
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(5, 3, geo);
+        std::vector< std::vector<unsigned> > colors = msh.elementColors();
+        const CMatrixIndex& conn = msh.getConnMtx();
+        unsigned nColored = 0;
+        ASSERT_EQ(4, colors.size());
+        for (unsigned c = 0; c < colors.size(); c++) {
+            std::vector<bool> used(msh.getNNode(), false);
+            for (unsigned k = 0; k < colors[c].size(); k++) {
+                for (unsigned a = 1; a <= msh.getNNodePerElem(); a++) {
+                    unsigned node = conn(colors[c][k], a);
+                    EXPECT_FALSE(used[node]);
+                    used[node] = true;
+                }
+            }
+            nColored += colors[c].size();
+        }
+        EXPECT_EQ(msh.getNElem(), nColored);
+        EXPECT_EQ(6, colors[0].size());
+        EXPECT_EQ(3, colors[1].size());
+    }
+
+    TEST_F(CMeshTest, QuadraticElements) {
+        CGeometry geo = CGeometry(0.0, 1.0, 1.0, 2.0, 0.2);
+        CMesh q9 = CMesh(10, 5, geo, 9);
+        EXPECT_EQ(9, q9.getNNodePerElem());
+        EXPECT_EQ(2, q9.getElemOrder());
+        EXPECT_EQ(231, q9.getNNode());
+        EXPECT_EQ(231, q9.getNDofTotal());
+        const CMatrixIndex& conn = q9.getConnMtx();
+        const CMatrix& coor = q9.getCoorMtx();
+        EXPECT_EQ(0, conn(0, 1));
+        EXPECT_EQ(22, conn(0, 2));
+        EXPECT_EQ(24, conn(0, 3));
+        EXPECT_EQ(2, conn(0, 4));
+        EXPECT_EQ(11, conn(0, 5));
+        EXPECT_EQ(23, conn(0, 6));
+        EXPECT_EQ(13, conn(0, 7));
+        EXPECT_EQ(1, conn(0, 8));
+        EXPECT_EQ(12, conn(0, 9));
+        EXPECT_NEAR(0.1, coor(12, 0), 1e-15);
+        EXPECT_NEAR(-0.4, coor(12, 1), 1e-15);
+
+        /*--- The serendipity element has no node in the centre. ---*/
+        CMesh q8 = CMesh(10, 5, geo, 8);
+        EXPECT_EQ(181, q8.getNNode());
+        EXPECT_EQ(CMesh::noNode, q8.getTopolMtx()(1, 1));
+        EXPECT_EQ(19, q8.getConnMtx()(1, 2));
+        std::vector<unsigned> order = q8.nestedDissection();
+        std::sort(order.begin(), order.end());
+        for (unsigned i = 0; i < order.size(); i++) {
+            EXPECT_EQ(i, order[i]);
+        }
+        EXPECT_EQ(q8.getNNode(), order.size());
+        EXPECT_THROW(CMesh(2, 2, geo, 6), std::runtime_error);
+    }
 }
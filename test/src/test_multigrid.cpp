@@ -0,0 +1,165 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../../include/CHeatConduction.hpp"
+#include "../../include/CMultigrid.hpp"
+#include "../../include/CAlgebraicMultigrid.hpp"
+#include "../../include/CLinearSystem.hpp"
+
+namespace {
+    class CMultigridTest : public ::testing::Test {
+        protected:
+            /*--- Solve case 3 of the Makefile with the given mesh and return
+                  the number of iterations. ---*/
+            unsigned solveCase(unsigned nX, unsigned nY, std::string precond,
+                               std::string solver, std::string cycle) {
+                CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+                CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+                CMesh msh = CMesh(nX, nY, geo);
+                CConductance con = CConductance(geo, mat, msh);
+                CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                              "left", -20.0,
+                                                              msh, geo);
+                CHeatConduction ref = CHeatConduction(bnd, con, msh, "ic0");
+                CHeatConduction heat = CHeatConduction(bnd, con, msh, precond,
+                                                       solver, cycle);
+                CMatrix Tref = ref.getTemp();
+                CMatrix T = heat.getTemp();
+                for (unsigned i = 0; i < T.getRows(); i++) {
+                    EXPECT_NEAR(Tref(i, 0), T(i, 0), 1e-6);
+                }
+                return heat.getNIterations();
+            }
+    };
+
+    /*--- Algebraic multigrid without the dense factor of the coarsest
+          level, as if it was too large. ---*/
+    class CSmoothedCoarsest : public CAlgebraicMultigrid {
+        public:
+            CSmoothedCoarsest(const CMatrixSparseSymmetric& A)
+                : CAlgebraicMultigrid(A) {
+                maxDenseSize = 0;
+                factorizeCoarsest();
+            }
+    };
+
+    TEST_F(CMultigridTest, Levels) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.0, 1.0, 1.0, 2.0, 0.2);
+        CMesh msh = CMesh(16, 15, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("right", 2500.0,
+                                                      "left", 10.0, msh, geo);
+        CMultigrid mg = CMultigrid(con, msh, bnd);
+
+        /*--- 16x15, 16x8, 8x4, 4x2 and 2x2 elements, the first level only
+              coarsens the shorter elements. ---*/
+        EXPECT_EQ(5, mg.getNLevels());
+        EXPECT_THROW(CMultigrid(con, msh, bnd, "F"), std::runtime_error);
+    }
+
+    TEST_F(CMultigridTest, Solver) {
+        unsigned nCoarse = solveCase(8, 4, "none", "multigrid", "V");
+        unsigned nFine = solveCase(64, 32, "none", "multigrid", "V");
+        EXPECT_LE(nFine, nCoarse + 3);
+        EXPECT_LT(nFine, 30);
+        EXPECT_LE(solveCase(64, 32, "none", "multigrid", "W"), nFine);
+    }
+
+    TEST_F(CMultigridTest, AnisotropicSolver) {
+        /*--- High aspect meshes of case 3 and anisotropic conductivities,
+              compared with the banded Cholesky solver. ---*/
+        unsigned nX[] = {3, 101, 4, 3, 60};
+        unsigned nY[] = {101, 3, 64, 101, 40};
+        double kXX[] = {2500.0, 2500.0, 250.0, 250.0, 2.0};
+        double kXY[] = {30.0, 0.0, 0.0, 0.0, 0.0};
+        double kYY[] = {2.0, 2.0, 250.0, 250.0, 2500.0};
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        for (unsigned c = 0; c < 5; c++) {
+            CMaterial mat = CMaterial(kXX[c], kXY[c], kYY[c]);
+            CMesh msh = CMesh(nX[c], nY[c], geo);
+            CConductance con = CConductance(geo, mat, msh);
+            CBoundaryConditions bnd = CBoundaryConditions("top", -5000.0,
+                                                          "right", -20.0,
+                                                          msh, geo);
+            CHeatConduction ref = CHeatConduction(bnd, con, msh, "none",
+                                                  "direct");
+            CMatrix Tref = ref.getTemp();
+            for (unsigned v = 0; v < 2; v++) {
+                CHeatConduction heat = CHeatConduction(bnd, con, msh, "none",
+                                                       "multigrid",
+                                                       v == 0 ? "V" : "W");
+                CMatrix T = heat.getTemp();
+                EXPECT_LT(heat.getNIterations(), 100);
+                for (unsigned i = 0; i < T.getRows(); i++) {
+                    EXPECT_NEAR(Tref(i, 0), T(i, 0),
+                                1e-6 * (1.0 + std::fabs(Tref(i, 0))));
+                }
+            }
+        }
+    }
+
+    TEST_F(CMultigridTest, Preconditioner) {
+        unsigned nCoarse = solveCase(8, 4, "multigrid", "cg", "V");
+        unsigned nFine = solveCase(64, 32, "multigrid", "cg", "V");
+        EXPECT_LE(nFine, nCoarse + 3);
+        EXPECT_LT(nFine, 20);
+        solveCase(15, 9, "multigrid", "cg", "W");
+    }
+
+    TEST_F(CMultigridTest, AlgebraicPreconditioner) {
+        unsigned nCoarse = solveCase(16, 8, "amg", "cg", "V");
+        unsigned nFine = solveCase(64, 32, "amg", "cg", "V");
+        EXPECT_LE(nFine, nCoarse + 8);
+        EXPECT_LT(nFine, 30);
+    }
+
+    TEST_F(CMultigridTest, AlgebraicSetupReuse) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.0, 1.0, 1.0, 2.0, 0.2);
+        CMesh msh = CMesh(32, 16, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("right", 2500.0,
+                                                      "left", 10.0, msh, geo);
+        CHeatConduction heat = CHeatConduction(bnd, con, msh);
+        CMatrixSparseSymmetric Kff = heat.getKff();
+        CAlgebraicMultigrid amg = CAlgebraicMultigrid(Kff);
+        EXPECT_GT(amg.getNLevels(), 1);
+
+        /*--- The same hierarchy serves several load cases. ---*/
+        for (unsigned m = 1; m < 3; m++) {
+            CMatrix b = CMatrix(Kff.getRows(), 1, double(m));
+            CLinearSystem<CMatrixSparseSymmetric> sys =
+                CLinearSystem<CMatrixSparseSymmetric>(Kff, b);
+            sys.setPreconditioner(&amg);
+            CMatrix x = sys.iterativeSolve();
+            CMatrix y = amg.solve(b);
+            EXPECT_LT(sys.getNIterations(), 30);
+            for (unsigned i = 0; i < x.getRows(); i++) {
+                EXPECT_NEAR(x(i, 0), y(i, 0), 1e-8);
+            }
+        }
+    }
+
+    TEST_F(CMultigridTest, AlgebraicSmoothedCoarsest) {
+        CMaterial mat = CMaterial(250.0, 0.0, 250.0);
+        CGeometry geo = CGeometry(0.25, 1.0, 1.3, 3.0, 0.2);
+        CMesh msh = CMesh(32, 16, geo);
+        CConductance con = CConductance(geo, mat, msh);
+        CBoundaryConditions bnd = CBoundaryConditions("bottom", -5000.0,
+                                                      "left", -20.0, msh, geo);
+        CHeatConduction heat = CHeatConduction(bnd, con, msh, "ic0");
+        CMatrixSparseSymmetric Kff = heat.getKff();
+        CSmoothedCoarsest amg = CSmoothedCoarsest(Kff);
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(Kff, heat.getFf());
+        sys.setPreconditioner(&amg);
+        CMatrix x = sys.iterativeSolve();
+        EXPECT_LT(sys.getNIterations(), 40);
+        CMatrix r = heat.getFf() - Kff.toGeneralStorage() * x;
+        for (unsigned i = 0; i < x.getRows(); i++) {
+            EXPECT_NEAR(0.0, r(i, 0), 1e-6);
+        }
+    }
+}
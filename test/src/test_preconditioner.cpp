@@ -0,0 +1,74 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixSparse.hpp"
+#include "../../include/CMatrixSparseSymmetric.hpp"
+#include "../../include/CPreconditioner.hpp"
+
+namespace {
+    class CPreconditionerTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                CMatrixSparse K(size, size, rowPtr, colIdx, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    K.addEntry(i, i, 2.0);
+                    if (i > 0) K.addEntry(i, i - 1, -1.0);
+                    if (i < size - 1) K.addEntry(i, i + 1, -1.0);
+                }
+                A = new CMatrixSparseSymmetric(K.toSymmetricStorage());
+                r = new CMatrix(size, 1, 1.0);
+                z = new CMatrix(size, 1, 0.0);
+            }
+            virtual void TearDown() {
+                delete A;
+                delete r;
+                delete z;
+            }
+
+            /*--- Product A*z, to check that the preconditioner inverts A. ---*/
+            double product(unsigned i) {
+                double sum = 0.0;
+                for (unsigned j = 0; j < A->getCols(); j++) {
+                    sum += (*A)(i, j) * (*z)(j, 0);
+                }
+                return sum;
+            }
+
+            CMatrixSparseSymmetric* A;
+            CMatrix* r;
+            CMatrix* z;
+    };
+
+    TEST_F(CPreconditionerTest, Jacobi) {
+        CPreconditionerJacobi M(*A);
+        M.apply(r->getMtxAddress(), z->getMtxAddress());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            EXPECT_DOUBLE_EQ(0.5, (*z)(i, 0));
+        }
+    }
+
+    TEST_F(CPreconditionerTest, SSOR) {
+        CPreconditionerSSOR M(*A);
+        M.apply(r->getMtxAddress(), z->getMtxAddress());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            EXPECT_GT((*z)(i, 0), 0.0);
+        }
+        EXPECT_THROW(CPreconditionerSSOR(*A, 2.0), std::runtime_error);
+    }
+
+    TEST_F(CPreconditionerTest, IC0) {
+        CPreconditionerIC0 M(*A);
+        EXPECT_EQ(0.0, M.getShift());
+
+        /*--- The incomplete factor of a tridiagonal matrix is exact. ---*/
+        M.apply(r->getMtxAddress(), z->getMtxAddress());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            EXPECT_NEAR(1.0, product(i), 1e-12);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <stdexcept>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "../../include/CShapeFunctions.hpp"
+
+namespace {
+    class CShapeFunctionsTest : public ::testing::Test {};
+
+    TEST_F(CShapeFunctionsTest, SharedTables) {
+        const CShapeFunctions& shape = CShapeFunctions::getTable(2);
+        EXPECT_EQ(&shape, &CShapeFunctions::getTable(2));
+        EXPECT_EQ(2, shape.getGaussOrder());
+        EXPECT_EQ(4, shape.getNQuadPoints());
+        EXPECT_NEAR(-0.57735, shape.getGaussPoints()(0, 0), 0.0001);
+        EXPECT_NEAR(1.0, shape.getGaussWeights()(0, 1), 1e-15);
+        EXPECT_THROW(CShapeFunctions::getTable(0), std::runtime_error);
+        EXPECT_THROW(CShapeFunctions::getTable(CShapeFunctions::maxGaussOrder + 1),
+                     std::runtime_error);
+        EXPECT_NE(&shape, &CShapeFunctions::getTable(2, 8));
+        EXPECT_EQ(8, CShapeFunctions::getTable(2, 8).getNNodes());
+        EXPECT_EQ(3, CShapeFunctions::getTable(2, 8).getNLineNodes());
+        EXPECT_EQ(2, shape.getNLineNodes());
+        EXPECT_THROW(CShapeFunctions::getTable(2, 6), std::runtime_error);
+    }
+
+    TEST_F(CShapeFunctionsTest, GaussLegendre) {
+        /*--- Order n integrates exactly the polynomials of degree 2n-1. ---*/
+        for (unsigned n = 1; n <= CShapeFunctions::maxGaussOrder; n++) {
+            const CShapeFunctions& shape = CShapeFunctions::getTable(n);
+            double integral = 0.0;
+            for (unsigned i = 0; i < n; i++) {
+                double x = shape.getGaussPoints()(0, i);
+                integral += shape.getGaussWeights()(0, i) * pow(x, 2*n - 2);
+            }
+            EXPECT_NEAR(2.0 / (2*n - 1), integral, 1e-14);
+        }
+    }
+
+    TEST_F(CShapeFunctionsTest, Quadrilateral) {
+        for (unsigned n = 1; n <= CShapeFunctions::maxGaussOrder; n++) {
+            const CShapeFunctions& shape = CShapeFunctions::getTable(n);
+            double area = 0.0;
+            double moment = 0.0;
+            for (unsigned q = 0; q < shape.getNQuadPoints(); q++) {
+                const double* N = shape.getQuadN(q);
+                const double* dXi = shape.getQuadDXi(q);
+                const double* dEta = shape.getQuadDEta(q);
+                EXPECT_NEAR(1.0, N[0] + N[1] + N[2] + N[3], 1e-15);
+                EXPECT_NEAR(0.0, dXi[0] + dXi[1] + dXi[2] + dXi[3], 1e-15);
+                EXPECT_NEAR(0.0, dEta[0] + dEta[1] + dEta[2] + dEta[3], 1e-15);
+                area += shape.getQuadWeight(q);
+                moment += shape.getQuadWeight(q) * N[0];
+            }
+            EXPECT_NEAR(4.0, area, 1e-14);
+            EXPECT_NEAR(1.0, moment, 1e-14);
+        }
+    }
+
+    TEST_F(CShapeFunctionsTest, QuadraticQuadrilaterals) {
+        /*--- The shape functions reproduce xi*eta, which is in the space of
+              both elements. ---*/
+        const double xiNode[9] = {-1, 1, 1, -1, 0, 1, 0, -1, 0};
+        const double etaNode[9] = {-1, -1, 1, 1, -1, 0, 1, 0, 0};
+        unsigned nodes[2] = {8, 9};
+        for (unsigned m = 0; m < 2; m++) {
+            const CShapeFunctions& shape = CShapeFunctions::getTable(3, nodes[m]);
+            for (unsigned q = 0; q < shape.getNQuadPoints(); q++) {
+                double eta = shape.getGaussPoints()(0, q / 3);
+                double xi = shape.getGaussPoints()(0, q % 3);
+                const double* N = shape.getQuadN(q);
+                const double* dXi = shape.getQuadDXi(q);
+                const double* dEta = shape.getQuadDEta(q);
+                double sum = 0.0, prod = 0.0, dProdXi = 0.0, dProdEta = 0.0;
+                for (unsigned a = 0; a < nodes[m]; a++) {
+                    sum += N[a];
+                    prod += N[a] * xiNode[a] * etaNode[a];
+                    dProdXi += dXi[a] * xiNode[a] * etaNode[a];
+                    dProdEta += dEta[a] * xiNode[a] * etaNode[a];
+                }
+                EXPECT_NEAR(1.0, sum, 1e-14);
+                EXPECT_NEAR(xi * eta, prod, 1e-14);
+                EXPECT_NEAR(eta, dProdXi, 1e-14);
+                EXPECT_NEAR(xi, dProdEta, 1e-14);
+            }
+        }
+    }
+
+    TEST_F(CShapeFunctionsTest, Line) {
+        const CShapeFunctions& shape = CShapeFunctions::getTable(3);
+        double integral = 0.0;
+        for (unsigned q = 0; q < shape.getGaussOrder(); q++) {
+            const double* N = shape.getLineN(q);
+            EXPECT_NEAR(1.0, N[0] + N[1], 1e-15);
+            integral += shape.getGaussWeights()(0, q) * N[0] * N[0];
+        }
+        EXPECT_NEAR(2.0 / 3.0, integral, 1e-14);
+
+        /*--- The quadratic line has the middle node in the centre. ---*/
+        const CShapeFunctions& quad = CShapeFunctions::getTable(3, 9);
+        double length = 0.0;
+        for (unsigned q = 0; q < quad.getGaussOrder(); q++) {
+            const double* N = quad.getLineN(q);
+            const double* dN = quad.getLineDN(q);
+            EXPECT_NEAR(1.0, N[0] + N[1] + N[2], 1e-15);
+            EXPECT_NEAR(0.0, dN[0] + dN[1] + dN[2], 1e-15);
+            length += quad.getGaussWeights()(0, q) * N[1];
+        }
+        EXPECT_NEAR(4.0 / 3.0, length, 1e-14);
+    }
+}
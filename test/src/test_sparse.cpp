@@ -0,0 +1,125 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrix.hpp"
+#include "../../include/CMatrixSparse.hpp"
+
+namespace {
+    class CMatrixSparseTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                A = new CMatrixSparse(size, size, rowPtr, colIdx, 0.0);
+                B = new CMatrixSparse(size, size, rowPtr, colIdx, 1.0);
+                x = new CMatrix(size, 1, 1.0);
+                for (unsigned i = 0; i < size; i++) {
+                    A->addEntry(i, i, 2.0);
+                    if (i > 0) A->addEntry(i, i - 1, -1.0);
+                    if (i < size - 1) A->addEntry(i, i + 1, -1.0);
+                }
+            }
+            virtual void TearDown() {
+                delete A;
+                delete B;
+                delete x;
+            }
+
+            CMatrixSparse* A;
+            CMatrixSparse* B;
+            CMatrix* x;
+    };
+
+    TEST_F(CMatrixSparseTest, DefaultConstructor) {
+        CMatrixSparse mat;
+        EXPECT_EQ(0, mat.getRows());
+        EXPECT_EQ(0, mat.getCols());
+        EXPECT_EQ(0, mat.getNNonZero());
+    }
+
+    TEST_F(CMatrixSparseTest, CustomConstructor) {
+        EXPECT_EQ(4, B->getRows());
+        EXPECT_EQ(4, B->getCols());
+        EXPECT_EQ(10, B->getNNonZero());
+        EXPECT_EQ(1.0, (*B)(0, 0));
+        EXPECT_EQ(1.0, (*B)(2, 3));
+        EXPECT_EQ(0.0, (*B)(0, 3));
+    }
+
+    TEST_F(CMatrixSparseTest, CopyConstructor) {
+        CMatrixSparse mat = CMatrixSparse(*A);
+        EXPECT_EQ(A->getNNonZero(), mat.getNNonZero());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            for (unsigned j = 0; j < A->getCols(); j++) {
+                EXPECT_EQ((*A)(i, j), mat(i, j));
+            }
+        }
+    }
+
+    TEST_F(CMatrixSparseTest, AssignmentOperator) {
+        CMatrixSparse mat;
+        mat = (*A);
+        EXPECT_EQ(A->getRows(), mat.getRows());
+        EXPECT_EQ(A->getNNonZero(), mat.getNNonZero());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            for (unsigned j = 0; j < A->getCols(); j++) {
+                EXPECT_EQ((*A)(i, j), mat(i, j));
+            }
+        }
+    }
+
+    TEST_F(CMatrixSparseTest, FindAndAddEntry) {
+        EXPECT_EQ(0, A->findEntry(0, 0));
+        EXPECT_EQ(4, A->findEntry(1, 2));
+        EXPECT_EQ(-1, A->findEntry(0, 2));
+        EXPECT_EQ(2.0, (*A)(1, 1));
+        EXPECT_EQ(-1.0, (*A)(1, 2));
+        EXPECT_THROW(A->addEntry(0, 3, 1.0), std::runtime_error);
+    }
+
+    TEST_F(CMatrixSparseTest, AdditionOperator) {
+        (*A) += (*B);
+        EXPECT_EQ(3.0, (*A)(0, 0));
+        EXPECT_EQ(0.0, (*A)(1, 0));
+        EXPECT_EQ(0.0, (*A)(0, 3));
+    }
+
+    TEST_F(CMatrixSparseTest, ProductOperator) {
+        CMatrix y = (*A) * (*x);
+        EXPECT_EQ(4, y.getRows());
+        EXPECT_EQ(1, y.getCols());
+        EXPECT_EQ(1.0, y(0, 0));
+        EXPECT_EQ(0.0, y(1, 0));
+        EXPECT_EQ(0.0, y(2, 0));
+        EXPECT_EQ(1.0, y(3, 0));
+    }
+
+    TEST_F(CMatrixSparseTest, Transpose) {
+        unsigned rowPtr[3] = {0, 2, 3};
+        unsigned colIdx[3] = {0, 2, 1};
+        CMatrixSparse C(2, 3, rowPtr, colIdx, 0.0);
+        C.addEntry(0, 2, 5.0);
+        C.addEntry(1, 1, 3.0);
+        CMatrixSparse Ct = C.transpose();
+        EXPECT_EQ(3, Ct.getRows());
+        EXPECT_EQ(2, Ct.getCols());
+        EXPECT_EQ(3, Ct.getNNonZero());
+        EXPECT_EQ(5.0, Ct(2, 0));
+        EXPECT_EQ(3.0, Ct(1, 1));
+        EXPECT_EQ(0.0, Ct(0, 0));
+    }
+
+    TEST_F(CMatrixSparseTest, SparseProductOperator) {
+        CMatrixSparse C = (*A) * (*A);
+        EXPECT_EQ(4, C.getRows());
+        EXPECT_EQ(14, C.getNNonZero());
+        EXPECT_EQ(5.0, C(0, 0));
+        EXPECT_EQ(-4.0, C(0, 1));
+        EXPECT_EQ(1.0, C(0, 2));
+        EXPECT_EQ(6.0, C(1, 1));
+        EXPECT_EQ(-1, C.findEntry(0, 3));
+        EXPECT_THROW(C.transpose() * CMatrixSparse(), std::runtime_error);
+    }
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "../../include/CMatrixCompressedRow.hpp"
+#include "../../include/CMatrixSparse.hpp"
+#include "../../include/CMatrixSparseSymmetric.hpp"
+
+namespace {
+    class CMatrixSparseSymmetricTest : public ::testing::Test {
+        protected:
+            virtual void SetUp() {
+                unsigned size = 4;
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                A = new CMatrixSparse(size, size, rowPtr, colIdx, 0.0);
+                for (unsigned i = 0; i < size; i++) {
+                    A->addEntry(i, i, 2.0);
+                    if (i > 0) A->addEntry(i, i - 1, -1.0);
+                    if (i < size - 1) A->addEntry(i, i + 1, -1.0);
+                }
+            }
+            virtual void TearDown() {
+                delete A;
+            }
+
+            CMatrixSparse* A;
+    };
+
+    TEST_F(CMatrixSparseSymmetricTest, DefaultConstructor) {
+        CMatrixSparseSymmetric mat;
+        EXPECT_EQ(0, mat.getRows());
+        EXPECT_EQ(0, mat.getCols());
+        EXPECT_EQ(0, mat.getNNonZero());
+    }
+
+    TEST_F(CMatrixSparseSymmetricTest, ToSymmetricStorage) {
+        CMatrixSparseSymmetric mat = A->toSymmetricStorage();
+        EXPECT_EQ(4, mat.getRows());
+        EXPECT_EQ(4, mat.getCols());
+        EXPECT_EQ(7, mat.getNNonZero());
+        for (unsigned i = 0; i < A->getRows(); i++) {
+            for (unsigned j = 0; j < A->getCols(); j++) {
+                EXPECT_EQ((*A)(i, j), mat(i, j));
+            }
+        }
+    }
+
+    TEST_F(CMatrixSparseSymmetricTest, CopyAndAssignment) {
+        CMatrixSparseSymmetric mat = A->toSymmetricStorage();
+        CMatrixSparseSymmetric copy = CMatrixSparseSymmetric(mat);
+        CMatrixSparseSymmetric assigned;
+        assigned = mat;
+        for (unsigned i = 0; i < mat.getRows(); i++) {
+            for (unsigned j = 0; j < mat.getCols(); j++) {
+                EXPECT_EQ(mat(i, j), copy(i, j));
+                EXPECT_EQ(mat(i, j), assigned(i, j));
+            }
+        }
+    }
+
+    TEST_F(CMatrixSparseSymmetricTest, FindAndAddEntry) {
+        CMatrixSparseSymmetric mat = A->toSymmetricStorage();
+        EXPECT_EQ(mat.findEntry(2, 1), mat.findEntry(1, 2));
+        EXPECT_EQ(-1, mat.findEntry(0, 2));
+        mat.addEntry(0, 1, 3.0);
+        EXPECT_EQ(2.0, mat(1, 0));
+        EXPECT_EQ(2.0, mat(0, 1));
+        EXPECT_THROW(mat.addEntry(3, 0, 1.0), std::runtime_error);
+    }
+
+    TEST_F(CMatrixSparseSymmetricTest, CompressedRowStorage) {
+        /*--- The shared storage finds the entries of the upper triangle of the
+              symmetric matrix in the lower one, but not of the general one. ---*/
+        CMatrixSparseSymmetric mat = A->toSymmetricStorage();
+        const CMatrixCompressedRow& sym = mat;
+        const CMatrixCompressedRow& gen = *A;
+        EXPECT_EQ(mat.findEntry(2, 1), sym.findEntry(1, 2));
+        EXPECT_EQ(-1.0, sym(1, 2));
+        EXPECT_NE(gen.findEntry(2, 1), gen.findEntry(1, 2));
+        EXPECT_EQ(-1.0, gen(1, 2));
+    }
+
+    TEST_F(CMatrixSparseSymmetricTest, ToGeneralStorage) {
+        CMatrixSparse mat = A->toSymmetricStorage().toGeneralStorage();
+        EXPECT_EQ(A->getNNonZero(), mat.getNNonZero());
+        for (unsigned k = 0; k < A->getNNonZero(); k++) {
+            EXPECT_EQ(A->getColIdxAddress()[k], mat.getColIdxAddress()[k]);
+            EXPECT_EQ(A->getMtxAddress()[k], mat.getMtxAddress()[k]);
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <utility>
 
 #include "gtest/gtest.h"
 #include "../../include/CMatrixSymmetric.hpp"
@@ -77,6 +78,35 @@ namespace {
         }
     }
 
+    TEST_F(CMatrixSymmetricTest, MoveOperators) {
+        CMatrixSymmetric matOne(*C);
+        double* entries = matOne.getMtxAddress();
+        CMatrixSymmetric matTwo(std::move(matOne));
+        EXPECT_EQ(entries, matTwo.getMtxAddress());
+        EXPECT_EQ(0, matOne.getRows());
+        CMatrixSymmetric matThree;
+        matThree = std::move(matTwo);
+        EXPECT_EQ(entries, matThree.getMtxAddress());
+        EXPECT_EQ(3.0, matThree(0, 3));
+        matThree += (*B);
+        EXPECT_EQ(entries, matThree.getMtxAddress());
+        EXPECT_EQ(4.0, matThree(3, 0));
+    }
+
+    TEST_F(CMatrixSymmetricTest, PackedStorage) {
+        EXPECT_EQ(10, A->getNEntries());
+        EXPECT_EQ(4, E->getNEntries());
+        double* APtr = A->getMtxAddress();
+        for (unsigned k = 0; k < A->getNEntries(); k++) {
+            APtr[k] = k;
+        }
+        EXPECT_EQ(3.0, (*A)(3, 0));
+        EXPECT_EQ(4.0, (*A)(1, 1));
+        EXPECT_EQ(6.0, (*A)(3, 1));
+        EXPECT_EQ(9.0, (*A)(3, 3));
+        EXPECT_EQ((*A)(3, 1), (*A)(1, 3));
+    }
+
     TEST_F(CMatrixSymmetricTest, AccessOperator) {
         unsigned size = 4;
         CMatrixSymmetric mat = CMatrixSymmetric(size, size, 0.0);
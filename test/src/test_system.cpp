@@ -1,8 +1,13 @@
 #include <iostream>
+#include <stdexcept>
 
 #include "gtest/gtest.h"
 #include "../../include/CMatrix.hpp"
 #include "../../include/CMatrixSymmetric.hpp"
+#include "../../include/CMatrixSparse.hpp"
+#include "../../include/CMatrixSparseSymmetric.hpp"
+#include "../../include/CMatrixBanded.hpp"
+#include "../../include/CPreconditioner.hpp"
 #include "../../include/CLinearSystem.hpp"
 
 namespace {
@@ -13,6 +18,9 @@ namespace {
                 A = new CMatrix(size, size, 0.0);
                 ACg = new CMatrix(size, size, 0.0);
                 ACgSym = new CMatrixSymmetric(size, size, 0.0);
+                unsigned rowPtr[5] = {0, 2, 5, 8, 10};
+                unsigned colIdx[10] = {0, 1, 0, 1, 2, 1, 2, 3, 2, 3};
+                ACgSparse = new CMatrixSparse(size, size, rowPtr, colIdx, 0.0);
                 AUpper = new CMatrix(size, size, 0.0);
                 ALower = new CMatrix(size, size, 0.0);
                 b = new CMatrix(size, 1, 0.0);
@@ -72,6 +80,12 @@ namespace {
                 (*ACgSym)(3, 2) = 1.0;
                 (*ACgSym)(3, 3) = 2.0;
 
+                for(unsigned i = 0; i < size; i++) {
+                    ACgSparse->addEntry(i, i, 2.0);
+                    if (i > 0) ACgSparse->addEntry(i, i - 1, 1.0);
+                    if (i < size - 1) ACgSparse->addEntry(i, i + 1, 1.0);
+                }
+
                 (*b)(0, 0) = -3.;
                 (*b)(1, 0) = 5.0;
                 (*b)(2, 0) = 2.0;
@@ -103,6 +117,7 @@ namespace {
                 delete A;
                 delete ACg;
                 delete ACgSym;
+                delete ACgSparse;
                 delete AUpper;
                 delete ALower;
                 delete b;
@@ -116,6 +131,7 @@ namespace {
             CMatrix* A;
             CMatrix* ACg;
             CMatrixSymmetric* ACgSym;
+            CMatrixSparse* ACgSparse;
             CMatrix* AUpper;
             CMatrix* ALower;
             CMatrix* b;
@@ -173,6 +189,82 @@ namespace {
         }
     }
 
+    TEST_F(CLinearSystemTest, SymmetricDirectSolve) {
+        unsigned size = (*b).getRows();
+        CLinearSystem<CMatrixSymmetric> sys =
+            CLinearSystem<CMatrixSymmetric>(*ACgSym, *bUpLow);
+        CMatrix sol = sys.directSolve();
+        for(unsigned i = 0; i < size; i++) {
+            EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 1e-12);
+        }
+        CMatrixSymmetric ANeg = (*ACgSym);
+        ANeg(0, 0) = -2.0;
+        CLinearSystem<CMatrixSymmetric> sysNeg =
+            CLinearSystem<CMatrixSymmetric>(ANeg, *bUpLow);
+        EXPECT_THROW(sysNeg.directSolve(), std::runtime_error);
+    }
+
+    TEST_F(CLinearSystemTest, MultipleRhsDirectSolve) {
+        unsigned size = (*b).getRows();
+        CMatrix B = CMatrix(size, 3, 0.0);
+        for(unsigned i = 0; i < size; i++) {
+            B(i, 0) = (*bUpLow)(i, 0);
+            B(i, 1) = 2.0 * (*bUpLow)(i, 0);
+            B(i, 2) = (*b)(i, 0);
+        }
+        CMatrixBanded ABand = CMatrixBanded(size, 1, 0.0);
+        for(unsigned i = 0; i < size; i++) {
+            ABand(i, i) = 2.0;
+            if (i > 0) ABand(i, i - 1) = 1.0;
+        }
+        CMatrix sol[3] = {CLinearSystem<CMatrix>(*ACg, B).directSolve(),
+                          CLinearSystem<CMatrixSymmetric>(*ACgSym, B).directSolve(),
+                          CLinearSystem<CMatrixBanded>(ABand, B).directSolve()};
+        CMatrix x2 = CLinearSystem<CMatrix>(*ACg, *b).directSolve();
+        for (unsigned m = 0; m < 3; m++) {
+            EXPECT_EQ(3, sol[m].getCols());
+            for(unsigned i = 0; i < size; i++) {
+                EXPECT_NEAR((*xCg)(i, 0), sol[m](i, 0), 1e-12);
+                EXPECT_NEAR(2.0 * (*xCg)(i, 0), sol[m](i, 1), 1e-12);
+                EXPECT_NEAR(x2(i, 0), sol[m](i, 2), 1e-12);
+            }
+        }
+    }
+
+    TEST_F(CLinearSystemTest, MultipleRhsIterativeSolve) {
+        unsigned size = (*b).getRows();
+        CMatrix B = CMatrix(size, 2, 0.0);
+        for(unsigned i = 0; i < size; i++) {
+            B(i, 0) = (*bUpLow)(i, 0);
+            B(i, 1) = (*b)(i, 0);
+        }
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CPreconditionerJacobi jacobi(ASym);
+        CLinearSystem<CMatrixSparseSymmetric> single =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, *b);
+        single.setPreconditioner(&jacobi);
+        CMatrix x2 = single.iterativeSolve();
+
+        /*--- Symmetric sparse storage shares the sweep over the matrix, and
+              other storages multiply column by column. ---*/
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, B);
+        sys.setPreconditioner(&jacobi);
+        CLinearSystem<CMatrixSparse> sysCsr =
+            CLinearSystem<CMatrixSparse>(*ACgSparse, B);
+        CMatrix sol[2] = {sys.iterativeSolve(), sysCsr.iterativeSolve()};
+        for (unsigned m = 0; m < 2; m++) {
+            EXPECT_EQ(2, sol[m].getCols());
+            for(unsigned i = 0; i < size; i++) {
+                EXPECT_NEAR((*xCg)(i, 0), sol[m](i, 0), 0.0001);
+                EXPECT_NEAR(x2(i, 0), sol[m](i, 1), 0.0001);
+            }
+        }
+        EXPECT_EQ(single.getNIterations(), sys.getNIterations());
+        sys.setMethod("pipelined");
+        EXPECT_THROW(sys.iterativeSolve(), std::runtime_error);
+    }
+
     TEST_F(CLinearSystemTest, IterativeSolve) {
         unsigned size = (*b).getRows();
         CLinearSystem<CMatrix> sys = CLinearSystem<CMatrix>(*ACg, *bUpLow);
@@ -191,4 +283,121 @@ namespace {
             EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
         }
     }
+
+    TEST_F(CLinearSystemTest, IterativeSparseSolve) {
+        unsigned size = (*b).getRows();
+        CLinearSystem<CMatrixSparse> sys =
+            CLinearSystem<CMatrixSparse>(*ACgSparse, *bUpLow);
+        CMatrix sol = sys.iterativeSolve();
+        for(unsigned i = 0; i < size; i++) {
+            EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+        }
+    }
+
+    TEST_F(CLinearSystemTest, IterativeSparseSymmetricSolve) {
+        unsigned size = (*b).getRows();
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+        CMatrix sol = sys.iterativeSolve();
+        for(unsigned i = 0; i < size; i++) {
+            EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+        }
+    }
+
+    TEST_F(CLinearSystemTest, PreconditionedSolve) {
+        unsigned size = (*b).getRows();
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CPreconditionerJacobi jacobi(ASym);
+        CPreconditionerSSOR ssor(ASym);
+        CPreconditionerIC0 ic0(ASym);
+        const CPreconditioner* precond[3] = {&jacobi, &ssor, &ic0};
+        for (unsigned m = 0; m < 3; m++) {
+            CLinearSystem<CMatrixSparseSymmetric> sys =
+                CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+            sys.setPreconditioner(precond[m]);
+            CMatrix sol = sys.iterativeSolve();
+            for(unsigned i = 0; i < size; i++) {
+                EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+            }
+        }
+    }
+
+    TEST_F(CLinearSystemTest, PipelinedSolve) {
+        unsigned size = (*b).getRows();
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CPreconditionerJacobi jacobi(ASym);
+        const CPreconditioner* precond[2] = {nullptr, &jacobi};
+        for (unsigned m = 0; m < 2; m++) {
+            CLinearSystem<CMatrixSparseSymmetric> sys =
+                CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+            sys.setPreconditioner(precond[m]);
+            sys.setMethod("pipelined");
+            CMatrix sol = sys.iterativeSolve();
+            for(unsigned i = 0; i < size; i++) {
+                EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+            }
+            EXPECT_LE(sys.getNIterations(), size + 1);
+            EXPECT_GE(sys.getTimeReduction(), 0.0);
+        }
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+        sys.setMethod("gmres");
+        EXPECT_THROW(sys.iterativeSolve(), std::runtime_error);
+    }
+
+    TEST_F(CLinearSystemTest, SStepSolve) {
+        unsigned size = (*b).getRows();
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CPreconditionerJacobi jacobi(ASym);
+        const CPreconditioner* precond[2] = {nullptr, &jacobi};
+        const std::string basis[2] = {"monomial", "newton"};
+        for (unsigned m = 0; m < 4; m++) {
+            CLinearSystem<CMatrixSparseSymmetric> sys =
+                CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+            sys.setPreconditioner(precond[m % 2]);
+            sys.setMethod("s-step");
+            sys.setSStep(2, basis[m / 2]);
+            CMatrix sol = sys.iterativeSolve();
+            for(unsigned i = 0; i < size; i++) {
+                EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+            }
+            EXPECT_LE(sys.getNIterations(), size + 1);
+        }
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+        EXPECT_THROW(sys.setSStep(0, "newton"), std::runtime_error);
+        sys.setMethod("s-step");
+        sys.setSStep(2, "chebyshev");
+        EXPECT_THROW(sys.iterativeSolve(), std::runtime_error);
+    }
+
+    TEST_F(CLinearSystemTest, IncompleteCholeskyIterations) {
+        CMatrixSparseSymmetric ASym = ACgSparse->toSymmetricStorage();
+        CPreconditionerIC0 ic0(ASym);
+        CLinearSystem<CMatrixSparseSymmetric> sys =
+            CLinearSystem<CMatrixSparseSymmetric>(ASym, *bUpLow);
+        sys.setPreconditioner(&ic0);
+        sys.iterativeSolve();
+        EXPECT_EQ(1, sys.getNIterations());
+    }
+
+    TEST_F(CLinearSystemTest, BandedSolve) {
+        unsigned size = (*b).getRows();
+        CMatrixBanded ABand = CMatrixBanded(size, 1, 0.0);
+        for(unsigned i = 0; i < size; i++) {
+            ABand(i, i) = 2.0;
+            if (i > 0) ABand(i, i - 1) = 1.0;
+        }
+        CLinearSystem<CMatrixBanded> sys =
+            CLinearSystem<CMatrixBanded>(ABand, *bUpLow);
+        CMatrix sol = sys.directSolve();
+        for(unsigned i = 0; i < size; i++) {
+            EXPECT_NEAR((*xCg)(i, 0), sol(i, 0), 0.0001);
+        }
+        ABand(0, 0) = -2.0;
+        CLinearSystem<CMatrixBanded> bad =
+            CLinearSystem<CMatrixBanded>(ABand, *bUpLow);
+        EXPECT_THROW(bad.directSolve(), std::runtime_error);
+    }
 }